@@ -0,0 +1,328 @@
+// Microbenchmarks of the memory allocators, porting the scenarios of performance_tests.cpp to a
+//  harness with warmup, repetitions, batched cycle timing and latency percentiles, plus a churn of
+//  mixed size blocks that are freed and immediately allocated again, a ping pong of a block allocated
+//  and freed in turn and a pointer chasing traversal of allocated objects.
+//
+// Usage:
+//  allocator_benchmarks [--quick] [--format text|json|csv] [--filter name] [--cpu n]
+//                       [--warmup n] [--repetitions n] [--batch n] [--no-counters]
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmark_harness.h"
+#include "memory_region.h"
+#include "FirstFit/first_fit_memory_allocator.h"
+#include "NextFit/next_fit_memory_allocator.h"
+#include "PoolAllocation/bitmap_pool_allocator.h"
+#include "PoolAllocation/pool_allocation_memory_allocator.h"
+#include "BuddySystem/buddy_system_memory_allocator.h"
+#include "BuddySystem/out_of_band_buddy_allocator.h"
+#include "Slab/slab_memory_allocator.h"
+
+const std::size_t NODESIZE_BS = BuddySystemMemoryAllocator<0>::node_size;
+
+// Number of operations timed per repetition by scenarios whose cost depends on the 'n' blocks set up
+//  before them rather than on how many operations are run.
+const std::size_t OPS = 1000;
+
+// Run every scenario against an allocator of type 'Alloc' named 'name', allocating blocks of 'bytes'
+//  bytes, with 'n' blocks in the allocator's memory buffer. 'configure' is called with the allocator
+//  once it's constructed, if given.
+template <class Alloc>
+void benchmark_allocator(BenchmarkRunner& runner, const std::string& name, std::size_t bytes, std::size_t n, void (*configure)(Alloc&) = nullptr)
+{
+    const std::string N = " N=" + std::to_string(n);
+
+    std::vector<std::uint8_t> buffer((2*n + 2*OPS + 8) * 2 * (bytes + 64));
+    MemoryRegion region(buffer.data(), buffer.size());
+    Alloc alloc(region);
+    if (configure != nullptr)
+    {
+        configure(alloc);
+    }
+
+    std::vector<void*> allocs(2*n + 2);
+    std::vector<void*> blocks(std::max(n, OPS));
+
+    auto nothing = [](std::size_t, std::size_t) {};
+    auto reset = [&]() { alloc.reset(); };
+    auto allocate = [&](std::size_t i) { blocks[i] = alloc.allocate(bytes); };
+    auto allocate_8 = [&](std::size_t i) { blocks[i] = alloc.allocate(8); };
+    auto deallocate = [&](std::size_t i) { alloc.deallocate(blocks[i]); };
+    auto allocate_batch = [&](std::size_t first, std::size_t last) {
+        for (std::size_t i=first; i<last; i++)
+        {
+            blocks[i] = alloc.allocate(bytes);
+        }
+    };
+    auto deallocate_batch = [&](std::size_t first, std::size_t last) {
+        for (std::size_t i=first; i<last; i++)
+        {
+            if (blocks[i] != nullptr)
+            {
+                alloc.deallocate(blocks[i]);
+            }
+        }
+    };
+
+    // Leave 'n' free blocks of 'bytes' bytes, each between two allocated blocks, at the start of the
+    //  memory buffer. Setups free blocks from the end of the memory buffer back, so allocators keeping
+    //  their free lists sorted by address insert each one at the head rather than searching for it.
+    auto free_blocks = [&]() {
+        alloc.reset();
+        for (std::size_t i=0; i<n; i++)
+        {
+            alloc.allocate(bytes);
+            allocs[i] = alloc.allocate(bytes);
+        }
+        alloc.allocate(bytes);
+    };
+    auto free_small_blocks = [&]() {
+        free_blocks();
+        for (std::size_t i=n; i-->0;)
+        {
+            alloc.deallocate(allocs[i]);
+        }
+    };
+
+    // Allocate blocks of the first free blocks scenario, and then fill the rest of the memory buffer
+    //  before freeing them.
+    auto no_space = [&]() {
+        free_blocks();
+        while (alloc.allocate(bytes) != nullptr);
+        for (std::size_t i=n; i-->0;)
+        {
+            alloc.deallocate(allocs[i]);
+        }
+    };
+
+    // Allocate 'n' blocks in a row.
+    auto in_a_row = [&]() {
+        alloc.reset();
+        for (std::size_t i=0; i<n; i++)
+        {
+            allocs[i] = alloc.allocate(bytes);
+        }
+    };
+
+    // Allocate 2n+1 blocks in a row and free every other one, so each block left has a free block
+    //  either side of it.
+    auto between_free = [&]() {
+        alloc.reset();
+        for (std::size_t i=0; i<2*n+1; i++)
+        {
+            allocs[i] = alloc.allocate(bytes);
+        }
+        for (std::size_t i=2*n+1; i-->0;)
+        {
+            if (i % 2 == 0)
+            {
+                alloc.deallocate(allocs[i]);
+            }
+        }
+    };
+
+    // Sizes of the mixed size churn, from 1 to bytes+7 bytes.
+    auto mixed_bytes = [&](std::size_t i) { return 1 + (i * 5) % (bytes + 7); };
+
+    // Allocate 2n+1 blocks of mixed sizes in a row and free every other one, leaving free blocks of
+    //  different sizes between the allocated ones.
+    auto mixed_between_free = [&]() {
+        alloc.reset();
+        for (std::size_t i=0; i<2*n+1; i++)
+        {
+            allocs[i] = alloc.allocate(mixed_bytes(i));
+        }
+        for (std::size_t i=2*n+1; i-->0;)
+        {
+            if (i % 2 == 0 && allocs[i] != nullptr)
+            {
+                alloc.deallocate(allocs[i]);
+            }
+        }
+    };
+
+    // Free an allocated block and immediately allocate another of the same size.
+    auto churn = [&](std::size_t i) {
+        const std::size_t j = 2*((i * 7919) % n) + 1;
+        if (allocs[j] != nullptr)
+        {
+            alloc.deallocate(allocs[j]);
+        }
+        allocs[j] = alloc.allocate(mixed_bytes(j));
+    };
+
+    // Allocate a block and free it again straight away.
+    auto ping_pong = [&](std::size_t) { alloc.deallocate(alloc.allocate(bytes)); };
+
+    // Allocate 2n blocks, free every other one and then allocate n objects, each holding a pointer to
+    //  the one allocated before it and the first to the last. Following the pointers visits the objects
+    //  in the order the allocator placed them.
+    void* volatile chase = nullptr;
+    auto linked_objects = [&]() {
+        const std::size_t object_bytes = std::max(bytes, sizeof(void*));
+
+        alloc.reset();
+        for (std::size_t i=0; i<2*n; i++)
+        {
+            allocs[i] = alloc.allocate(object_bytes);
+        }
+        for (std::size_t i=2*n; i-->0;)
+        {
+            if (i % 2 == 0 && allocs[i] != nullptr)
+            {
+                alloc.deallocate(allocs[i]);
+            }
+        }
+
+        void* first = alloc.allocate(object_bytes);
+        void* last = first;
+        for (std::size_t i=1; i<n; i++)
+        {
+            void* object = alloc.allocate(object_bytes);
+            if (object == nullptr)
+            {
+                break;
+            }
+
+            *reinterpret_cast<void**>(object) = last;
+            last = object;
+        }
+        *reinterpret_cast<void**>(first) = last;
+
+        chase = last;
+    };
+    auto follow = [&](std::size_t) { chase = *reinterpret_cast<void* const*>(chase); };
+
+    if (runner.selected("Allocation/First_NTimes"))
+    {
+        runner.run("Allocation/First_NTimes" + N, name, n, reset, nothing, allocate, deallocate_batch);
+    }
+    if (runner.selected("Allocation/NTimes"))
+    {
+        runner.run("Allocation/NTimes" + N, name, OPS, in_a_row, nothing, allocate, nothing);
+    }
+    if (runner.selected("Allocation/NFreeBlocks"))
+    {
+        runner.run("Allocation/NFreeBlocks" + N, name, OPS, free_small_blocks, nothing, allocate_8, deallocate_batch);
+    }
+    if (runner.selected("Allocation/NoSpace_NFreeBlocks_TooSmall"))
+    {
+        runner.run("Allocation/NoSpace_NFreeBlocks_TooSmall" + N, name, OPS, no_space, nothing, allocate_8, deallocate_batch);
+    }
+    if (runner.selected("Deallocation/First_NTimes"))
+    {
+        runner.run("Deallocation/First_NTimes" + N, name, n, reset, allocate_batch, deallocate, nothing);
+    }
+    if (runner.selected("Deallocation/MergePrev_NTimes"))
+    {
+        runner.run("Deallocation/MergePrev_NTimes" + N, name, std::min(n, OPS), in_a_row, nothing, [&](std::size_t i) { alloc.deallocate(allocs[i]); }, nothing);
+    }
+    if (runner.selected("Deallocation/MergeNext_NTimes"))
+    {
+        runner.run("Deallocation/MergeNext_NTimes" + N, name, std::min(n, OPS), in_a_row, nothing, [&](std::size_t i) { alloc.deallocate(allocs[n-1-i]); }, nothing);
+    }
+    if (runner.selected("Deallocation/MergePrevNext_NTimes"))
+    {
+        runner.run("Deallocation/MergePrevNext_NTimes" + N, name, std::min(n, OPS), between_free, nothing, [&](std::size_t i) { alloc.deallocate(allocs[2*i+1]); }, nothing);
+    }
+    if (runner.selected("Churn/MixedSizes"))
+    {
+        runner.run("Churn/MixedSizes" + N, name, OPS, mixed_between_free, nothing, churn, nothing);
+    }
+    if (runner.selected("Churn/PingPong"))
+    {
+        runner.run("Churn/PingPong" + N, name, OPS, reset, nothing, ping_pong, nothing);
+    }
+    if (runner.selected("Traversal/PointerChase"))
+    {
+        runner.run("Traversal/PointerChase" + N, name, OPS, linked_objects, nothing, follow, nothing);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkConfig config;
+    std::vector<std::size_t> sizeN = {1000, 10000, 50000};
+
+    for (int a=1; a<argc; a++)
+    {
+        const std::string arg = argv[a];
+        const bool has_value = a + 1 < argc;
+
+        if (arg == "--quick")
+        {
+            config.warmup = 1;
+            config.repetitions = 3;
+            sizeN = {1000};
+        }
+        else if (arg == "--format" && has_value)
+        {
+            const std::string format = argv[++a];
+            config.format = (format == "json") ? BenchmarkFormat::json : (format == "csv") ? BenchmarkFormat::csv : BenchmarkFormat::text;
+        }
+        else if (arg == "--filter" && has_value)
+        {
+            config.filter = argv[++a];
+        }
+        else if (arg == "--no-counters")
+        {
+            config.counters = false;
+        }
+        else if (arg == "--cpu" && has_value)
+        {
+            config.cpu = std::atoi(argv[++a]);
+        }
+        else if (arg == "--warmup" && has_value)
+        {
+            config.warmup = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else if (arg == "--repetitions" && has_value)
+        {
+            config.repetitions = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else if (arg == "--batch" && has_value)
+        {
+            config.batch = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--quick] [--format text|json|csv] [--filter name] [--cpu n]\n";
+            std::cerr << "       [--warmup n] [--repetitions n] [--batch n] [--no-counters]\n";
+            return 1;
+        }
+    }
+
+    BenchmarkRunner runner(config);
+
+    for (std::size_t n : sizeN)
+    {
+        benchmark_allocator<FirstFitMemoryAllocator>(runner, "FirstFit", 1, n);
+        benchmark_allocator<QuickFirstFitMemoryAllocator<64>>(runner, "FirstFit (quick lists)", 1, n);
+        benchmark_allocator<WildernessFirstFitMemoryAllocator>(runner, "FirstFit (wilderness)", 1, n);
+        benchmark_allocator<NextFitMemoryAllocator>(runner, "NextFit", 1, n);
+        benchmark_allocator<WildernessNextFitMemoryAllocator>(runner, "NextFit (wilderness)", 1, n);
+        benchmark_allocator<PoolAllocationMemoryAllocator<8>>(runner, "PoolAllocation", 1, n);
+        benchmark_allocator<BitmapPoolAllocator<8>>(runner, "BitmapPool", 1, n);
+        benchmark_allocator<BuddySystemMemoryAllocator<8>>(runner, "BuddySystem", 1, n);
+        benchmark_allocator<BuddySystemMemoryAllocator<8>>(runner, "BuddySystem (large alloc)", 64+(7*NODESIZE_BS), n);
+        benchmark_allocator<BuddySystemMemoryAllocator<8>>(runner, "BuddySystem (watermarks)", 1, n, [](BuddySystemMemoryAllocator<8>& alloc) {
+            alloc.set_watermarks(0, 4, 16);
+            alloc.set_watermarks(1, 2, 8);
+            alloc.set_watermarks(2, 1, 4);
+        });
+        benchmark_allocator<OutOfBandBuddyAllocator<8>>(runner, "BuddySystem (out of band)", 1, n);
+        benchmark_allocator<OutOfBandBuddyAllocator<8>>(runner, "BuddySystem (out of band, large alloc)", 64, n);
+        benchmark_allocator<SlabMemoryAllocator<>>(runner, "Slab", 1, n);
+    }
+
+    runner.report(std::cout);
+
+    return 0;
+}
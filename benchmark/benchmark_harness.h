@@ -0,0 +1,555 @@
+#ifndef BENCHMARK_HARNESS_H
+#define BENCHMARK_HARNESS_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "perf_counters.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// Cycle accurate timer. On x86 it reads the time stamp counter, with rdtsc (fenced so earlier
+//  instructions finish first) to start and rdtscp (fenced so later instructions don't start early) to
+//  stop, and is calibrated against steady_clock to convert ticks to nanoseconds. Elsewhere it falls
+//  back on steady_clock, with 1 tick per nanosecond.
+class CycleTimer
+{
+public:
+
+    // Calibrate the timer, measuring it's tick rate over 'calibration_ms' milliseconds and the
+    //  overhead of reading it.
+    explicit CycleTimer(unsigned int calibration_ms = 20)
+    {
+        const auto clock_start = std::chrono::steady_clock::now();
+        const std::uint64_t ticks_start = start();
+
+        while (std::chrono::steady_clock::now() - clock_start < std::chrono::milliseconds(calibration_ms));
+
+        const std::uint64_t ticks_end = stop();
+        const auto clock_end = std::chrono::steady_clock::now();
+
+        const double ns = std::chrono::duration<double, std::nano>(clock_end - clock_start).count();
+        ticks_per_ns = static_cast<double>(ticks_end - ticks_start) / ns;
+
+        overhead_ticks = ~std::uint64_t{0};
+        for (int i=0; i<1000; i++)
+        {
+            const std::uint64_t t0 = start();
+            const std::uint64_t t1 = stop();
+            overhead_ticks = std::min(overhead_ticks, t1 - t0);
+        }
+    }
+
+    // Read the timer at the start of a timed region.
+    static std::uint64_t start()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_lfence();
+        const std::uint64_t ticks = __rdtsc();
+        _mm_lfence();
+        return ticks;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // Read the timer at the end of a timed region.
+    static std::uint64_t stop()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned int aux;
+        const std::uint64_t ticks = __rdtscp(&aux);
+        _mm_lfence();
+        return ticks;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // Returns the time in nanoseconds of a region measured as 'ticks', less the overhead of reading
+    //  the timer.
+    double nanoseconds(std::uint64_t ticks) const
+    {
+        return static_cast<double>((ticks > overhead_ticks) ? ticks - overhead_ticks : 0) / ticks_per_ns;
+    }
+
+    // Returns the number of ticks per nanosecond.
+    double rate() const
+    {
+        return ticks_per_ns;
+    }
+
+    // Returns the overhead of reading the timer in ticks.
+    std::uint64_t overhead() const
+    {
+        return overhead_ticks;
+    }
+
+private:
+
+    // Number of ticks per nanosecond.
+    double ticks_per_ns = 1;
+
+    // Smallest number of ticks measured between start and stop with nothing in between.
+    std::uint64_t overhead_ticks = 0;
+
+}; // class CycleTimer
+
+// Output format of benchmark results.
+enum class BenchmarkFormat
+{
+    text,
+    json,
+    csv
+};
+
+// Settings for a run of benchmarks.
+struct BenchmarkConfig
+{
+    // Number of repetitions run and discarded before measuring.
+    std::size_t warmup = 2;
+
+    // Number of measured repetitions.
+    std::size_t repetitions = 10;
+
+    // Number of operations timed together as one sample. Larger batches amortise the overhead of the
+    //  timer, smaller ones show more of the latency distribution.
+    std::size_t batch = 16;
+
+    // CPU to pin the benchmark thread to, or -1 to leave it unpinned.
+    int cpu = -1;
+
+    // Only scenarios whose name contains this are run.
+    std::string filter;
+
+    // Read hardware performance counters around every batch, where they are available.
+    bool counters = true;
+
+    BenchmarkFormat format = BenchmarkFormat::text;
+};
+
+// Results of one scenario against one allocator.
+struct BenchmarkResult
+{
+    // Number of log2 buckets in the latency histogram. Bucket i holds samples of 2^i to 2^(i+1)-1
+    //  nanoseconds per operation.
+    static constexpr std::size_t histogram_buckets = 32;
+
+    std::string scenario;
+    std::string allocator;
+
+    // Number of operations per repetition.
+    std::size_t ops = 0;
+
+    // Mean time per operation over the repetitions, and the half width of it's 95% confidence interval,
+    //  in nanoseconds.
+    double mean = 0;
+    double ci95 = 0;
+
+    // Percentiles of time per operation over every batch, in nanoseconds.
+    double p50 = 0;
+    double p99 = 0;
+    double p999 = 0;
+    double max = 0;
+
+    // Number of batches in each bucket of the latency histogram.
+    std::array<std::size_t, histogram_buckets> histogram{};
+
+    // Mean of each hardware performance counter per operation, over the measured repetitions, and
+    //  whether it was available.
+    std::array<double, PerfCounters::count> counters{};
+    std::array<bool, PerfCounters::count> counted{};
+};
+
+// Runs benchmark scenarios and reports their results. Each scenario is run against each allocator as
+//  a number of repetitions of 'ops' operations, with setup() preparing the allocator before each
+//  repetition. Operations are timed in batches, so the time of each operation is the time of it's
+//  batch divided by the batch size, and before_batch and after_batch are called around each batch
+//  with the range of operations in it, e.g. to allocate blocks that the batch deallocates. Only the
+//  operations themselves are timed. Hardware performance counters are enabled just outside the timed
+//  region of each measured batch, so they also count the two reads of the timer.
+class BenchmarkRunner
+{
+public:
+
+    // Constructor that pins the thread to a CPU if configured to and then calibrates the timer.
+    explicit BenchmarkRunner(const BenchmarkConfig& config) :
+        config(config),
+        pinned(pin(config.cpu))
+    {
+    }
+
+    // Returns true if scenario 'scenario' passes the filter.
+    bool selected(const std::string& scenario) const
+    {
+        return scenario.find(config.filter) != std::string::npos;
+    }
+
+    // Run 'ops' operations of 'scenario' against 'allocator' per repetition, calling op(i) for
+    //  operation i, and record the result.
+    template <class Setup, class BeforeBatch, class Op, class AfterBatch>
+    void run(const std::string& scenario, const std::string& allocator, std::size_t ops, Setup&& setup, BeforeBatch&& before_batch, Op&& op, AfterBatch&& after_batch)
+    {
+        BenchmarkResult result;
+        result.scenario = scenario;
+        result.allocator = allocator;
+        result.ops = ops;
+
+        const std::size_t batch = std::max<std::size_t>(1, std::min(config.batch, ops));
+
+        std::vector<double> means;
+        std::vector<double> samples;
+        samples.reserve(config.repetitions * ((ops + batch - 1) / batch));
+
+        const bool counting = config.counters && counters.any();
+        if (counting)
+        {
+            counters.clear();
+        }
+
+        for (std::size_t r=0; r<config.warmup+config.repetitions; r++)
+        {
+            const bool measured = r >= config.warmup;
+            double total = 0;
+
+            setup();
+            for (std::size_t i=0; i<ops; i+=batch)
+            {
+                const std::size_t end = std::min(i + batch, ops);
+
+                before_batch(i, end);
+
+                if (counting && measured)
+                {
+                    counters.start();
+                }
+
+                const std::uint64_t t0 = CycleTimer::start();
+                for (std::size_t j=i; j<end; j++)
+                {
+                    op(j);
+                }
+                const std::uint64_t t1 = CycleTimer::stop();
+
+                if (counting && measured)
+                {
+                    counters.stop();
+                }
+
+                after_batch(i, end);
+
+                const double ns = timer.nanoseconds(t1 - t0);
+                total += ns;
+                if (measured)
+                {
+                    samples.push_back(ns / (end - i));
+                }
+            }
+
+            if (measured && ops > 0)
+            {
+                means.push_back(total / ops);
+            }
+        }
+
+        summarise(result, means, samples);
+
+        if (counting && ops > 0 && config.repetitions > 0)
+        {
+            const std::array<double, PerfCounters::count> totals = counters.read();
+            for (std::size_t c=0; c<PerfCounters::count; c++)
+            {
+                result.counted[c] = counters.has(c);
+                result.counters[c] = totals[c] / (ops * config.repetitions);
+            }
+        }
+        results.push_back(result);
+    }
+
+    // Set 'mean' to the mean of 'values' and 'ci95' to the half width of it's 95% confidence interval,
+    //  or 0 if there are fewer than 2 values.
+    static void mean_ci95(const std::vector<double>& values, double& mean, double& ci95)
+    {
+        mean = 0;
+        ci95 = 0;
+        if (values.empty())
+        {
+            return;
+        }
+
+        for (double v : values)
+        {
+            mean += v;
+        }
+        mean /= values.size();
+
+        if (values.size() > 1)
+        {
+            double sq = 0;
+            for (double v : values)
+            {
+                sq += (v - mean) * (v - mean);
+            }
+            const double sd = std::sqrt(sq / (values.size() - 1));
+            ci95 = t95(values.size() - 1) * sd / std::sqrt(static_cast<double>(values.size()));
+        }
+    }
+
+    // Write every result recorded so far to 'out' in the configured format.
+    void report(std::ostream& out) const
+    {
+        switch (config.format)
+        {
+        case BenchmarkFormat::text:
+            report_text(out);
+            break;
+        case BenchmarkFormat::json:
+            report_json(out);
+            break;
+        case BenchmarkFormat::csv:
+            report_csv(out);
+            break;
+        }
+    }
+
+    // Returns every result recorded so far.
+    const std::vector<BenchmarkResult>& all_results() const
+    {
+        return results;
+    }
+
+private:
+
+    // Returns the two sided 95% critical value of Student's t distribution with 'df' degrees of
+    //  freedom.
+    static double t95(std::size_t df)
+    {
+        static const std::array<double, 30> table = {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+        };
+
+        return (df >= 1 && df <= table.size()) ? table[df - 1] : 1.960;
+    }
+
+    // Pin the calling thread to CPU 'cpu'. Returns false if 'cpu' is -1 or pinning is not supported.
+    static bool pin(int cpu)
+    {
+#ifdef __linux__
+        if (cpu >= 0)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            return sched_setaffinity(0, sizeof(set), &set) == 0;
+        }
+#endif
+        return false;
+    }
+
+    // Returns the value that fraction 'p' of 'sorted' is no greater than.
+    static double percentile(const std::vector<double>& sorted, double p)
+    {
+        if (sorted.empty())
+        {
+            return 0;
+        }
+
+        return sorted[std::min(static_cast<std::size_t>(p * sorted.size()), sorted.size() - 1)];
+    }
+
+    // Fill in the statistics of 'result' from the mean of each repetition and the time per operation
+    //  of each batch.
+    static void summarise(BenchmarkResult& result, const std::vector<double>& means, std::vector<double>& samples)
+    {
+        mean_ci95(means, result.mean, result.ci95);
+
+        std::sort(samples.begin(), samples.end());
+        result.p50 = percentile(samples, 0.5);
+        result.p99 = percentile(samples, 0.99);
+        result.p999 = percentile(samples, 0.999);
+        result.max = samples.empty() ? 0 : samples.back();
+
+        for (double s : samples)
+        {
+            const std::uint64_t ns = static_cast<std::uint64_t>(s);
+            const std::size_t bucket = (ns > 1) ? 63 - __builtin_clzll(ns) : 0;
+            result.histogram[std::min(bucket, BenchmarkResult::histogram_buckets - 1)]++;
+        }
+    }
+
+    // Write results as tab aligned text.
+    void report_text(std::ostream& out) const
+    {
+        out << "Timer: " << timer.rate() << " ticks/ns, overhead " << timer.overhead() << " ticks";
+        out << ", batch " << config.batch << ", " << config.repetitions << " repetitions";
+        out << (pinned ? ", pinned to CPU " + std::to_string(config.cpu) : std::string()) << "\n";
+        out << "Hardware counters:";
+        for (std::size_t c=0; c<PerfCounters::count; c++)
+        {
+            out << (counters.has(c) ? std::string(" ") + PerfCounters::name(c) : std::string());
+        }
+        out << ((config.counters && counters.any()) ? "\n" : " unavailable\n");
+        out << std::fixed << std::setprecision(1);
+
+        // Results are grouped by scenario, in the order each scenario was first run.
+        std::vector<std::string> scenarios;
+        for (const BenchmarkResult& result : results)
+        {
+            if (std::find(scenarios.begin(), scenarios.end(), result.scenario) == scenarios.end())
+            {
+                scenarios.push_back(result.scenario);
+            }
+        }
+
+        for (const std::string& scenario : scenarios)
+        {
+            out << scenario << "\n\t" << std::string(32, ' ') << "Mean (ns)\t+-95%\tp50\tp99\tp99.9\tmax\n";
+
+            for (const BenchmarkResult& result : results)
+            {
+                if (result.scenario != scenario)
+                {
+                    continue;
+                }
+
+                out << "\t" << std::left << std::setw(32) << result.allocator << std::right;
+                out << result.mean << "\t\t" << result.ci95 << "\t" << result.p50 << "\t" << result.p99 << "\t";
+                out << result.p999 << "\t" << result.max << "\n";
+            }
+
+            if (!config.counters || !counters.any())
+            {
+                continue;
+            }
+
+            out << "\t" << std::string(32, ' ') << "Per operation: cycles\tinstr\tIPC\tL1d\tLLC\tdTLB\tbranch misses\n";
+            for (const BenchmarkResult& result : results)
+            {
+                if (result.scenario != scenario)
+                {
+                    continue;
+                }
+
+                out << "\t" << std::left << std::setw(32) << result.allocator << std::right << std::string(15, ' ');
+                for (std::size_t c=0; c<PerfCounters::count; c++)
+                {
+                    if (c == PerfCounters::l1d_misses)
+                    {
+                        const bool ipc = result.counted[PerfCounters::cycles] && result.counted[PerfCounters::instructions] && result.counters[PerfCounters::cycles] > 0;
+                        if (ipc)
+                        {
+                            out << std::setprecision(2) << result.counters[PerfCounters::instructions] / result.counters[PerfCounters::cycles] << std::setprecision(1) << "\t";
+                        }
+                        else
+                        {
+                            out << "-\t";
+                        }
+                    }
+
+                    if (result.counted[c])
+                    {
+                        out << result.counters[c];
+                    }
+                    else
+                    {
+                        out << "-";
+                    }
+                    out << ((c + 1 < PerfCounters::count) ? "\t" : "\n");
+                }
+            }
+        }
+
+        out << std::defaultfloat;
+    }
+
+    // Write results as a JSON array with one object per result. Only available counters are written.
+    void report_json(std::ostream& out) const
+    {
+        out << "[\n";
+        for (std::size_t r=0; r<results.size(); r++)
+        {
+            const BenchmarkResult& result = results[r];
+
+            out << "  {\"scenario\": \"" << result.scenario << "\", \"allocator\": \"" << result.allocator << "\", ";
+            out << "\"ops\": " << result.ops << ", \"mean_ns\": " << result.mean << ", \"ci95_ns\": " << result.ci95 << ", ";
+            out << "\"p50_ns\": " << result.p50 << ", \"p99_ns\": " << result.p99 << ", \"p999_ns\": " << result.p999 << ", ";
+            out << "\"max_ns\": " << result.max << ", \"histogram\": [";
+            for (std::size_t b=0; b<BenchmarkResult::histogram_buckets; b++)
+            {
+                out << (b ? ", " : "") << result.histogram[b];
+            }
+            out << "], \"counters\": {";
+            bool first = true;
+            for (std::size_t c=0; c<PerfCounters::count; c++)
+            {
+                if (result.counted[c])
+                {
+                    out << (first ? "" : ", ") << "\"" << PerfCounters::name(c) << "\": " << result.counters[c];
+                    first = false;
+                }
+            }
+            out << "}}" << ((r + 1 < results.size()) ? "," : "") << "\n";
+        }
+        out << "]\n";
+    }
+
+    // Write results as CSV with a header row.
+    void report_csv(std::ostream& out) const
+    {
+        out << "scenario,allocator,ops,mean_ns,ci95_ns,p50_ns,p99_ns,p999_ns,max_ns";
+        for (std::size_t c=0; c<PerfCounters::count; c++)
+        {
+            out << "," << PerfCounters::name(c);
+        }
+        out << "\n";
+
+        // Unavailable counters are left empty.
+        for (const BenchmarkResult& result : results)
+        {
+            out << result.scenario << "," << result.allocator << "," << result.ops << "," << result.mean << ",";
+            out << result.ci95 << "," << result.p50 << "," << result.p99 << "," << result.p999 << "," << result.max;
+            for (std::size_t c=0; c<PerfCounters::count; c++)
+            {
+                out << ",";
+                if (result.counted[c])
+                {
+                    out << result.counters[c];
+                }
+            }
+            out << "\n";
+        }
+    }
+
+    const BenchmarkConfig config;
+
+    // True if the thread was pinned to a CPU.
+    bool pinned = false;
+
+    // Calibrated timer.
+    const CycleTimer timer;
+
+    // Hardware performance counters of the benchmark thread.
+    PerfCounters counters;
+
+    // Results recorded so far.
+    std::vector<BenchmarkResult> results;
+
+}; // class BenchmarkRunner
+
+#endif // BENCHMARK_HARNESS_H
@@ -0,0 +1,203 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters of the calling thread, read with Linux perf_event_open. The counters
+//  are opened as one group so they are enabled and disabled together, and only count while enabled,
+//  in user space. Any counter the CPU or kernel doesn't provide (or that the process isn't permitted
+//  to open) is left out and reported as unavailable, and on other platforms none are available.
+class PerfCounters
+{
+public:
+
+    // Counters read.
+    enum Counter
+    {
+        cycles,
+        instructions,
+        l1d_misses,
+        llc_misses,
+        dtlb_misses,
+        branch_misses,
+        count
+    };
+
+    // Returns the name of counter 'c'.
+    static const char* name(std::size_t c)
+    {
+        static const std::array<const char*, count> names = {"cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "branch_misses"};
+        return names[c];
+    }
+
+    // Constructor that opens every counter it can.
+    PerfCounters()
+    {
+        fds.fill(-1);
+        available.fill(false);
+
+#ifdef __linux__
+        const std::array<std::pair<std::uint32_t, std::uint64_t>, count> events = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D)},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL)},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+        }};
+
+        for (std::size_t c=0; c<count; c++)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = events[c].first;
+            attr.config = events[c].second;
+            attr.disabled = (leader == -1) ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fd == -1)
+            {
+                continue;
+            }
+
+            if (leader == -1)
+            {
+                leader = fd;
+            }
+            fds[c] = fd;
+            available[c] = true;
+            order[opened++] = c;
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Closes every counter.
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (int fd : fds)
+        {
+            if (fd != -1)
+            {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    // Returns true if any counter is available.
+    bool any() const
+    {
+        return opened > 0;
+    }
+
+    // Returns true if counter 'c' is available.
+    bool has(std::size_t c) const
+    {
+        return available[c];
+    }
+
+    // Start counting.
+    void start()
+    {
+#ifdef __linux__
+        if (leader != -1)
+        {
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    // Stop counting.
+    void stop()
+    {
+#ifdef __linux__
+        if (leader != -1)
+        {
+            ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    // Set every counter back to 0.
+    void clear()
+    {
+#ifdef __linux__
+        if (leader != -1)
+        {
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    // Returns the value of every counter, 0 for those unavailable. If the kernel had to multiplex the
+    //  counters they are scaled up to the whole time they were enabled.
+    std::array<double, count> read() const
+    {
+        std::array<double, count> values{};
+
+#ifdef __linux__
+        if (leader == -1)
+        {
+            return values;
+        }
+
+        // Group read format: number of counters, time enabled, time running, then each value.
+        std::array<std::uint64_t, 3 + count> data{};
+        if (::read(leader, data.data(), sizeof(data)) < static_cast<ssize_t>((3 + opened) * sizeof(std::uint64_t)))
+        {
+            return values;
+        }
+
+        const double scale = (data[2] > 0) ? static_cast<double>(data[1]) / data[2] : 0;
+        for (std::size_t i=0; i<opened; i++)
+        {
+            values[order[i]] = data[3 + i] * scale;
+        }
+#endif
+
+        return values;
+    }
+
+private:
+
+#ifdef __linux__
+    // Returns the config of a read miss event on cache 'cache'.
+    static std::uint64_t cache_event(std::uint64_t cache)
+    {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+#endif
+
+    // File descriptor of each counter, or -1 if unavailable, and of the group leader.
+    std::array<int, count> fds;
+    int leader = -1;
+
+    // True for each counter that is available.
+    std::array<bool, count> available;
+
+    // Counters in the order they were opened, which is the order the group is read in.
+    std::array<std::size_t, count> order{};
+    std::size_t opened = 0;
+
+}; // class PerfCounters
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,366 @@
+// Benchmarks of how the cost of the memory allocators scales with the size of their memory buffer
+//  and the number of blocks live in it. Each allocator is constructed on anonymous mmap'd buffers
+//  of 1MiB up to 16GiB, filled with a number of live blocks, reset, filled again and freed, and the
+//  cost of construction, allocation, deallocation and reset() is reported for each buffer size and
+//  live block count.
+//
+// Usage:
+//  scaling_benchmarks [--quick] [--format text|json|csv] [--filter name] [--max-size bytes]
+//                     [--max-blocks n]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "benchmark_harness.h"
+#include "Arena/monotonic_arena_allocator.h"
+#include "BuddySystem/buddy_system_memory_allocator.h"
+#include "FirstFit/first_fit_memory_allocator.h"
+#include "NextFit/next_fit_memory_allocator.h"
+#include "PoolAllocation/pool_allocation_memory_allocator.h"
+#include "Slab/slab_memory_allocator.h"
+#include "Stack/stack_memory_allocator.h"
+
+// Size of every block allocated.
+const std::size_t BLOCK_BYTES = 64;
+
+// Results of one allocator on one size of memory buffer with one number of live blocks.
+struct ScalingResult
+{
+    std::string allocator;
+    std::size_t buffer_bytes = 0;
+
+    // Number of live blocks allocated before reset() and deallocation. Smaller than asked for when
+    //  the memory buffer filled up first.
+    std::size_t blocks = 0;
+
+    // Time to construct the allocator, in nanoseconds, which includes faulting in any pages of the
+    //  memory buffer it writes to.
+    double construct = 0;
+
+    // Mean time per allocation and per deallocation, in nanoseconds. Allocations are timed on the first
+    //  fill of the memory buffer, so include faulting in the pages of each block.
+    double allocate = 0;
+    double deallocate = 0;
+
+    // Time to reset the allocator with 'blocks' blocks live, in nanoseconds.
+    double reset = 0;
+
+    // Why the memory buffer size was skipped, or empty if it wasn't.
+    std::string skipped;
+};
+
+// Returns the nanoseconds taken to run 'body()'.
+template <class Body>
+double time_ns(Body&& body)
+{
+    const auto start = std::chrono::steady_clock::now();
+    body();
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+// Returns 'bytes' as a number of KiB, MiB or GiB.
+std::string format_bytes(std::size_t bytes)
+{
+    const char* units[] = {"B", "KiB", "MiB", "GiB"};
+    std::size_t unit = 0;
+    while (unit < 3 && bytes >= 1024 && bytes % 1024 == 0)
+    {
+        bytes /= 1024;
+        unit++;
+    }
+
+    return std::to_string(bytes) + units[unit];
+}
+
+// Runs each allocator on memory buffers of increasing size, and collects the results.
+class ScalingBenchmarks
+{
+public:
+
+    // Constructor that takes in the configuration, the memory buffer sizes and the numbers of live
+    //  blocks to run with.
+    ScalingBenchmarks(const BenchmarkConfig& config, std::vector<std::size_t> sizes, std::vector<std::size_t> live_blocks) :
+        config(config),
+        sizes(std::move(sizes)),
+        live_blocks(std::move(live_blocks)),
+        physical_bytes(static_cast<std::size_t>(sysconf(_SC_PHYS_PAGES)) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)))
+    {
+    }
+
+    // Run an allocator of type 'Alloc' named 'name' on each size of memory buffer up to 'max_bytes'.
+    //  'touches_buffer' is true for allocators whose constructor and reset() write to the whole memory
+    //  buffer, which are skipped on buffers larger than half of physical memory.
+    template <class Alloc>
+    void benchmark_allocator(const std::string& name, bool touches_buffer, std::size_t max_bytes = SIZE_MAX)
+    {
+        if (name.find(config.filter) == std::string::npos)
+        {
+            return;
+        }
+
+        for (std::size_t bytes : sizes)
+        {
+            ScalingResult result;
+            result.allocator = name;
+            result.buffer_bytes = bytes;
+
+            if (bytes > max_bytes)
+            {
+                result.skipped = "larger than the allocator supports";
+                results.push_back(result);
+                continue;
+            }
+            if (touches_buffer && bytes > physical_bytes / 2)
+            {
+                result.skipped = "larger than half of physical memory";
+                results.push_back(result);
+                continue;
+            }
+
+            // Pages are only backed once written to, so the untouched part of a large buffer costs
+            //  nothing.
+            void* mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (mem == MAP_FAILED)
+            {
+                result.skipped = "mmap failed";
+                results.push_back(result);
+                continue;
+            }
+
+            benchmark_buffer<Alloc>(result, mem);
+
+            munmap(mem, bytes);
+        }
+    }
+
+    // Write every result to 'out' in the configured format.
+    void report(std::ostream& out) const
+    {
+        if (config.format == BenchmarkFormat::csv)
+        {
+            out << "allocator,buffer_bytes,blocks,construct_ns,allocate_ns,deallocate_ns,reset_ns,skipped\n";
+            for (const ScalingResult& r : results)
+            {
+                out << r.allocator << "," << r.buffer_bytes << "," << r.blocks << "," << r.construct << ",";
+                out << r.allocate << "," << r.deallocate << "," << r.reset << "," << r.skipped << "\n";
+            }
+            return;
+        }
+
+        if (config.format == BenchmarkFormat::json)
+        {
+            out << "[\n";
+            for (std::size_t i=0; i<results.size(); i++)
+            {
+                const ScalingResult& r = results[i];
+                out << "  {\"allocator\": \"" << r.allocator << "\", \"buffer_bytes\": " << r.buffer_bytes << ", ";
+                out << "\"blocks\": " << r.blocks << ", \"construct_ns\": " << r.construct << ", ";
+                out << "\"allocate_ns\": " << r.allocate << ", \"deallocate_ns\": " << r.deallocate << ", ";
+                out << "\"reset_ns\": " << r.reset << ", \"skipped\": \"" << r.skipped << "\"}";
+                out << ((i + 1 < results.size()) ? "," : "") << "\n";
+            }
+            out << "]\n";
+            return;
+        }
+
+        out << std::fixed << std::setprecision(2);
+
+        // Results are grouped by allocator, in the order each allocator was run.
+        std::vector<std::string> allocators;
+        for (const ScalingResult& r : results)
+        {
+            if (std::find(allocators.begin(), allocators.end(), r.allocator) == allocators.end())
+            {
+                allocators.push_back(r.allocator);
+            }
+        }
+
+        for (const std::string& name : allocators)
+        {
+            out << name << "\n\tBuffer\t\tBlocks\t\tConstruct (ms)\tAlloc (ns/op)\tFree (ns/op)\tReset (us)\n";
+            for (const ScalingResult& r : results)
+            {
+                if (r.allocator != name)
+                {
+                    continue;
+                }
+
+                out << "\t" << std::left << std::setw(8) << format_bytes(r.buffer_bytes) << "\t" << std::right;
+                if (!r.skipped.empty())
+                {
+                    out << "skipped: " << r.skipped << "\n";
+                    continue;
+                }
+
+                out << std::setw(8) << r.blocks << "\t" << std::setw(14) << r.construct / 1e6 << "\t";
+                out << std::setw(13) << r.allocate << "\t" << std::setw(12) << r.deallocate << "\t";
+                out << std::setw(10) << r.reset / 1e3 << "\n";
+            }
+        }
+
+        out << std::defaultfloat;
+    }
+
+private:
+
+    // Construct an allocator of type 'Alloc' on 'result.buffer_bytes' bytes at 'mem', and record a
+    //  result for each number of live blocks.
+    template <class Alloc>
+    void benchmark_buffer(const ScalingResult& base, void* mem)
+    {
+        // Constructed with new so that construction alone is timed.
+        Alloc* alloc = nullptr;
+        const double construct = time_ns([&]() { alloc = new Alloc(mem, base.buffer_bytes); });
+
+        std::vector<void*> blocks;
+        for (std::size_t target : live_blocks)
+        {
+            ScalingResult result = base;
+            result.construct = construct;
+
+            blocks.clear();
+            blocks.reserve(target);
+
+            const double allocate = time_ns([&]() {
+                for (std::size_t i=0; i<target; i++)
+                {
+                    void* block = alloc->allocate(BLOCK_BYTES);
+                    if (block == nullptr)
+                    {
+                        break;
+                    }
+                    blocks.push_back(block);
+                }
+            });
+            result.blocks = blocks.size();
+            result.allocate = allocate / std::max<std::size_t>(blocks.size(), 1);
+
+            result.reset = time_ns([&]() { alloc->reset(); });
+
+            // Fill the allocator again and free every block in the reverse order to which they were
+            //  allocated, so allocators keeping their free lists sorted by address insert each one at
+            //  the head rather than searching for it.
+            for (void*& block : blocks)
+            {
+                block = alloc->allocate(BLOCK_BYTES);
+            }
+            const double deallocate = time_ns([&]() {
+                for (std::size_t i=blocks.size(); i-->0;)
+                {
+                    alloc->deallocate(blocks[i]);
+                }
+            });
+            result.deallocate = deallocate / std::max<std::size_t>(blocks.size(), 1);
+
+            alloc->reset();
+            results.push_back(result);
+
+            // Larger numbers of live blocks won't fit either.
+            if (blocks.size() < target)
+            {
+                break;
+            }
+        }
+
+        delete alloc;
+    }
+
+    const BenchmarkConfig config;
+
+    // Memory buffer sizes, and numbers of live blocks, each allocator is run with.
+    const std::vector<std::size_t> sizes;
+    const std::vector<std::size_t> live_blocks;
+
+    // Bytes of physical memory in the machine.
+    const std::size_t physical_bytes;
+
+    // Results recorded so far.
+    std::vector<ScalingResult> results;
+
+}; // class ScalingBenchmarks
+
+int main(int argc, char** argv)
+{
+    BenchmarkConfig config;
+    std::size_t max_size = std::size_t(16) * 1024 * 1024 * 1024;
+    std::size_t max_blocks = std::size_t(1) << 22;
+
+    for (int a=1; a<argc; a++)
+    {
+        const std::string arg = argv[a];
+        const bool has_value = a + 1 < argc;
+
+        if (arg == "--quick")
+        {
+            max_size = 16 * 1024 * 1024;
+            max_blocks = 10000;
+        }
+        else if (arg == "--format" && has_value)
+        {
+            const std::string format = argv[++a];
+            config.format = (format == "json") ? BenchmarkFormat::json : (format == "csv") ? BenchmarkFormat::csv : BenchmarkFormat::text;
+        }
+        else if (arg == "--filter" && has_value)
+        {
+            config.filter = argv[++a];
+        }
+        else if (arg == "--max-size" && has_value)
+        {
+            max_size = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else if (arg == "--max-blocks" && has_value)
+        {
+            max_blocks = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--quick] [--format text|json|csv] [--filter name]\n";
+            std::cerr << "       [--max-size bytes] [--max-blocks n]\n";
+            return 1;
+        }
+    }
+
+    // Memory buffers of 1MiB up to 'max_size' bytes, growing by 4 times.
+    std::vector<std::size_t> sizes;
+    for (std::size_t bytes = 1024 * 1024; bytes <= max_size; bytes *= 4)
+    {
+        sizes.push_back(bytes);
+    }
+
+    // Live blocks from 1000 up to 'max_blocks', growing by 10 times.
+    std::vector<std::size_t> live_blocks;
+    for (std::size_t n = 1000; n < max_blocks; n *= 10)
+    {
+        live_blocks.push_back(n);
+    }
+    live_blocks.push_back(max_blocks);
+
+    ScalingBenchmarks benchmarks(config, sizes, live_blocks);
+
+    benchmarks.benchmark_allocator<FirstFitMemoryAllocator>("FirstFit", false);
+    benchmarks.benchmark_allocator<WildernessFirstFitMemoryAllocator>("FirstFit (wilderness)", false);
+    benchmarks.benchmark_allocator<NextFitMemoryAllocator>("NextFit", false);
+    benchmarks.benchmark_allocator<WildernessNextFitMemoryAllocator>("NextFit (wilderness)", false);
+    benchmarks.benchmark_allocator<PoolAllocationMemoryAllocator<BLOCK_BYTES>>("PoolAllocation", true);
+    benchmarks.benchmark_allocator<BuddySystemMemoryAllocator<BLOCK_BYTES>>("BuddySystem", false);
+    benchmarks.benchmark_allocator<SlabMemoryAllocator<>>("Slab", false);
+    benchmarks.benchmark_allocator<MonotonicArenaAllocator<>>("MonotonicArena", false);
+    benchmarks.benchmark_allocator<StackMemoryAllocator<>>("Stack", false, UINT32_MAX);
+
+    benchmarks.report(std::cout);
+
+    return 0;
+}
@@ -0,0 +1,430 @@
+// Fragmentation aging soak of the memory allocators. Each allocator is churned for tens of millions
+//  of operations while holding it's memory buffer at 70, 80, 90 and 95% occupancy, with request sizes
+//  drawn from a power law and block lifetimes from an exponential distribution. Throughput, failed
+//  allocations, the number of free blocks and the largest free block are sampled over time, showing
+//  how each allocator degrades as it ages. With --snapshots, the layout of the memory buffer of each
+//  allocator with a heap walk is also written to a file at each sample, for tools/heap_map to render.
+//
+// Usage:
+//  soak_benchmarks [--quick] [--format text|json|csv] [--filter name] [--ops n] [--samples n]
+//                  [--buffer bytes] [--seed n] [--snapshots path] [--snapshot-format csv|binary]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark_harness.h"
+#include "allocator_stats.h"
+#include "BuddySystem/buddy_system_memory_allocator.h"
+#include "FirstFit/first_fit_memory_allocator.h"
+#include "NextFit/next_fit_memory_allocator.h"
+#include "PoolAllocation/pool_allocation_memory_allocator.h"
+#include "Slab/slab_memory_allocator.h"
+#include "Trace/heap_snapshot.h"
+
+// Occupancies, as a fraction of the memory buffer, each allocator is held at.
+const std::vector<double> OCCUPANCIES = {0.70, 0.80, 0.90, 0.95};
+
+// Exponent of the power law request sizes are drawn from, so a request is 2^1.5 times less likely
+//  than one half it's size.
+const double SIZE_EXPONENT = 1.5;
+
+// Smallest request made.
+const std::size_t MIN_BYTES = 8;
+
+// Amount of churn, scaled down by --quick.
+struct SoakConfig
+{
+    // Operations (allocations and deallocations) run against each allocator at each occupancy.
+    std::size_t ops = 20000000;
+
+    // Number of times the allocator is sampled over those operations.
+    std::size_t samples = 20;
+
+    // Size of the memory buffer given to each allocator.
+    std::size_t buffer_bytes = 4 * 1024 * 1024;
+
+    // Seed of the request sizes and lifetimes.
+    std::uint64_t seed = 1;
+
+    // File heap snapshots are written to at each sample, or empty to write none.
+    std::string snapshots;
+    SnapshotFormat snapshot_format = SnapshotFormat::csv;
+};
+
+// State of an allocator sampled during a soak.
+struct SoakSample
+{
+    // Operations run so far.
+    std::size_t ops = 0;
+
+    // Operations per second since the previous sample.
+    double ops_per_sec = 0;
+
+    // allocated() as a fraction of length().
+    double occupancy = 0;
+
+    // Failed allocations so far.
+    std::size_t failures = 0;
+
+    // Number of free blocks, and size of the largest one, in bytes.
+    std::size_t free_blocks = 0;
+    std::size_t largest_free_block = 0;
+};
+
+// Results of one allocator held at one occupancy.
+struct SoakResult
+{
+    std::string allocator;
+    double occupancy = 0;
+
+    // Operations per second over the whole soak.
+    double ops_per_sec = 0;
+
+    std::vector<SoakSample> samples;
+};
+
+// Draws request sizes from a power law between MIN_BYTES and 'max_bytes', and lifetimes from an
+//  exponential distribution, measured in allocations.
+class SoakWorkload
+{
+public:
+
+    // Constructor that takes in the seed, the largest request, and the mean lifetime of a block.
+    SoakWorkload(std::uint64_t seed, std::size_t max_bytes, double mean_lifetime) :
+        rng(seed),
+        max_bytes(max_bytes),
+        lifetime(1.0 / mean_lifetime)
+    {
+    }
+
+    // Returns the size of the next request. Sizes are drawn by inverting the CDF of a power law
+    //  truncated to [MIN_BYTES, max_bytes].
+    std::size_t size()
+    {
+        const double low = std::pow(static_cast<double>(MIN_BYTES), -SIZE_EXPONENT + 1);
+        const double high = std::pow(static_cast<double>(max_bytes), -SIZE_EXPONENT + 1);
+        const double u = uniform(rng);
+
+        const double bytes = std::pow(low + u * (high - low), 1.0 / (-SIZE_EXPONENT + 1));
+        return std::min(max_bytes, std::max(MIN_BYTES, static_cast<std::size_t>(bytes)));
+    }
+
+    // Returns the lifetime of the next block.
+    double lifetime_of_block()
+    {
+        return lifetime(rng);
+    }
+
+    // Returns the mean request size, estimated from 'n' draws of a copy of the generator.
+    double mean_size(std::size_t n = 100000) const
+    {
+        SoakWorkload copy = *this;
+        double total = 0;
+        for (std::size_t i=0; i<n; i++)
+        {
+            total += copy.size();
+        }
+
+        return total / n;
+    }
+
+private:
+
+    std::mt19937_64 rng;
+    std::uniform_real_distribution<double> uniform{0.0, 1.0};
+
+    // Largest request made.
+    const std::size_t max_bytes;
+
+    std::exponential_distribution<double> lifetime;
+
+}; // class SoakWorkload
+
+// Runs the soak against each allocator, and collects the results.
+class SoakBenchmarks
+{
+public:
+
+    // Constructor that takes in the configuration and the amount of churn.
+    SoakBenchmarks(const BenchmarkConfig& config, const SoakConfig& soak) :
+        config(config),
+        soak(soak)
+    {
+        if (!soak.snapshots.empty())
+        {
+            snapshots.reset(new HeapSnapshotWriter(soak.snapshots, soak.snapshot_format));
+        }
+    }
+
+    // Soak an allocator of type 'Alloc' named 'name', with requests of up to 'max_bytes' bytes, at
+    //  each occupancy. 'Alloc' must record AllocatorStats, which the free block count is read from.
+    template <class Alloc>
+    void benchmark_allocator(const std::string& name, std::size_t max_bytes)
+    {
+        if (name.find(config.filter) == std::string::npos)
+        {
+            return;
+        }
+
+        std::unique_ptr<std::uint8_t[]> buffer(new std::uint8_t[soak.buffer_bytes]);
+        std::unique_ptr<Alloc> alloc(new Alloc(buffer.get(), soak.buffer_bytes));
+
+        for (double occupancy : OCCUPANCIES)
+        {
+            alloc->reset();
+            run_soak(name, *alloc, occupancy, max_bytes);
+        }
+    }
+
+    // Write every result to 'out' in the configured format.
+    void report(std::ostream& out) const
+    {
+        if (config.format == BenchmarkFormat::csv)
+        {
+            out << "allocator,target_occupancy,ops,ops_per_sec,occupancy,failures,free_blocks,largest_free_block\n";
+            for (const SoakResult& r : results)
+            {
+                for (const SoakSample& s : r.samples)
+                {
+                    out << r.allocator << "," << r.occupancy << "," << s.ops << "," << s.ops_per_sec << ",";
+                    out << s.occupancy << "," << s.failures << "," << s.free_blocks << "," << s.largest_free_block << "\n";
+                }
+            }
+            return;
+        }
+
+        if (config.format == BenchmarkFormat::json)
+        {
+            out << "[\n";
+            for (std::size_t i=0; i<results.size(); i++)
+            {
+                const SoakResult& r = results[i];
+                out << "  {\"allocator\": \"" << r.allocator << "\", \"target_occupancy\": " << r.occupancy << ", ";
+                out << "\"ops_per_sec\": " << r.ops_per_sec << ", \"samples\": [\n";
+                for (std::size_t j=0; j<r.samples.size(); j++)
+                {
+                    const SoakSample& s = r.samples[j];
+                    out << "    {\"ops\": " << s.ops << ", \"ops_per_sec\": " << s.ops_per_sec << ", ";
+                    out << "\"occupancy\": " << s.occupancy << ", \"failures\": " << s.failures << ", ";
+                    out << "\"free_blocks\": " << s.free_blocks << ", \"largest_free_block\": " << s.largest_free_block << "}";
+                    out << ((j + 1 < r.samples.size()) ? "," : "") << "\n";
+                }
+                out << "  ]}" << ((i + 1 < results.size()) ? "," : "") << "\n";
+            }
+            out << "]\n";
+            return;
+        }
+
+        out << std::fixed << std::setprecision(2);
+
+        for (const SoakResult& r : results)
+        {
+            out << r.allocator << " at " << r.occupancy * 100 << "% occupancy: " << r.ops_per_sec / 1e6 << " Mops/s\n";
+            out << "\tOps\t\tMops/s\tOccupancy\tFailures\tFree blocks\tLargest free block\n";
+            for (const SoakSample& s : r.samples)
+            {
+                out << "\t" << std::left << std::setw(12) << s.ops << std::right << "\t" << s.ops_per_sec / 1e6 << "\t";
+                out << s.occupancy * 100 << "%\t\t" << s.failures << "\t\t" << s.free_blocks << "\t\t" << s.largest_free_block << "\n";
+            }
+        }
+
+        out << std::defaultfloat;
+    }
+
+private:
+
+    // Block live in the allocator, and the time it's freed at.
+    struct LiveBlock
+    {
+        double expires;
+        void* addr;
+
+        bool operator>(const LiveBlock& other) const
+        {
+            return expires > other.expires;
+        }
+    };
+
+    // Churn 'alloc' for 'soak.ops' operations while holding it at 'occupancy', sampling it as it goes.
+    //  Each operation frees the block that expires first if it's lifetime is up or the allocator is
+    //  at it's target occupancy, and otherwise allocates a new block. A failed allocation also frees
+    //  the block that expires first, so the soak keeps going.
+    template <class Alloc>
+    void run_soak(const std::string& name, Alloc& alloc, double occupancy, std::size_t max_bytes)
+    {
+        SoakResult result;
+        result.allocator = name;
+        result.occupancy = occupancy;
+
+        // Blocks live for as many allocations, on average, as it takes to fill the memory buffer to
+        //  the target occupancy, so most blocks are freed to hold the occupancy rather than by
+        //  expiring.
+        const double mean_lifetime = occupancy * alloc.length() / SoakWorkload(soak.seed, max_bytes, 1.0).mean_size();
+        SoakWorkload workload(soak.seed, max_bytes, mean_lifetime);
+
+        const std::size_t target = static_cast<std::size_t>(occupancy * alloc.length());
+        const std::size_t interval = std::max<std::size_t>(soak.ops / std::max<std::size_t>(soak.samples, 1), 1);
+
+        std::priority_queue<LiveBlock, std::vector<LiveBlock>, std::greater<LiveBlock>> live;
+        double now = 0;
+        std::size_t failures = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        auto last = start;
+
+        for (std::size_t op=1; op<=soak.ops; op++)
+        {
+            if (!live.empty() && (live.top().expires <= now || alloc.allocated() >= target))
+            {
+                alloc.deallocate(live.top().addr);
+                live.pop();
+            }
+            else
+            {
+                void* addr = alloc.allocate(workload.size());
+                now += 1;
+
+                if (addr != nullptr)
+                {
+                    live.push({now + workload.lifetime_of_block(), addr});
+                }
+                else
+                {
+                    failures++;
+                    if (!live.empty())
+                    {
+                        alloc.deallocate(live.top().addr);
+                        live.pop();
+                    }
+                }
+            }
+
+            if (op % interval == 0)
+            {
+                const auto time = std::chrono::steady_clock::now();
+
+                SoakSample sample;
+                sample.ops = op;
+                sample.ops_per_sec = interval / std::chrono::duration<double>(time - last).count();
+                sample.occupancy = static_cast<double>(alloc.allocated()) / alloc.length();
+                sample.failures = failures;
+                sample.free_blocks = alloc.stats().free_blocks();
+                sample.largest_free_block = alloc.largest_free_block();
+                result.samples.push_back(sample);
+
+                if constexpr (has_heap_walk<Alloc>::value)
+                {
+                    if (snapshots)
+                    {
+                        snapshots->write(alloc, name + " " + std::to_string(static_cast<int>(occupancy * 100 + 0.5)) + "% " + std::to_string(op));
+                    }
+                }
+
+                // Time spent sampling isn't counted.
+                last = std::chrono::steady_clock::now();
+            }
+        }
+
+        const auto end = std::chrono::steady_clock::now();
+        result.ops_per_sec = soak.ops / std::chrono::duration<double>(end - start).count();
+
+        while (!live.empty())
+        {
+            alloc.deallocate(live.top().addr);
+            live.pop();
+        }
+
+        results.push_back(result);
+    }
+
+    const BenchmarkConfig config;
+    const SoakConfig soak;
+
+    // Writer of heap snapshots, if they were asked for.
+    std::unique_ptr<HeapSnapshotWriter> snapshots;
+
+    // Results recorded so far.
+    std::vector<SoakResult> results;
+
+}; // class SoakBenchmarks
+
+int main(int argc, char** argv)
+{
+    BenchmarkConfig config;
+    SoakConfig soak;
+
+    for (int a=1; a<argc; a++)
+    {
+        const std::string arg = argv[a];
+        const bool has_value = a + 1 < argc;
+
+        if (arg == "--quick")
+        {
+            soak.ops = 50000;
+            soak.samples = 4;
+            soak.buffer_bytes = 256 * 1024;
+        }
+        else if (arg == "--format" && has_value)
+        {
+            const std::string format = argv[++a];
+            config.format = (format == "json") ? BenchmarkFormat::json : (format == "csv") ? BenchmarkFormat::csv : BenchmarkFormat::text;
+        }
+        else if (arg == "--filter" && has_value)
+        {
+            config.filter = argv[++a];
+        }
+        else if (arg == "--ops" && has_value)
+        {
+            soak.ops = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else if (arg == "--samples" && has_value)
+        {
+            soak.samples = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else if (arg == "--buffer" && has_value)
+        {
+            soak.buffer_bytes = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else if (arg == "--seed" && has_value)
+        {
+            soak.seed = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else if (arg == "--snapshots" && has_value)
+        {
+            soak.snapshots = argv[++a];
+        }
+        else if (arg == "--snapshot-format" && has_value)
+        {
+            soak.snapshot_format = (std::string(argv[++a]) == "binary") ? SnapshotFormat::binary : SnapshotFormat::csv;
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--quick] [--format text|json|csv] [--filter name] [--ops n]\n";
+            std::cerr << "       [--samples n] [--buffer bytes] [--seed n] [--snapshots path] [--snapshot-format csv|binary]\n";
+            return 1;
+        }
+    }
+
+    SoakBenchmarks benchmarks(config, soak);
+
+    benchmarks.benchmark_allocator<BasicFirstFitMemoryAllocator<AllocatorStats>>("FirstFit", 4096);
+    benchmarks.benchmark_allocator<BasicNextFitMemoryAllocator<AllocatorStats>>("NextFit", 4096);
+    benchmarks.benchmark_allocator<PoolAllocationMemoryAllocator<256, AllocatorStats>>("PoolAllocation", 256);
+    benchmarks.benchmark_allocator<BuddySystemMemoryAllocator<64, AllocatorStats>>("BuddySystem", BuddySystemMemoryAllocator<64>::block_lengths()[3]);
+    benchmarks.benchmark_allocator<SlabMemoryAllocator<16384, AllocatorStats>>("Slab", 4096);
+
+    benchmarks.report(std::cout);
+
+    return 0;
+}
@@ -0,0 +1,577 @@
+// Multi-threaded benchmarks of the memory allocators, porting the classic workloads Larson,
+//  xmalloc-test, cache-scratch, cache-thrash and threadtest. Each allocator runs behind a
+//  LockedAllocator, alongside ConcurrentArenaAllocator as a lock free front end, and reports
+//  operations per second and growth in resident memory for each number of threads.
+//
+// Usage:
+//  threaded_benchmarks [--quick] [--format text|json|csv] [--filter name] [--threads max]
+//                      [--warmup n] [--repetitions n]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "benchmark_harness.h"
+#include "memory_region.h"
+#include "Arena/concurrent_arena_allocator.h"
+#include "BuddySystem/buddy_system_memory_allocator.h"
+#include "Composition/locked_allocator.h"
+#include "FirstFit/first_fit_memory_allocator.h"
+#include "NextFit/next_fit_memory_allocator.h"
+#include "PoolAllocation/pool_allocation_memory_allocator.h"
+#include "Slab/slab_memory_allocator.h"
+
+// Size of the memory buffer given to each allocator.
+const std::size_t BUFFER_BYTES = 256 * 1024 * 1024;
+
+// Smallest and largest blocks allocated by Larson and xmalloc-test.
+const std::size_t MIN_BYTES = 8;
+const std::size_t MAX_BYTES = 256;
+
+// Amount of work per thread, scaled down by --quick.
+struct Workload
+{
+    // Larson: live blocks per thread, rounds of new threads, and operations per thread per round.
+    std::size_t larson_slots = 1000;
+    std::size_t larson_rounds = 4;
+    std::size_t larson_ops = 5000;
+
+    // xmalloc-test: batches produced per producer, and blocks per batch.
+    std::size_t xmalloc_batches = 100;
+    std::size_t xmalloc_batch = 256;
+
+    // cache-scratch and cache-thrash: allocations per thread, and writes to each.
+    std::size_t cache_iterations = 20000;
+    std::size_t cache_writes = 50;
+
+    // threadtest: rounds per thread, and blocks allocated then freed each round.
+    std::size_t threadtest_rounds = 50;
+    std::size_t threadtest_blocks = 1000;
+};
+
+// Results of one workload against one allocator with one number of threads.
+struct ThreadedResult
+{
+    std::string workload;
+    std::string allocator;
+    std::size_t threads = 0;
+
+    // Mean operations per second over the repetitions, and the half width of it's 95% confidence
+    //  interval.
+    double ops_per_sec = 0;
+    double ci95 = 0;
+
+    // Growth in resident memory since the allocator was constructed, in bytes.
+    std::size_t rss = 0;
+
+    // Number of allocations that failed in the last repetition.
+    std::size_t failures = 0;
+};
+
+// Returns resident memory of the process in bytes, or 0 if it can't be read.
+std::size_t resident_bytes()
+{
+    std::ifstream statm("/proc/self/statm");
+    std::size_t pages = 0;
+    std::size_t resident = 0;
+    if (!(statm >> pages >> resident))
+    {
+        return 0;
+    }
+
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Run 'body(t)' on 'threads' threads at once and wait for them all.
+template <class Body>
+void run_threads(std::size_t threads, Body&& body)
+{
+    std::vector<std::thread> workers;
+    for (std::size_t t=0; t<threads; t++)
+    {
+        workers.emplace_back([&body, t]() { body(t); });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+// Larson: simulates a server where each thread repeatedly frees a random block from it's set and
+//  allocates another of random size. At the end of each round the threads exit and new ones take over
+//  their sets shifted by one, so most blocks are freed by a different thread to the one that allocated
+//  them. Returns the number of operations.
+template <class Alloc>
+std::size_t larson(Alloc& alloc, std::size_t threads, const Workload& w, std::atomic<std::size_t>& failures)
+{
+    std::vector<std::vector<void*>> slots(threads, std::vector<void*>(w.larson_slots));
+    std::minstd_rand rng(1);
+    for (auto& set : slots)
+    {
+        for (void*& slot : set)
+        {
+            slot = alloc.allocate(MIN_BYTES + rng() % (MAX_BYTES - MIN_BYTES + 1));
+        }
+    }
+
+    for (std::size_t round=0; round<w.larson_rounds; round++)
+    {
+        run_threads(threads, [&](std::size_t t) {
+            std::vector<void*>& set = slots[(t + round) % threads];
+            std::minstd_rand thread_rng(static_cast<unsigned int>(1 + t + (round * threads)));
+            std::size_t failed = 0;
+
+            for (std::size_t i=0; i<w.larson_ops; i++)
+            {
+                void*& slot = set[thread_rng() % set.size()];
+                if (slot != nullptr)
+                {
+                    alloc.deallocate(slot);
+                }
+
+                slot = alloc.allocate(MIN_BYTES + thread_rng() % (MAX_BYTES - MIN_BYTES + 1));
+                failed += (slot == nullptr);
+            }
+
+            failures += failed;
+        });
+    }
+
+    for (auto& set : slots)
+    {
+        for (void* slot : set)
+        {
+            if (slot != nullptr)
+            {
+                alloc.deallocate(slot);
+            }
+        }
+    }
+
+    return threads * w.larson_rounds * w.larson_ops * 2;
+}
+
+// xmalloc-test: half the threads allocate batches of blocks and hand them to the other half through a
+//  shared queue, which frees them. With 1 thread it produces and consumes in turn. Returns the number
+//  of operations.
+template <class Alloc>
+std::size_t xmalloc(Alloc& alloc, std::size_t threads, const Workload& w, std::atomic<std::size_t>& failures)
+{
+    const std::size_t producers = std::max<std::size_t>(1, threads / 2);
+    const std::size_t consumers = threads - producers;
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::vector<std::vector<void*>> queue;
+    std::size_t producing = producers;
+
+    auto produce = [&](std::size_t t) {
+        std::minstd_rand rng(static_cast<unsigned int>(1 + t));
+        std::size_t failed = 0;
+
+        for (std::size_t b=0; b<w.xmalloc_batches; b++)
+        {
+            std::vector<void*> batch(w.xmalloc_batch);
+            for (void*& block : batch)
+            {
+                block = alloc.allocate(MIN_BYTES + rng() % (MAX_BYTES - MIN_BYTES + 1));
+                failed += (block == nullptr);
+            }
+
+            if (consumers == 0)
+            {
+                for (void* block : batch)
+                {
+                    if (block != nullptr)
+                    {
+                        alloc.deallocate(block);
+                    }
+                }
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(std::move(batch));
+            ready.notify_one();
+        }
+
+        failures += failed;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        producing--;
+        ready.notify_all();
+    };
+
+    auto consume = [&]() {
+        while (true)
+        {
+            std::vector<void*> batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [&]() { return !queue.empty() || producing == 0; });
+                if (queue.empty())
+                {
+                    return;
+                }
+                batch = std::move(queue.back());
+                queue.pop_back();
+            }
+
+            for (void* block : batch)
+            {
+                if (block != nullptr)
+                {
+                    alloc.deallocate(block);
+                }
+            }
+        }
+    };
+
+    run_threads(producers + consumers, [&](std::size_t t) {
+        if (t < producers)
+        {
+            produce(t);
+        }
+        else
+        {
+            consume();
+        }
+    });
+
+    return producers * w.xmalloc_batches * w.xmalloc_batch * 2;
+}
+
+// Write to 'block' 'writes' times, so threads given blocks on the same cache line slow each other.
+inline void write_block(void* block, std::size_t writes)
+{
+    volatile std::uint8_t* bytes = reinterpret_cast<volatile std::uint8_t*>(block);
+    for (std::size_t i=0; i<writes; i++)
+    {
+        bytes[i % MIN_BYTES]++;
+    }
+}
+
+// cache-thrash: each thread repeatedly allocates a small block, writes to it and frees it. An allocator
+//  that gives threads blocks on the same cache line causes active false sharing. Returns the number of
+//  operations.
+template <class Alloc>
+std::size_t cache_thrash(Alloc& alloc, std::size_t threads, const Workload& w, std::atomic<std::size_t>& failures)
+{
+    run_threads(threads, [&](std::size_t) {
+        std::size_t failed = 0;
+        for (std::size_t i=0; i<w.cache_iterations; i++)
+        {
+            void* block = alloc.allocate(MIN_BYTES);
+            if (block == nullptr)
+            {
+                failed++;
+                continue;
+            }
+
+            write_block(block, w.cache_writes);
+            alloc.deallocate(block);
+        }
+
+        failures += failed;
+    });
+
+    return threads * w.cache_iterations * 2;
+}
+
+// cache-scratch: as cache-thrash, but each thread first frees a small block allocated for it by the
+//  main thread, next to those of the other threads. An allocator that reuses the freed block causes
+//  passive false sharing. Returns the number of operations.
+template <class Alloc>
+std::size_t cache_scratch(Alloc& alloc, std::size_t threads, const Workload& w, std::atomic<std::size_t>& failures)
+{
+    std::vector<void*> initial(threads);
+    for (void*& block : initial)
+    {
+        block = alloc.allocate(MIN_BYTES);
+    }
+
+    run_threads(threads, [&](std::size_t t) {
+        if (initial[t] != nullptr)
+        {
+            write_block(initial[t], w.cache_writes);
+            alloc.deallocate(initial[t]);
+        }
+
+        std::size_t failed = 0;
+        for (std::size_t i=0; i<w.cache_iterations; i++)
+        {
+            void* block = alloc.allocate(MIN_BYTES);
+            if (block == nullptr)
+            {
+                failed++;
+                continue;
+            }
+
+            write_block(block, w.cache_writes);
+            alloc.deallocate(block);
+        }
+
+        failures += failed;
+    });
+
+    return threads * w.cache_iterations * 2;
+}
+
+// threadtest: each thread repeatedly allocates a number of blocks and then frees them all. Returns the
+//  number of operations.
+template <class Alloc>
+std::size_t threadtest(Alloc& alloc, std::size_t threads, const Workload& w, std::atomic<std::size_t>& failures)
+{
+    run_threads(threads, [&](std::size_t) {
+        std::vector<void*> blocks(w.threadtest_blocks);
+        std::size_t failed = 0;
+
+        for (std::size_t r=0; r<w.threadtest_rounds; r++)
+        {
+            for (void*& block : blocks)
+            {
+                block = alloc.allocate(64);
+                failed += (block == nullptr);
+            }
+            for (void* block : blocks)
+            {
+                if (block != nullptr)
+                {
+                    alloc.deallocate(block);
+                }
+            }
+        }
+
+        failures += failed;
+    });
+
+    return threads * w.threadtest_rounds * w.threadtest_blocks * 2;
+}
+
+// Runs the workloads against each allocator and records the results.
+class ThreadedBenchmarks
+{
+public:
+
+    ThreadedBenchmarks(const BenchmarkConfig& config, const Workload& workload, std::size_t max_threads) :
+        config(config),
+        workload(workload)
+    {
+        for (std::size_t t=1; t<=max_threads; t*=2)
+        {
+            thread_counts.push_back(t);
+        }
+    }
+
+    // Run every workload against an allocator of type 'Alloc' named 'name', constructed on a memory
+    //  buffer of BUFFER_BYTES bytes that is left untouched until the allocator uses it.
+    template <class Alloc>
+    void benchmark_allocator(const std::string& name)
+    {
+        std::unique_ptr<std::uint8_t[]> buffer(new std::uint8_t[BUFFER_BYTES]);
+        MemoryRegion region(buffer.get(), BUFFER_BYTES);
+
+        const std::size_t rss_before = resident_bytes();
+        Alloc alloc(region);
+
+        run_workload("Larson", name, alloc, rss_before, [](Alloc& a, std::size_t t, const Workload& w, std::atomic<std::size_t>& f) { return larson(a, t, w, f); });
+        run_workload("xmalloc-test", name, alloc, rss_before, [](Alloc& a, std::size_t t, const Workload& w, std::atomic<std::size_t>& f) { return xmalloc(a, t, w, f); });
+        run_workload("cache-scratch", name, alloc, rss_before, [](Alloc& a, std::size_t t, const Workload& w, std::atomic<std::size_t>& f) { return cache_scratch(a, t, w, f); });
+        run_workload("cache-thrash", name, alloc, rss_before, [](Alloc& a, std::size_t t, const Workload& w, std::atomic<std::size_t>& f) { return cache_thrash(a, t, w, f); });
+        run_workload("threadtest", name, alloc, rss_before, [](Alloc& a, std::size_t t, const Workload& w, std::atomic<std::size_t>& f) { return threadtest(a, t, w, f); });
+    }
+
+    // Write every result to 'out' in the configured format.
+    void report(std::ostream& out) const
+    {
+        if (config.format == BenchmarkFormat::csv)
+        {
+            out << "workload,allocator,threads,ops_per_sec,ci95,rss_bytes,failures\n";
+            for (const ThreadedResult& r : results)
+            {
+                out << r.workload << "," << r.allocator << "," << r.threads << "," << r.ops_per_sec << ",";
+                out << r.ci95 << "," << r.rss << "," << r.failures << "\n";
+            }
+            return;
+        }
+
+        if (config.format == BenchmarkFormat::json)
+        {
+            out << "[\n";
+            for (std::size_t i=0; i<results.size(); i++)
+            {
+                const ThreadedResult& r = results[i];
+                out << "  {\"workload\": \"" << r.workload << "\", \"allocator\": \"" << r.allocator << "\", ";
+                out << "\"threads\": " << r.threads << ", \"ops_per_sec\": " << r.ops_per_sec << ", \"ci95\": " << r.ci95 << ", ";
+                out << "\"rss_bytes\": " << r.rss << ", \"failures\": " << r.failures << "}";
+                out << ((i + 1 < results.size()) ? "," : "") << "\n";
+            }
+            out << "]\n";
+            return;
+        }
+
+        out << std::fixed << std::setprecision(2);
+
+        // Results are grouped by workload, in the order each workload was first run.
+        std::vector<std::string> workloads;
+        for (const ThreadedResult& r : results)
+        {
+            if (std::find(workloads.begin(), workloads.end(), r.workload) == workloads.end())
+            {
+                workloads.push_back(r.workload);
+            }
+        }
+
+        for (const std::string& name : workloads)
+        {
+            out << name << "\n\t" << std::string(24, ' ') << "Threads\tMops/s\t\t+-95%\tRSS (MiB)\tFailures\n";
+            for (const ThreadedResult& r : results)
+            {
+                if (r.workload == name)
+                {
+                    out << "\t" << std::left << std::setw(24) << r.allocator << std::right << r.threads << "\t";
+                    out << r.ops_per_sec / 1e6 << "\t\t" << r.ci95 / 1e6 << "\t" << r.rss / (1024.0 * 1024.0) << "\t\t" << r.failures << "\n";
+                }
+            }
+        }
+
+        out << std::defaultfloat;
+    }
+
+private:
+
+    // Run 'work' against 'alloc' for each number of threads, as warmup and measured repetitions with
+    //  the allocator reset before each.
+    template <class Alloc, class Work>
+    void run_workload(const std::string& name, const std::string& allocator, Alloc& alloc, std::size_t rss_before, Work&& work)
+    {
+        if (name.find(config.filter) == std::string::npos && allocator.find(config.filter) == std::string::npos)
+        {
+            return;
+        }
+
+        for (std::size_t threads : thread_counts)
+        {
+            ThreadedResult result;
+            result.workload = name;
+            result.allocator = allocator;
+            result.threads = threads;
+
+            std::vector<double> rates;
+            for (std::size_t r=0; r<config.warmup+config.repetitions; r++)
+            {
+                alloc.reset();
+                std::atomic<std::size_t> failures{0};
+
+                const auto start = std::chrono::steady_clock::now();
+                const std::size_t ops = work(alloc, threads, workload, failures);
+                const auto end = std::chrono::steady_clock::now();
+
+                if (r >= config.warmup)
+                {
+                    rates.push_back(ops / std::chrono::duration<double>(end - start).count());
+                    result.failures = failures;
+                }
+            }
+
+            BenchmarkRunner::mean_ci95(rates, result.ops_per_sec, result.ci95);
+
+            const std::size_t rss_after = resident_bytes();
+            result.rss = (rss_after > rss_before) ? rss_after - rss_before : 0;
+
+            results.push_back(result);
+        }
+    }
+
+    const BenchmarkConfig config;
+    const Workload workload;
+
+    // Numbers of threads each workload is run with.
+    std::vector<std::size_t> thread_counts;
+
+    // Results recorded so far.
+    std::vector<ThreadedResult> results;
+
+}; // class ThreadedBenchmarks
+
+int main(int argc, char** argv)
+{
+    BenchmarkConfig config;
+    config.warmup = 1;
+    config.repetitions = 3;
+
+    Workload workload;
+    std::size_t max_threads = 8;
+
+    for (int a=1; a<argc; a++)
+    {
+        const std::string arg = argv[a];
+        const bool has_value = a + 1 < argc;
+
+        if (arg == "--quick")
+        {
+            config.warmup = 0;
+            config.repetitions = 2;
+            max_threads = 2;
+            workload.larson_ops /= 10;
+            workload.xmalloc_batches /= 10;
+            workload.cache_iterations /= 10;
+            workload.threadtest_rounds /= 10;
+        }
+        else if (arg == "--format" && has_value)
+        {
+            const std::string format = argv[++a];
+            config.format = (format == "json") ? BenchmarkFormat::json : (format == "csv") ? BenchmarkFormat::csv : BenchmarkFormat::text;
+        }
+        else if (arg == "--filter" && has_value)
+        {
+            config.filter = argv[++a];
+        }
+        else if (arg == "--threads" && has_value)
+        {
+            max_threads = std::max<std::size_t>(1, std::strtoull(argv[++a], nullptr, 10));
+        }
+        else if (arg == "--warmup" && has_value)
+        {
+            config.warmup = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else if (arg == "--repetitions" && has_value)
+        {
+            config.repetitions = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--quick] [--format text|json|csv] [--filter name] [--threads max]\n";
+            std::cerr << "       [--warmup n] [--repetitions n]\n";
+            return 1;
+        }
+    }
+
+    ThreadedBenchmarks benchmarks(config, workload, max_threads);
+
+    benchmarks.benchmark_allocator<LockedAllocator<FirstFitMemoryAllocator>>("FirstFit (locked)");
+    benchmarks.benchmark_allocator<LockedAllocator<NextFitMemoryAllocator>>("NextFit (locked)");
+    benchmarks.benchmark_allocator<LockedAllocator<PoolAllocationMemoryAllocator<MAX_BYTES>>>("PoolAllocation (locked)");
+    benchmarks.benchmark_allocator<LockedAllocator<BuddySystemMemoryAllocator<64>>>("BuddySystem (locked)");
+    benchmarks.benchmark_allocator<LockedAllocator<SlabMemoryAllocator<>>>("Slab (locked)");
+    benchmarks.benchmark_allocator<ConcurrentArenaAllocator<>>("ConcurrentArena");
+
+    benchmarks.report(std::cout);
+
+    return 0;
+}
@@ -0,0 +1,229 @@
+#ifndef CONCURRENT_ARENA_ALLOCATOR_H
+#define CONCURRENT_ARENA_ALLOCATOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "memory_allocator.h"
+#include "static_memory_allocator.h"
+
+// Implementation of a lock free memory allocator for many threads allocating from one memory buffer
+//  that is freed all at once. Each thread claims a chunk of the memory buffer with a compare and swap
+//  on a shared cursor and then bump allocates from it, so most allocations touch no shared cache lines.
+//  Blocks are not freed individually, only by reset.
+template<std::size_t alignment = alignof(std::max_align_t), std::size_t min_chunk = 4096, std::size_t max_chunk = 1048576>
+class ConcurrentArenaAllocator final : public MemoryAllocator, public StaticMemoryAllocator<ConcurrentArenaAllocator<alignment, min_chunk, max_chunk>>
+{
+public:
+
+    static_assert(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of 2");
+    static_assert(min_chunk % alignment == 0 && max_chunk % alignment == 0, "Chunk sizes must be multiples of alignment");
+    static_assert(min_chunk > 0 && min_chunk <= max_chunk, "Chunk sizes must be non empty");
+
+    // Constructor that takes in a reference to a memory buffer of template type T.
+    template <class T>
+    ConcurrentArenaAllocator(T& buffer) :
+        ConcurrentArenaAllocator(
+            buffer.data(),
+            reinterpret_cast<std::uint8_t*>(buffer.end()) - reinterpret_cast<std::uint8_t*>(buffer.begin())
+            )
+    {
+    }
+
+    // Constructor that takes in the address and size in bytes of a memory region.
+    ConcurrentArenaAllocator(void* addr, std::size_t bytes) :
+        mem(reinterpret_cast<std::uint8_t*>(addr)),
+        total_bytes(bytes),
+        id(next_id().fetch_add(1, std::memory_order_relaxed))
+    {
+    }
+
+    // Allocate a number of bytes and return the address of the allocation. Safe to call from any
+    //  number of threads at once.
+    void* allocate(std::size_t bytes)
+    {
+        if (bytes == 0)
+        {
+            return nullptr;
+        }
+
+        ThreadChunk& tc = thread_chunk();
+        if (tc.owner != id || tc.epoch != epoch.load(std::memory_order_acquire))
+        {
+            tc = ThreadChunk{id, epoch.load(std::memory_order_acquire), nullptr, nullptr, 0, min_chunk};
+        }
+
+        if (tc.cursor != nullptr)
+        {
+            std::size_t padding = pad(tc.cursor);
+            const std::size_t space = static_cast<std::size_t>(tc.end - tc.cursor);
+            if (padding <= space && bytes <= space - padding)
+            {
+                void* addr = tc.cursor + padding;
+                tc.cursor += padding + bytes;
+                return addr;
+            }
+        }
+
+        return allocate_from_new_chunk(tc, bytes);
+    }
+
+    // Blocks are only freed by reset, so this does nothing.
+    void deallocate(void*)
+    {
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state in constant time.
+    //  Must not be called while other threads are allocating.
+    void reset()
+    {
+        cursor.store(0, std::memory_order_relaxed);
+        epoch.fetch_add(1, std::memory_order_release);
+    }
+
+    // Returns number of bytes claimed by threads from the memory buffer, including the unused ends of
+    //  their chunks.
+    std::size_t allocated() const
+    {
+        return cursor.load(std::memory_order_relaxed);
+    }
+
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return total_bytes;
+    }
+
+    // Returns true if 'addr' lies within the memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return addr >= mem && addr < mem + total_bytes;
+    }
+
+    // Returns the size of the next chunk the calling thread will claim in bytes.
+    std::size_t next_chunk_length() const
+    {
+        const ThreadChunk& tc = thread_chunk();
+        if (tc.owner != id || tc.epoch != epoch.load(std::memory_order_acquire))
+        {
+            return min_chunk;
+        }
+
+        return tc.next_chunk;
+    }
+
+private:
+
+    // Chunk of the memory buffer claimed by a thread.
+    struct ThreadChunk
+    {
+        // Id of the allocator and reset epoch the chunk was claimed from.
+        std::uint64_t owner;
+        std::uint64_t epoch;
+
+        // Bump cursor and end of the chunk.
+        std::uint8_t* cursor;
+        std::uint8_t* end;
+
+        // Offset of the end of the chunk in the memory buffer.
+        std::size_t claimed_end;
+
+        // Size of the next chunk to claim in bytes.
+        std::size_t next_chunk;
+    };
+
+    // Returns the chunk of the calling thread. It is shared by every allocator of this type, so a
+    //  thread switching between allocators claims a new chunk each time.
+    static ThreadChunk& thread_chunk()
+    {
+        thread_local ThreadChunk tc{0, 0, nullptr, nullptr, 0, min_chunk};
+        return tc;
+    }
+
+    // Returns the counter used to give every allocator of this type a unique id, so a chunk is never
+    //  mistaken for one claimed from an earlier allocator at the same address.
+    static std::atomic<std::uint64_t>& next_id()
+    {
+        static std::atomic<std::uint64_t> counter{1};
+        return counter;
+    }
+
+    // Returns number of bytes needed after 'addr' to align it.
+    static std::size_t pad(const std::uint8_t* addr)
+    {
+        return (alignment - (reinterpret_cast<std::uintptr_t>(addr) & (alignment - 1))) & (alignment - 1);
+    }
+
+    // Claim a new chunk for the calling thread and allocate 'bytes' from it. The chunk size adapts to
+    //  contention: it doubles if other threads claimed at least a chunk's worth since this thread's last
+    //  claim, and halves if nobody else did. The cursor only moves if 'bytes' fit, and never past the end
+    //  of the memory buffer, where the last chunk is cut short.
+    void* allocate_from_new_chunk(ThreadChunk& tc, std::size_t bytes)
+    {
+        // A chunk also needs room to align the block, so larger blocks never fit, and would overflow
+        //  being rounded up.
+        if (total_bytes < alignment || bytes > total_bytes - alignment)
+        {
+            return nullptr;
+        }
+
+        const std::size_t needed = ((bytes + alignment - 1) / alignment) * alignment + alignment;
+
+        std::size_t offset = cursor.load(std::memory_order_relaxed);
+        std::size_t chunk;
+        do
+        {
+            if (offset > total_bytes || needed > total_bytes - offset)
+            {
+                return nullptr;
+            }
+
+            chunk = std::min(std::max(tc.next_chunk, needed), total_bytes - offset);
+        }
+        while (!cursor.compare_exchange_weak(offset, offset + chunk, std::memory_order_relaxed));
+
+        if (tc.claimed_end != 0)
+        {
+            const std::size_t claimed_by_others = offset - tc.claimed_end;
+            if (claimed_by_others >= tc.next_chunk)
+            {
+                tc.next_chunk = std::min(tc.next_chunk * 2, max_chunk);
+            }
+            else if (claimed_by_others == 0)
+            {
+                tc.next_chunk = std::max(tc.next_chunk / 2, min_chunk);
+            }
+        }
+
+        tc.cursor = mem + offset;
+        tc.end = mem + offset + chunk;
+        tc.claimed_end = offset + chunk;
+
+        // 'needed' leaves room to align the block, so it always fits.
+        std::size_t padding = pad(tc.cursor);
+        void* addr = tc.cursor + padding;
+        tc.cursor += padding + bytes;
+        return addr;
+    }
+
+    // Pointer to memory buffer managed by this object.
+    std::uint8_t* const mem;
+
+    // Length of memory buffer in bytes.
+    const std::size_t total_bytes;
+
+    // Unique id of this allocator.
+    const std::uint64_t id;
+
+    // Offset of the first unclaimed byte in the memory buffer. Kept on it's own cache line as it is the
+    //  only state shared between allocating threads.
+    alignas(64) std::atomic<std::size_t> cursor{0};
+
+    // Incremented by reset so threads know to discard their chunks.
+    alignas(64) std::atomic<std::uint64_t> epoch{0};
+
+}; // class ConcurrentArenaAllocator
+
+#endif // CONCURRENT_ARENA_ALLOCATOR_H
@@ -0,0 +1,255 @@
+#ifndef MONOTONIC_ARENA_ALLOCATOR_H
+#define MONOTONIC_ARENA_ALLOCATOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "memory_allocator.h"
+#include "static_memory_allocator.h"
+
+// Implementation of a memory allocator that allocates by bumping a cursor through the memory buffer,
+//  with no header or free list. Blocks are not freed individually, instead all blocks allocated after
+//  a mark are freed at once by rewinding to it, or all blocks are freed by reset. Up to 'max_chunks'
+//  memory buffers can be chained, and allocation moves on to the next one when the current one is full.
+template<std::size_t alignment = alignof(std::max_align_t), std::size_t max_chunks = 8>
+class MonotonicArenaAllocator final : public MemoryAllocator, public StaticMemoryAllocator<MonotonicArenaAllocator<alignment, max_chunks>>
+{
+public:
+
+    static_assert(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of 2");
+    static_assert(max_chunks > 0, "Arena must have at least 1 chunk");
+
+    // Position of the cursor, returned by mark and passed to rewind.
+    struct Mark
+    {
+        std::size_t chunk;
+        std::size_t offset;
+        std::size_t allocated;
+        std::size_t padding;
+    };
+
+    // Marks the arena on construction and rewinds it to that mark on destruction, freeing every block
+    //  allocated in between.
+    class Scope
+    {
+    public:
+
+        // Constructor that marks 'arena'.
+        Scope(MonotonicArenaAllocator& arena) :
+            arena(arena),
+            start(arena.mark())
+        {
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        // Rewinds the arena to where it was when this object was constructed.
+        ~Scope()
+        {
+            arena.rewind(start);
+        }
+
+    private:
+
+        // Arena that is rewound.
+        MonotonicArenaAllocator& arena;
+
+        // Mark taken on construction.
+        const Mark start;
+
+    }; // class Scope
+
+    // Constructor that takes in a reference to a memory buffer of template type T.
+    template <class T>
+    MonotonicArenaAllocator(T& buffer)
+    {
+        add_chunk(buffer);
+    }
+
+    // Constructor that takes in the address and size in bytes of a memory region.
+    MonotonicArenaAllocator(void* addr, std::size_t bytes)
+    {
+        add_chunk(addr, bytes);
+    }
+
+    // Chain another memory buffer of template type T, used once the previous ones are full. Returns
+    //  false if 'max_chunks' buffers are already chained.
+    template <class T>
+    bool add_chunk(T& buffer)
+    {
+        return add_chunk(buffer.data(), reinterpret_cast<std::uint8_t*>(buffer.end()) - reinterpret_cast<std::uint8_t*>(buffer.begin()));
+    }
+
+    // Chain another memory region of 'bytes' bytes at 'addr'. Returns false if 'max_chunks' buffers are
+    //  already chained.
+    bool add_chunk(void* addr, std::size_t bytes)
+    {
+        if (chunks_count == max_chunks)
+        {
+            return false;
+        }
+
+        chunks[chunks_count] = reinterpret_cast<std::uint8_t*>(addr);
+        chunk_bytes[chunks_count] = bytes;
+        total_bytes += chunk_bytes[chunks_count];
+        chunks_count++;
+
+        return true;
+    }
+
+    // Allocate a number of bytes and return the address of the allocation.
+    void* allocate(std::size_t bytes)
+    {
+        if (bytes == 0)
+        {
+            return nullptr;
+        }
+
+        std::size_t padding = pad(chunks[chunk] + offset);
+        const std::size_t space = chunk_bytes[chunk] - offset;
+        if (padding <= space && bytes <= space - padding)
+        {
+            void* addr = chunks[chunk] + offset + padding;
+
+            offset += padding + bytes;
+            allocated_bytes += padding + bytes;
+            padding_bytes += padding;
+
+            return addr;
+        }
+
+        return allocate_from_next_chunk(bytes);
+    }
+
+    // Blocks are only freed by rewind or reset, so this does nothing.
+    void deallocate(void*)
+    {
+    }
+
+    // Returns the current position of the cursor.
+    Mark mark() const
+    {
+        return Mark{chunk, offset, allocated_bytes, padding_bytes};
+    }
+
+    // Free every block allocated since 'position' was marked.
+    void rewind(const Mark& position)
+    {
+        chunk = position.chunk;
+        offset = position.offset;
+        allocated_bytes = position.allocated;
+        padding_bytes = position.padding;
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state
+    void reset()
+    {
+        chunk = 0;
+        offset = 0;
+        allocated_bytes = 0;
+        padding_bytes = 0;
+    }
+
+    // Returns number of bytes allocated to memory buffers, including alignment padding and the unused
+    //  ends of full chunks.
+    std::size_t allocated() const
+    {
+        return allocated_bytes;
+    }
+
+    // Returns size of memory buffers in bytes.
+    std::size_t length() const
+    {
+        return total_bytes;
+    }
+
+    // Returns number of bytes wasted to alignment padding.
+    std::size_t padding() const
+    {
+        return padding_bytes;
+    }
+
+    // Returns number of chained memory buffers.
+    std::size_t chunks_used() const
+    {
+        return chunks_count;
+    }
+
+    // Returns true if 'addr' lies within a memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        for (std::size_t i=0; i<chunks_count; i++)
+        {
+            if (addr >= chunks[i] && addr < chunks[i] + chunk_bytes[i])
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+
+    // Returns number of bytes needed after 'addr' to align it.
+    static std::size_t pad(const std::uint8_t* addr)
+    {
+        return (alignment - (reinterpret_cast<std::uintptr_t>(addr) & (alignment - 1))) & (alignment - 1);
+    }
+
+    // Allocate from the first following chunk that has room for 'bytes', leaving the rest of the
+    //  chunks before it unused. Returns nullptr without moving the cursor if none have room.
+    void* allocate_from_next_chunk(std::size_t bytes)
+    {
+        for (std::size_t next=chunk+1; next<chunks_count; next++)
+        {
+            std::size_t padding = pad(chunks[next]);
+            if (padding <= chunk_bytes[next] && bytes <= chunk_bytes[next] - padding)
+            {
+                allocated_bytes += chunk_bytes[chunk] - offset;
+                for (std::size_t i=chunk+1; i<next; i++)
+                {
+                    allocated_bytes += chunk_bytes[i];
+                }
+
+                chunk = next;
+                offset = padding + bytes;
+                allocated_bytes += padding + bytes;
+                padding_bytes += padding;
+
+                return chunks[chunk] + padding;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // Start of each chained memory buffer.
+    std::array<std::uint8_t*, max_chunks> chunks;
+
+    // Length of each chained memory buffer in bytes.
+    std::array<std::size_t, max_chunks> chunk_bytes;
+
+    // Number of chained memory buffers.
+    std::size_t chunks_count = 0;
+
+    // Index of the chunk containing the cursor.
+    std::size_t chunk = 0;
+
+    // Offset of the cursor from the start of the current chunk.
+    std::size_t offset = 0;
+
+    // Number of bytes used in memory buffers.
+    std::size_t allocated_bytes = 0;
+
+    // Number of bytes wasted to alignment padding.
+    std::size_t padding_bytes = 0;
+
+    // Length of memory buffers in bytes.
+    std::size_t total_bytes = 0;
+
+}; // class MonotonicArenaAllocator
+
+#endif // MONOTONIC_ARENA_ALLOCATOR_H
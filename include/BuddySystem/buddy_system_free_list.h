@@ -3,9 +3,12 @@
 
 #include <cstddef>
 
+#include "compact_pointer.h"
+
 // Singly linked list data structure used for keeping track of free blocks of memory in memory
-//  memory allocator objects.
-template <std::size_t block_size>
+//  memory allocator objects. When 'compact' is true nodes hold a 32 bit size and a CompactPointer, see
+//  compact_pointer.h.
+template <std::size_t block_size, bool compact = false>
 class BuddySystemFreeList
 {
 public:
@@ -13,8 +16,8 @@ public:
     // Singly linked list node used in free list.
     struct SLLNode
     {
-        std::size_t value;
-        SLLNode* next;
+        NodeSize<compact> value;
+        NodePointer<SLLNode, compact> next;
     };
 
     // Add node to free list after a given node 'prev_node'.
@@ -79,6 +82,35 @@ public:
         return node;        
     }
 
+    // Remove 'count' nodes in a row from free list, starting with the node after 'prev_node' or with
+    //  the first node if it is nullptr. Returns the first node removed.
+    SLLNode* remove_nodes(SLLNode* prev_node, std::size_t count)
+    {
+        SLLNode* first = head_node;
+        if (prev_node != nullptr)
+        {
+            first = prev_node->next;
+        }
+
+        SLLNode* last = first;
+        for (std::size_t i=1; i<count; i++)
+        {
+            last = last->next;
+        }
+
+        if (prev_node == nullptr)
+        {
+            head_node = last->next;
+        }
+        else
+        {
+            prev_node->next = last->next;
+        }
+
+        node_count -= count;
+        return first;
+    }
+
     // Reset this free list back to it's initialisation state.
     void reset()
     {
@@ -93,25 +125,25 @@ public:
     }
 
     // Returns the first node in the free list.
-    SLLNode* head()
+    SLLNode* head() const
     {
         return head_node;
     }
 
-    // Returns the node preceding the correct position of 'new_node' based on ascending memory
+    // Returns the node preceding 'new_node', or the correct position of it, based on ascending memory
     //  addresses.
     SLLNode* find_prev(SLLNode* new_node)
     {
         SLLNode* cursor = head_node;
 
-        if (cursor > new_node)
+        if (cursor >= new_node)
         {
             return nullptr;
         }
 
         while (cursor->next != nullptr)
         {
-            if (cursor->next > new_node)
+            if (cursor->next >= new_node)
             {
                 return cursor;
             }
@@ -1,88 +1,71 @@
 #ifndef BUDDY_SYSTEM_MEMORY_ALLOCATOR_H
 #define BUDDY_SYSTEM_MEMORY_ALLOCATOR_H
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include "BuddySystem/buddy_system_free_list.h"
+#include "allocator_stats.h"
+#include "heap_walk.h"
 #include "memory_allocator.h"
+#include "static_memory_allocator.h"
 
 // Implementation of a memory allocator that uses a variation on the buddy system algorithm to allocate memory.
 //  The variation is that instead of using free lists that double in size, this uses free lists to double in size plus room
-//  for a new node. This is because of the use of a free list to keep track of every node.
-template<std::size_t smallest_block_size>
-class BuddySystemMemoryAllocator : public MemoryAllocator
+//  for a new node. This is because of the use of a free list to keep track of every node. 'Stats' is the
+//  statistics policy, see allocator_stats.h. When 'compact' is true, nodes hold a 32 bit size and a
+//  CompactPointer (see compact_pointer.h), which makes them 8 bytes rather than 16, and the memory buffer
+//  can be at most 4GiB.
+//
+// Each of the 3 smaller block sizes can be given a low and high watermark of free blocks with
+//  set_watermarks. A free list with fewer free blocks than it's low watermark is refilled up to it's high
+//  watermark in one go by splitting larger blocks, and a deallocated block is only merged once it's free
+//  list holds it's high watermark, so blocks allocated and freed in turn aren't split and merged every
+//  time. Both are 0 by default, which splits a block only when a free list is empty and always merges.
+//
+// When 'runs' is true, allocations larger than the largest block size are given a run of blocks of the
+//  largest size in a row, found with a bitmap of which of them are free kept at the start of the memory
+//  buffer. The run has a single node and is split back into blocks of the largest size when it's
+//  deallocated.
+template<std::size_t smallest_block_size, class Stats = NoStats, bool compact = false, bool runs = false>
+class BuddySystemMemoryAllocator final : public MemoryAllocator, public StaticMemoryAllocator<BuddySystemMemoryAllocator<smallest_block_size, Stats, compact, runs>>, private Stats
 {
 public:
 
+    // Type of free list of blocks of 'block_size' bytes
+    template <std::size_t block_size>
+    using FreeList = BuddySystemFreeList<block_size, compact>;
+
     // Type of free list node
     template <std::size_t block_size>
-    using FLNode = typename BuddySystemFreeList<block_size>::SLLNode;
+    using FLNode = typename FreeList<block_size>::SLLNode;
 
     // Constructor that takes in a reference to a memory buffer of template type T.
     template <class T>
-    BuddySystemMemoryAllocator(T& buffer) : 
-        mem(buffer.data()),
-        total_bytes(
-            reinterpret_cast<std::uint8_t*>(buffer.end()) 
-            - reinterpret_cast<std::uint8_t*>(buffer.begin())
+    BuddySystemMemoryAllocator(T& buffer) :
+        BuddySystemMemoryAllocator(
+            buffer.data(),
+            reinterpret_cast<std::uint8_t*>(buffer.end()) - reinterpret_cast<std::uint8_t*>(buffer.begin())
             )
     {
-        assert(smallest_block_size <= total_bytes);
-
-        void* cursor = mem;
-        
-        FLNode<block_size4>* node4;
-        FLNode<block_size4>* prev_node4 = nullptr;
-        while (cursor + node_size + block_size4 <= buffer.end())
-        {
-            node4 = reinterpret_cast<FLNode<block_size4>*>(cursor);
-            node4->value = block_size4;
-            fl4.add_node(node4, prev_node4);
-
-            prev_node4 = node4;
-            cursor += node_size + block_size4;
-            allocated_bytes += node_size;
-        }
-
-        FLNode<block_size3>* node3;
-        FLNode<block_size3>* prev_node3 = nullptr;
-        while (cursor + node_size + block_size3 <= buffer.end())
-        {
-            node3 = reinterpret_cast<FLNode<block_size3>*>(cursor);
-            node3->value = block_size3;
-            fl3.add_node(node3, prev_node3);
-
-            prev_node3 = node3;
-            cursor += node_size + block_size3;
-            allocated_bytes += node_size;
-        }
-
-        FLNode<block_size2>* node2;
-        FLNode<block_size2>* prev_node2 = nullptr;
-        while (cursor + node_size + block_size2 <= buffer.end())
-        {
-            node2 = reinterpret_cast<FLNode<block_size2>*>(cursor);
-            node2->value = block_size2;
-            fl2.add_node(node2, prev_node2);
-
-            prev_node2 = node2;
-            cursor += node_size + block_size2;
-            allocated_bytes += node_size;
-        }
+    }
 
-        FLNode<smallest_block_size>* node;
-        FLNode<smallest_block_size>* prev_node = nullptr;
-        while (cursor + node_size + smallest_block_size <= buffer.end())
-        {
-            node = reinterpret_cast<FLNode<smallest_block_size>*>(cursor);
-            node->value = smallest_block_size;
-            fl1.add_node(node, prev_node);
+    // Constructor that takes in the address and size in bytes of a memory region.
+    BuddySystemMemoryAllocator(void* addr, std::size_t bytes) :
+        mem(addr),
+        total_bytes(bytes),
+        top_index(reinterpret_cast<std::uint64_t*>(index_start(addr))),
+        first_block(reinterpret_cast<void*>(top_index) + index_bytes(bytes)),
+        top_end(first_block + (((bytes - first_block_offset()) / (node_size + block_size4)) * (node_size + block_size4)))
+    {
+        assert(first_block_offset() + smallest_block_size <= total_bytes);
+        assert(!compact || total_bytes <= CompactPointer<FLNode<smallest_block_size>>::max_distance);
 
-            prev_node = node;
-            cursor += node_size + smallest_block_size;
-            allocated_bytes += node_size;
-        }
+        reset();
     }
 
     // Allocate a number of bytes and return the address of the allocation.
@@ -95,12 +78,10 @@ public:
 
         if (bytes <= smallest_block_size)
         {
-            if (fl1.count() == 0)
+            if (!refill<block_size2>(fl2, fl1))
             {
-                if (!divide_node<block_size2>(fl2, fl1))
-                {
-                    return nullptr;
-                }
+                Stats::record_failure();
+                return nullptr;
             }
 
             auto node = fl1.head();
@@ -108,16 +89,17 @@ public:
 
             allocated_bytes += smallest_block_size;
 
+            record_requested<smallest_block_size>(node, bytes);
+            Stats::record_free_block_removed(smallest_block_size);
+            Stats::record_allocate(bytes, smallest_block_size, allocated_bytes);
             return reinterpret_cast<void*>(node)+node_size;
         }
         else if (bytes <= block_size2)
         {
-            if (fl2.count() == 0)
+            if (!refill<block_size3>(fl3, fl2))
             {
-                if (!divide_node<block_size3>(fl3, fl2))
-                {
-                    return nullptr;
-                }
+                Stats::record_failure();
+                return nullptr;
             }
 
             auto node = fl2.head();
@@ -125,16 +107,17 @@ public:
 
             allocated_bytes += block_size2;
 
+            record_requested<block_size2>(node, bytes);
+            Stats::record_free_block_removed(block_size2);
+            Stats::record_allocate(bytes, block_size2, allocated_bytes);
             return reinterpret_cast<void*>(node)+node_size;
         }
         else if (bytes <= block_size3)
         {
-            if (fl3.count() == 0)
+            if (!refill<block_size4>(fl4, fl3))
             {
-                if (!divide_node<block_size4>(fl4, fl3))
-                {
-                    return nullptr;
-                }
+                Stats::record_failure();
+                return nullptr;
             }
 
             auto node = fl3.head();
@@ -142,23 +125,36 @@ public:
 
             allocated_bytes += block_size3;
 
+            record_requested<block_size3>(node, bytes);
+            Stats::record_free_block_removed(block_size3);
+            Stats::record_allocate(bytes, block_size3, allocated_bytes);
             return reinterpret_cast<void*>(node)+node_size;
         }
         else if (bytes <= block_size4)
         {
-            if (fl4.count() == 0)
+            if (fl4.count() == 0 && !use_untouched_block())
             {
+                Stats::record_failure();
                 return nullptr;
             }
 
             auto node = fl4.head();
             fl4.remove_node(node);
+            index_top_block(node, false);
 
             allocated_bytes += block_size4;
 
+            record_requested<block_size4>(node, bytes);
+            Stats::record_free_block_removed(block_size4);
+            Stats::record_allocate(bytes, block_size4, allocated_bytes);
             return reinterpret_cast<void*>(node)+node_size;
         }
+        else if constexpr (runs)
+        {
+            return allocate_run(bytes);
+        }
 
+        Stats::record_failure();
         return nullptr;
     }
 
@@ -178,83 +174,150 @@ public:
                 return _deallocate<block_size2>(reinterpret_cast<FLNode<block_size2>*>(newnode_addr), fl2);
             case smallest_block_size:
                 return _deallocate<smallest_block_size>(temp_node, fl1);
+            default:
+                if constexpr (runs)
+                {
+                    return deallocate_run(newnode_addr);
+                }
         }
     }
 
-    // Deallocates all blocks and returns this object to it's initialisation state
+    // Deallocates all blocks and returns this object to it's initialisation state. Only the nodes of the
+    //  blocks at the end of the memory buffer smaller than the largest block size are written, so this
+    //  takes constant time.
     void reset()
     {
         fl1.reset();
         fl2.reset();
         fl3.reset();
         fl4.reset();
-        allocated_bytes = 0;
+        untouched = first_block;
+
+        // The nodes of blocks of the largest size are counted as allocated before they are written. Bits
+        //  of the bitmap of them are only read once they are used, so it isn't cleared.
+        allocated_bytes = first_block_offset() + (untouched_blocks() * node_size);
+
+        void* cursor = top_end;
+        add_tail_block<block_size3>(cursor, fl3);
+        add_tail_block<block_size2>(cursor, fl2);
+        add_tail_block<smallest_block_size>(cursor, fl1);
+
+        Stats::record_reset(total_bytes, allocated_bytes);
+        Stats::record_free_block_added(block_size4, untouched_blocks());
+        Stats::record_free_block_added(block_size3, fl3.count());
+        Stats::record_free_block_added(block_size2, fl2.count());
+        Stats::record_free_block_added(smallest_block_size, fl1.count());
+    }
 
-        void* cursor = mem;
-        
-        FLNode<block_size4>* node4;
-        FLNode<block_size4>* prev_node4 = nullptr;
-        while (cursor + node_size + block_size4 <= mem + total_bytes)
-        {
-            node4 = reinterpret_cast<FLNode<block_size4>*>(cursor);
-            node4->value = block_size4;
-            fl4.add_node(node4, prev_node4);
+    // Returns number of bytes allocated to memory buffer.
+    std::size_t allocated() const
+    {
+        return allocated_bytes;
+    }
 
-            prev_node4 = node4;
-            cursor += node_size + block_size4;
-            allocated_bytes += node_size;
-        }
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return total_bytes;
+    }
+
+    // Returns true if 'addr' lies within the memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return addr >= mem && addr < mem + total_bytes;
+    }
 
-        FLNode<block_size3>* node3;
-        FLNode<block_size3>* prev_node3 = nullptr;
-        while (cursor + node_size + block_size3 <= mem + total_bytes)
+    // Call 'visit' with the HeapBlock of each block in the memory buffer, in address order, without
+    //  allocating. Every node holds the size of it's block, free or not, which gives the level. Free
+    //  blocks are found by following the free list of each level alongside, which are sorted by
+    //  address. Blocks of the largest size not used yet have no node and are all free, and a run of them
+    //  allocated as one is a single block of the largest level. Any space at the end too small for a
+    //  block is left out.
+    template <class Visitor>
+    void walk(Visitor&& visit) const
+    {
+        // Nodes of every level have the same layout, so they are all read as nodes of the first.
+        using Node = FLNode<smallest_block_size>;
+        std::array<const Node*, 4> next_free = {
+            fl1.head(),
+            reinterpret_cast<const Node*>(fl2.head()),
+            reinterpret_cast<const Node*>(fl3.head()),
+            reinterpret_cast<const Node*>(fl4.head())
+        };
+        const std::array<std::size_t, 4> sizes = block_lengths();
+
+        for (void* cursor = first_block; cursor + node_size + smallest_block_size <= mem + total_bytes;)
         {
-            node3 = reinterpret_cast<FLNode<block_size3>*>(cursor);
-            node3->value = block_size3;
-            fl3.add_node(node3, prev_node3);
+            if (cursor == untouched)
+            {
+                for (; cursor < top_end; cursor += node_size + block_size4)
+                {
+                    visit(HeapBlock{cursor, node_size + block_size4, true, 3});
+                }
 
-            prev_node3 = node3;
-            cursor += node_size + block_size3;
-            allocated_bytes += node_size;
-        }
+                if (cursor + node_size + smallest_block_size > mem + total_bytes)
+                {
+                    break;
+                }
+            }
 
-        FLNode<block_size2>* node2;
-        FLNode<block_size2>* prev_node2 = nullptr;
-        while (cursor + node_size + block_size2 <= mem + total_bytes)
-        {
-            node2 = reinterpret_cast<FLNode<block_size2>*>(cursor);
-            node2->value = block_size2;
-            fl2.add_node(node2, prev_node2);
+            const Node* node = reinterpret_cast<const Node*>(cursor);
+            if (runs && node->value > block_size4)
+            {
+                visit(HeapBlock{cursor, node_size + node->value, false, 3});
+                cursor += node_size + node->value;
+                continue;
+            }
 
-            prev_node2 = node2;
-            cursor += node_size + block_size2;
-            allocated_bytes += node_size;
-        }
+            const std::size_t level = std::find(sizes.begin(), sizes.end(), node->value) - sizes.begin();
 
-        FLNode<smallest_block_size>* node;
-        FLNode<smallest_block_size>* prev_node = nullptr;
-        while (cursor + node_size + smallest_block_size <= mem + total_bytes)
-        {
-            node = reinterpret_cast<FLNode<smallest_block_size>*>(cursor);
-            node->value = smallest_block_size;
-            fl1.add_node(node, prev_node);
+            const bool free = (node == next_free[level]);
+            if (free)
+            {
+                next_free[level] = next_free[level]->next;
+            }
 
-            prev_node = node;
-            cursor += node_size + smallest_block_size;
-            allocated_bytes += node_size;
+            visit(HeapBlock{cursor, node_size + node->value, free, level});
+            cursor += node_size + node->value;
         }
     }
 
-    // Returns number of bytes allocated to memory buffer.
-    std::size_t allocated() const
+    // Returns the statistics recorded by this object.
+    const Stats& stats() const
     {
-        return allocated_bytes;
+        return *this;
     }
 
-    // Returns size of memory buffer in bytes.
-    std::size_t length() const
+    // Returns the size of the largest free block in bytes.
+    std::size_t largest_free_block() const
     {
-        return total_bytes;
+        if (free_blocks4() > 0)
+        {
+            return block_size4;
+        }
+        else if (fl3.count() > 0)
+        {
+            return block_size3;
+        }
+        else if (fl2.count() > 0)
+        {
+            return block_size2;
+        }
+        else if (fl1.count() > 0)
+        {
+            return smallest_block_size;
+        }
+
+        return 0;
+    }
+
+    // Returns the external fragmentation index, 1 - (largest free block / free bytes). Needs a
+    //  statistics policy.
+    double external_fragmentation() const
+    {
+        static_assert(Stats::enabled, "Fragmentation metrics need a statistics policy");
+
+        return Stats::external_fragmentation(largest_free_block());
     }
 
     // Returns array of the lengths of each different size block in bytes.
@@ -281,12 +344,35 @@ public:
         return fl3;
     }
 
-    // Return largest free list.
+    // Return largest free list. Blocks of the largest size are only added to it once they are used, see
+    //  free_blocks4.
     auto free_list4() const
     {
         return fl4;
     }
 
+    // Returns the number of free blocks of the largest size, including those not used yet.
+    std::size_t free_blocks4() const
+    {
+        return fl4.count() + untouched_blocks();
+    }
+
+    // Returns the number of blocks of the largest size not used yet, which have no node written.
+    std::size_t untouched_blocks() const
+    {
+        return static_cast<std::size_t>(reinterpret_cast<std::uint8_t*>(top_end) - reinterpret_cast<std::uint8_t*>(untouched)) / (node_size + block_size4);
+    }
+
+    // Set the low and high watermarks of free blocks of the block size at 'level' of block_lengths(),
+    //  which must be one of the 3 smaller block sizes.
+    void set_watermarks(std::size_t level, std::size_t low, std::size_t high)
+    {
+        assert(level < 3 && low <= high);
+
+        low_watermarks[level] = low;
+        high_watermarks[level] = high;
+    }
+
     // Size of free list node in bytes.
     static const std::size_t node_size = sizeof(FLNode<smallest_block_size>);
 
@@ -306,10 +392,68 @@ public:
 
 private:
 
+    // Returns the index in block_lengths() of 'block_size'.
+    template <std::size_t block_size>
+    static constexpr std::size_t level_of()
+    {
+        return (block_size == smallest_block_size) ? 0 : (block_size == block_size2) ? 1 : (block_size == block_size3) ? 2 : 3;
+    }
+
+    // Write the node of the first block of the largest size not used yet and add it to the largest
+    //  free list, which must be empty. Returns false if every block has been used.
+    bool use_untouched_block()
+    {
+        if (untouched == top_end)
+        {
+            return false;
+        }
+
+        auto node = reinterpret_cast<FLNode<block_size4>*>(untouched);
+        node->value = block_size4;
+        fl4.add_node(node);
+        index_top_block(node, true);
+
+        untouched += node_size + block_size4;
+        return true;
+    }
+
+    // Add a free block of 'block_size' at 'cursor' to 'fl' and move 'cursor' past it, if it fits
+    //  before the end of the memory buffer.
+    template <std::size_t block_size>
+    void add_tail_block(void*& cursor, FreeList<block_size> &fl)
+    {
+        if (cursor + node_size + block_size <= mem + total_bytes)
+        {
+            auto node = reinterpret_cast<FLNode<block_size>*>(cursor);
+            node->value = block_size;
+            fl.add_node(node);
+
+            cursor += node_size + block_size;
+            allocated_bytes += node_size;
+        }
+    }
+
+    // If 'smaller_fl' is empty or has fewer nodes than it's low watermark, divide nodes from 'larger_fl'
+    //  into it until it has as many as it's high watermark, or at least 1. Returns true if 'smaller_fl'
+    //  has a node.
+    template <std::size_t block_size>
+    bool refill(FreeList<block_size> &larger_fl, FreeList<(get_prev_blocksize<block_size>())> &smaller_fl)
+    {
+        constexpr std::size_t level = level_of<get_prev_blocksize<block_size>()>();
+
+        if (smaller_fl.count() == 0 || smaller_fl.count() < low_watermarks[level])
+        {
+            const std::size_t target = std::max<std::size_t>(high_watermarks[level], 1);
+            while (smaller_fl.count() < target && divide_node<block_size>(larger_fl, smaller_fl));
+        }
+
+        return smaller_fl.count() > 0;
+    }
+
     // Divide a node from one free list with block sizes double that of another free list.
     // Add the 2 new nodes to the smaller free list and return true if this was successful.
     template <std::size_t block_size>
-    bool divide_node(BuddySystemFreeList<block_size> &larger_fl, BuddySystemFreeList<(get_prev_blocksize<block_size>())> &smaller_fl)
+    bool divide_node(FreeList<block_size> &larger_fl, FreeList<(get_prev_blocksize<block_size>())> &smaller_fl)
     {
         if (larger_fl.count() == 0)
         {
@@ -327,12 +471,22 @@ private:
                         break;
                     }
                     return false;
+                case block_size4:
+                    if (use_untouched_block())
+                    {
+                        break;
+                    }
+                    return false;
                 default:
                     return false;
             }
         }
 
         void* addr1 = reinterpret_cast<void*>(larger_fl.remove_node(larger_fl.head()));
+        if constexpr (block_size == block_size4)
+        {
+            index_top_block(addr1, false);
+        }
 
         auto node1 = reinterpret_cast<FLNode<get_prev_blocksize<block_size>()>*>(addr1);
         node1->value = get_prev_blocksize<block_size>();
@@ -344,127 +498,327 @@ private:
 
         allocated_bytes += node_size;
 
+        Stats::record_free_block_removed(block_size);
+        Stats::record_free_block_added(get_prev_blocksize<block_size>(), 2);
+        Stats::record_split();
         return true;
     }
 
     // Called by the public deallocate method to deallocate blocks of size 'block_size'.
     template <std::size_t block_size>
-    void _deallocate(FLNode<block_size>* node, BuddySystemFreeList<block_size> &fl)
+    void _deallocate(FLNode<block_size>* node, FreeList<block_size> &fl)
+    {
+        const std::size_t requested = requested_size<block_size>(node);
+
+        merge_recursively<block_size>(node, fl);
+
+        allocated_bytes -= block_size;
+
+        Stats::record_deallocate(requested, block_size, allocated_bytes);
+    }
+
+    // Starts by checking if 'node' can be merged with an adjacent node in free list 'fl' and if it
+    //  can be merged it will merge it with the appropriate node and check if the merged node can be
+    //  merged into the next largest free list. Otherwise 'node' is added to 'fl'.
+    template <std::size_t block_size>
+    void merge_recursively(FLNode<block_size>* node, FreeList<block_size> &fl)
     {
-        if (!merge_recursively<block_size>(node, fl))
+        if (block_size == block_size4 || fl.count() == 0 || fl.count() < high_watermarks[level_of<block_size>()])
         {
             fl.add_node(node);
+            if constexpr (block_size == block_size4)
+            {
+                index_top_block(node, true);
+            }
+            Stats::record_free_block_added(block_size);
+            return;
         }
 
-        allocated_bytes -= block_size;
+        auto prev = fl.find_prev(node);
+        FLNode<block_size>* next = (prev == nullptr) ? fl.head() : static_cast<FLNode<block_size>*>(prev->next);
+
+        FLNode<block_size>* merged;
+        if (prev != nullptr && reinterpret_cast<void*>(prev) + block_size + node_size == reinterpret_cast<void*>(node))
+        {
+            merged = merge_nodes<block_size>(prev, fl);
+        }
+        else if (next != nullptr && reinterpret_cast<void*>(node) + block_size + node_size == reinterpret_cast<void*>(next))
+        {
+            merge_nodes<block_size>(next, fl);
+            merged = node;
+        }
+        else
+        {
+            fl.add_node(node, prev);
+            Stats::record_free_block_added(block_size);
+            return;
+        }
+
+        merged->value = get_next_blocksize<block_size>();
+
+        switch(block_size)
+        {
+            case smallest_block_size:
+                merge_recursively<block_size2>(reinterpret_cast<FLNode<block_size2>*>(merged), fl2);
+                break;
+            case block_size2:
+                merge_recursively<block_size3>(reinterpret_cast<FLNode<block_size3>*>(merged), fl3);
+                break;
+            case block_size3:
+                merge_recursively<block_size4>(reinterpret_cast<FLNode<block_size4>*>(merged), fl4);
+                break;
+        }
     }
 
-    // Starts by checking if 'node' can be merged with adjacent nodes in free list 'fl' and if it
-    //  can be merged it will merge it with the appropriate node, add it to the next largest free
-    //  list and check if that node can merged.
+    // Keep the size requested for an allocated block in the unused next pointer of it's node, so it is
+    //  known when the block is deallocated. Only done when recording statistics. The pointer's storage
+    //  is copied to rather than written through another type.
     template <std::size_t block_size>
-    bool merge_recursively(FLNode<block_size>* node, BuddySystemFreeList<block_size> &fl)
+    void record_requested(FLNode<block_size>* node, std::size_t bytes)
     {
-        if (block_size == block_size4 || fl.count() == 0)
+        if constexpr (Stats::enabled)
         {
-            return false;
+            const NodeSize<compact> size = bytes;
+            std::memcpy(reinterpret_cast<void*>(&node->next), &size, sizeof(size));
         }
+    }
 
-        auto prev = fl.find_prev(node);
-        if (reinterpret_cast<void*>(prev) + block_size + node_size == reinterpret_cast<void*>(node)) // recursively check for merging needed
+    // Returns the size requested for the allocated block of 'node', or 0 when not recording statistics.
+    template <std::size_t block_size>
+    static std::size_t requested_size(const FLNode<block_size>* node)
+    {
+        NodeSize<compact> size = 0;
+        if constexpr (Stats::enabled)
         {
-            merge_nodes<block_size>(prev, node, fl);
+            std::memcpy(&size, reinterpret_cast<const void*>(&node->next), sizeof(size));
+        }
 
-            switch(block_size)
-            {
-                case smallest_block_size:
-                    merge_recursively<block_size2>(reinterpret_cast<FLNode<block_size2>*>(prev), fl2);
-                    break;
-                case block_size2:
-                    merge_recursively<block_size3>(reinterpret_cast<FLNode<block_size3>*>(prev), fl3);
-                    break;
-                case block_size3:
-                    merge_recursively<block_size4>(reinterpret_cast<FLNode<block_size4>*>(prev), fl4);
-                    break;
-            }
+        return size;
+    }
+
+    // Remove node 'free_node' of value 'block_size' from free list 'fl' so it can be merged with the
+    //  adjacent block being deallocated, and return it. The node between the 2 blocks is freed.
+    template <std::size_t block_size>
+    FLNode<block_size>* merge_nodes(FLNode<block_size>* free_node, FreeList<block_size> &fl)
+    {
+        fl.remove_node(free_node);
+
+        allocated_bytes -= node_size;
+
+        Stats::record_free_block_removed(block_size);
+        Stats::record_merge();
+        return free_node;
+    }
 
-            return true;
+    // Returns the number of bytes at the start of a memory buffer of 'bytes' bytes used by the bitmap of
+    //  blocks of the largest size, which is sized for as many as there would be with no bitmap. Only
+    //  kept when 'runs' is true.
+    static constexpr std::size_t index_bytes(std::size_t bytes)
+    {
+        return runs ? (((bytes / (node_size + block_size4)) / word_bits) + 1) * sizeof(std::uint64_t) : 0;
+    }
+
+    // Returns the address the bitmap of blocks of the largest size starts at in a memory buffer at 'addr',
+    //  the first one aligned for it's words. Only aligned when 'runs' is true.
+    static void* index_start(void* addr)
+    {
+        if constexpr (runs)
+        {
+            return reinterpret_cast<void*>((reinterpret_cast<std::uintptr_t>(addr) + alignof(std::uint64_t) - 1) & ~(alignof(std::uint64_t) - 1));
         }
         else
         {
-            if (prev == nullptr)
+            return addr;
+        }
+    }
+
+    // Returns the number of bytes before the first block, used by the bitmap and to align it.
+    std::size_t first_block_offset() const
+    {
+        return static_cast<std::size_t>(reinterpret_cast<std::uint8_t*>(first_block) - reinterpret_cast<std::uint8_t*>(mem));
+    }
+
+    // Returns the number of the block of the largest size at 'addr' from the start of the blocks.
+    std::size_t top_block(void* addr) const
+    {
+        return static_cast<std::size_t>(reinterpret_cast<std::uint8_t*>(addr) - reinterpret_cast<std::uint8_t*>(first_block)) / (node_size + block_size4);
+    }
+
+    // Set the bit of the block of the largest size at 'addr' if it's 'free', or clear it. Blocks merged
+    //  from 2 that aren't in the same block of the largest size don't start where one does, so they have
+    //  no bit and are never part of a run.
+    void index_top_block(void* addr, bool free)
+    {
+        if constexpr (runs)
+        {
+            const std::size_t offset = static_cast<std::size_t>(reinterpret_cast<std::uint8_t*>(addr) - reinterpret_cast<std::uint8_t*>(first_block));
+            if (offset % (node_size + block_size4) == 0)
             {
-                if (reinterpret_cast<void*>(node) + block_size + node_size == reinterpret_cast<void*>(fl.head()))
-                {
-                    merge_nodes<block_size>(node, fl.head(), fl);
+                mark_top_blocks(offset / (node_size + block_size4), 1, free);
+            }
+        }
+    }
 
-                    switch(block_size)
-                    {
-                        case smallest_block_size:
-                            merge_recursively<block_size2>(reinterpret_cast<FLNode<block_size2>*>(node), fl2);
-                            break;
-                        case block_size2:
-                            merge_recursively<block_size3>(reinterpret_cast<FLNode<block_size3>*>(node), fl3);
-                            break;
-                        case block_size3:
-                            merge_recursively<block_size4>(reinterpret_cast<FLNode<block_size4>*>(node), fl4);
-                            break;
-                    }
-                    return true;
-                }
+    // Set the bits of 'count' blocks of the largest size from block 'index' if they are 'free', or clear
+    //  them.
+    void mark_top_blocks(std::size_t index, std::size_t count, bool free)
+    {
+        for (std::size_t i=index; i<index+count; i++)
+        {
+            const std::uint64_t bit = std::uint64_t(1) << (i % word_bits);
+            top_index[i / word_bits] = free ? (top_index[i / word_bits] | bit) : (top_index[i / word_bits] & ~bit);
+        }
+    }
+
+    // Returns the first free block of the largest size from block 'index', or the number of them if
+    //  there is none. Only bits of blocks before 'untouched' are read, as every block after is free.
+    std::size_t next_free_top_block(std::size_t index)
+    {
+        const std::size_t used = top_block(untouched);
+        if (index >= used)
+        {
+            return index;
+        }
+
+        std::size_t w = index / word_bits;
+        std::uint64_t word = top_index[w] & (~std::uint64_t(0) << (index % word_bits));
+        while (word == 0)
+        {
+            if (++w * word_bits >= used)
+            {
+                return used;
             }
-            else
+
+            word = top_index[w];
+        }
+
+        return std::min<std::size_t>((w * word_bits) + __builtin_ctzll(word), used);
+    }
+
+    // Returns the first block of the largest size from block 'index' that isn't free, or the number of
+    //  them if there is none.
+    std::size_t next_used_top_block(std::size_t index)
+    {
+        const std::size_t used = top_block(untouched);
+        const std::size_t blocks = top_block(top_end);
+        if (index >= used)
+        {
+            return blocks;
+        }
+
+        std::size_t w = index / word_bits;
+        std::uint64_t word = ~top_index[w] & (~std::uint64_t(0) << (index % word_bits));
+        while (word == 0)
+        {
+            if (++w * word_bits >= used)
             {
-                if (reinterpret_cast<void*>(node) + block_size + node_size == reinterpret_cast<void*>(prev->next))
-                {
-                    merge_nodes<block_size>(node, prev->next, fl);
+                return blocks;
+            }
 
-                    switch(block_size)
-                    {
-                        case smallest_block_size:
-                            merge_recursively<block_size2>(reinterpret_cast<FLNode<block_size2>*>(node), fl2);
-                            break;
-                        case block_size2:
-                            merge_recursively<block_size3>(reinterpret_cast<FLNode<block_size3>*>(node), fl3);
-                            break;
-                        case block_size3:
-                            merge_recursively<block_size4>(reinterpret_cast<FLNode<block_size4>*>(node), fl4);
-                            break;
-                    }
-                    return true;
-                }
+            word = ~top_index[w];
+        }
+
+        const std::size_t next = (w * word_bits) + __builtin_ctzll(word);
+        return (next >= used) ? blocks : next;
+    }
+
+    // Returns the first block of a run of 'count' free blocks of the largest size in a row, or the
+    //  number of them if there is none.
+    std::size_t find_free_run(std::size_t count)
+    {
+        const std::size_t blocks = top_block(top_end);
+
+        std::size_t start = next_free_top_block(0);
+        while (start + count <= blocks)
+        {
+            const std::size_t end = next_used_top_block(start);
+            if (end - start >= count)
+            {
+                return start;
             }
-            
+
+            start = next_free_top_block(end);
         }
+
+        return blocks;
     }
 
-    // Merge 2 nodes 'node1' and 'node2' of value 'block_size' and remove them from fl 'fl' (if they are part of it)
-    //  and merge them both into node1. Add node1 into a larger free list and return address of it.
-    template <std::size_t block_size>
-    void merge_nodes(FLNode<block_size>* node1, FLNode<block_size>* node2, BuddySystemFreeList<block_size> &fl)
+    // Called by allocate for allocations larger than the largest block size. The run's first node holds
+    //  the size of the whole run after it, which is larger than any block size. The run is found with the
+    //  bitmap, but it's blocks are unlinked from the largest free list after the node before them, which
+    //  is found by walking the list, as the bitmap has no bits for largest blocks merged off the grid.
+    void* allocate_run(std::size_t bytes)
     {
-        fl.remove_node(node1);
-        fl.remove_node(node2);
+        // Checked before 'count' is worked out, which would overflow for requests near SIZE_MAX.
+        const std::size_t run_space = static_cast<std::size_t>(reinterpret_cast<std::uint8_t*>(top_end) - reinterpret_cast<std::uint8_t*>(first_block));
+        if (run_space < node_size || bytes > run_space - node_size)
+        {
+            Stats::record_failure();
+            return nullptr;
+        }
 
-        node1->value += node2->value + node_size;
+        const std::size_t count = (bytes + node_size + node_size + block_size4 - 1) / (node_size + block_size4);
+        const std::size_t start = find_free_run(count);
+        if (start == top_block(top_end))
+        {
+            Stats::record_failure();
+            return nullptr;
+        }
 
-        void* new_node = reinterpret_cast<void*>(node1);
+        void* addr = first_block + (start * (node_size + block_size4));
+        auto node = reinterpret_cast<FLNode<block_size4>*>(addr);
 
-        switch(block_size)
+        // Blocks of the run before 'untouched' are all in the largest free list, one after the other.
+        const std::size_t used = top_block(untouched);
+        if (start < used)
         {
-            case block_size3:
-                fl4.add_node(reinterpret_cast<FLNode<block_size4>*>(new_node));
-                break;
-            case block_size2:
-                fl3.add_node(reinterpret_cast<FLNode<block_size3>*>(new_node));
-                break;
-            case smallest_block_size:
-                fl2.add_node(reinterpret_cast<FLNode<block_size2>*>(new_node));
+            fl4.remove_nodes(fl4.find_prev(node), std::min(count, used - start));
         }
 
-        allocated_bytes -= node_size;
+        untouched = std::max(untouched, addr + (count * (node_size + block_size4)));
+        mark_top_blocks(start, count, false);
+
+        const std::size_t payload = (count * (node_size + block_size4)) - node_size;
+        node->value = payload;
+
+        // The nodes inside the run were counted as allocated already.
+        allocated_bytes += count * block_size4;
+
+        record_requested<block_size4>(node, bytes);
+        Stats::record_free_block_removed(block_size4, count);
+        Stats::record_allocate(bytes, payload, allocated_bytes);
+        return addr + node_size;
     }
 
+    // Called by the public deallocate method to deallocate the run of blocks of the largest size with
+    //  it's node at 'addr', which are each added back to the largest free list after the node before
+    //  them, found by walking the list.
+    void deallocate_run(void* addr)
+    {
+        auto node = reinterpret_cast<FLNode<block_size4>*>(addr);
+        const std::size_t requested = requested_size<block_size4>(node);
+        const std::size_t payload = node->value;
+        const std::size_t count = (payload + node_size) / (node_size + block_size4);
+
+        FLNode<block_size4>* prev = (fl4.count() > 0) ? fl4.find_prev(node) : nullptr;
+        for (std::size_t i=0; i<count; i++)
+        {
+            auto block = reinterpret_cast<FLNode<block_size4>*>(addr + (i * (node_size + block_size4)));
+            block->value = block_size4;
+            fl4.add_node(block, prev);
+            prev = block;
+        }
+
+        mark_top_blocks(top_block(addr), count, true);
+        allocated_bytes -= count * block_size4;
+
+        Stats::record_free_block_added(block_size4, count);
+        Stats::record_deallocate(requested, payload, allocated_bytes);
+    }
+
+    // Number of blocks in each word of the bitmap of blocks of the largest size.
+    static constexpr std::size_t word_bits = 64;
+
     // Pointer to memory buffer managed by this object.
     void* mem;
 
@@ -478,16 +832,16 @@ private:
     static const std::size_t block_size4 = get_next_blocksize<block_size3>(); 
 
     // Free list to keep track of unallocated blocks of memory of the smallest block size.
-    BuddySystemFreeList<smallest_block_size> fl1;
+    FreeList<smallest_block_size> fl1;
 
     // Free list to keep track of unallocated blocks of memory of the smallest block size *2.
-    BuddySystemFreeList<block_size2> fl2;
+    FreeList<block_size2> fl2;
 
     // Free list to keep track of unallocated blocks of memory of the smallest block size *4.
-    BuddySystemFreeList<block_size3> fl3;
+    FreeList<block_size3> fl3;
 
     // Free list to keep track of unallocated blocks of memory of the smallest block size *8.
-    BuddySystemFreeList<block_size4> fl4;
+    FreeList<block_size4> fl4;
 
     // Number of bytes used in memory buffer.
     std::size_t allocated_bytes = 0;
@@ -495,6 +849,27 @@ private:
     // Length of memory buffer in bytes.
     const std::size_t total_bytes;
 
+    // Bitmap with a bit set for each free block of the largest size, at the first address of the memory
+    //  buffer aligned for it's words. Only kept when 'runs' is true.
+    std::uint64_t* const top_index;
+
+    // First block, after the bitmap if there is one.
+    void* const first_block;
+
+    // End of the blocks of the largest size, at the start of the blocks.
+    void* const top_end;
+
+    // First block of the largest size not used yet. Every block from here to 'top_end' is free and has
+    //  no node written.
+    void* untouched;
+
+    // Free lists with fewer free blocks than this are refilled, by block size. Always 0 for the largest.
+    std::array<std::size_t, 4> low_watermarks{};
+
+    // Free lists are refilled up to this many free blocks, and blocks are merged once their free list
+    //  has this many, by block size. Always 0 for the largest.
+    std::array<std::size_t, 4> high_watermarks{};
+
 }; // class BuddySystemMemoryAllocator
 
 #endif // BUDDY_SYSTEM_MEMORY_ALLOCATOR_H
\ No newline at end of file
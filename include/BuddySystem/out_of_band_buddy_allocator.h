@@ -0,0 +1,384 @@
+#ifndef OUT_OF_BAND_BUDDY_ALLOCATOR_H
+#define OUT_OF_BAND_BUDDY_ALLOCATOR_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "allocator_stats.h"
+#include "heap_walk.h"
+#include "memory_allocator.h"
+#include "static_memory_allocator.h"
+
+// Implementation of a memory allocator that uses the buddy system algorithm, like
+//  BuddySystemMemoryAllocator, but keeps all of it's metadata in a side table at the start of the memory
+//  buffer instead of in a node in front of every block. Blocks are exact powers of two from
+//  'smallest_block_size' up to 8 times it, have no header and are aligned to their own size.
+//
+// The side table has a bitmap of free blocks for each level, indexed by the block's number within it's
+//  level, and a byte for each smallest block holding the level of the block that starts there. Each
+//  bitmap has a summary with a bit for each of it's words that has a free block, so the lowest free block
+//  of a level is found without scanning every word before it. The buddy of block i is block i^1 of the
+//  same level, so splitting and merging only change the side table and never write to the blocks. Sizes
+//  requested aren't kept, so statistics record the block size as the size requested. 'Stats' is the
+//  statistics policy, see allocator_stats.h.
+template<std::size_t smallest_block_size, class Stats = NoStats>
+class OutOfBandBuddyAllocator final : public MemoryAllocator, public StaticMemoryAllocator<OutOfBandBuddyAllocator<smallest_block_size, Stats>>, private Stats
+{
+public:
+
+    // Number of different block sizes.
+    static constexpr std::size_t levels = 4;
+
+    // Constructor that takes in a reference to a memory buffer of template type T.
+    template <class T>
+    OutOfBandBuddyAllocator(T& buffer) :
+        OutOfBandBuddyAllocator(
+            buffer.data(),
+            reinterpret_cast<std::uint8_t*>(buffer.end()) - reinterpret_cast<std::uint8_t*>(buffer.begin())
+            )
+    {
+    }
+
+    // Constructor that takes in the address and size in bytes of a memory region.
+    OutOfBandBuddyAllocator(void* addr, std::size_t bytes) :
+        mem(addr),
+        total_bytes(bytes)
+    {
+        static_assert(smallest_block_size > 0 && (smallest_block_size & (smallest_block_size - 1)) == 0, "Blocks must be a power of two bytes");
+        assert(smallest_block_size <= total_bytes);
+
+        // The table is sized for as many blocks as there would be with no table, which is a few more
+        //  than there are.
+        const std::size_t max_units = total_bytes / smallest_block_size;
+
+        // The bitmaps start at the first address aligned for their words.
+        const std::uintptr_t table = (reinterpret_cast<std::uintptr_t>(mem) + alignof(std::uint64_t) - 1) & ~(alignof(std::uint64_t) - 1);
+        void* cursor = reinterpret_cast<void*>(table);
+        for (std::size_t level=0; level<levels; level++)
+        {
+            free_bits[level] = reinterpret_cast<std::uint64_t*>(cursor);
+            words[level] = ((max_units >> level) / word_bits) + 1;
+            cursor += words[level] * sizeof(std::uint64_t);
+
+            summaries[level] = reinterpret_cast<std::uint64_t*>(cursor);
+            summary_words[level] = (words[level] / word_bits) + 1;
+            cursor += summary_words[level] * sizeof(std::uint64_t);
+        }
+
+        orders = reinterpret_cast<std::uint8_t*>(cursor);
+        cursor += max_units;
+
+        // Blocks start at the next multiple of the largest block size, so every block is aligned to it's size.
+        const std::uintptr_t start = (reinterpret_cast<std::uintptr_t>(cursor) + block_size(levels - 1) - 1) & ~(block_size(levels - 1) - 1);
+        blocks = reinterpret_cast<void*>(start);
+        units = (blocks < mem + total_bytes) ? (total_bytes - metadata_bytes()) / smallest_block_size : 0;
+
+        reset();
+    }
+
+    // Allocate a number of bytes and return the address of the allocation.
+    void* allocate(std::size_t bytes)
+    {
+        if (bytes <= 0)
+        {
+            return nullptr;
+        }
+
+        std::size_t level = 0;
+        while (level < levels && block_size(level) < bytes)
+        {
+            level++;
+        }
+
+        // Split the lowest free block of the nearest level with one down to 'level', keeping the lower
+        //  half each time.
+        std::size_t from = level;
+        while (from < levels && free_counts[from] == 0)
+        {
+            from++;
+        }
+
+        if (from == levels)
+        {
+            Stats::record_failure();
+            return nullptr;
+        }
+
+        std::size_t index = take(from);
+        while (from > level)
+        {
+            from--;
+            index *= 2;
+            give(from, index + 1);
+            Stats::record_free_block_added(block_size(from));
+            Stats::record_split();
+        }
+
+        const std::size_t unit = index << level;
+        orders[unit] = level;
+        allocated_bytes += block_size(level);
+
+        Stats::record_allocate(block_size(level), block_size(level), allocated_bytes);
+        return blocks + (unit * smallest_block_size);
+    }
+
+    // Deallocate a block of memory to free it up for re-allocation.
+    void deallocate(void* addr)
+    {
+        const std::size_t unit = static_cast<std::size_t>(reinterpret_cast<std::uint8_t*>(addr) - reinterpret_cast<std::uint8_t*>(blocks)) / smallest_block_size;
+        const std::size_t payload = block_size(orders[unit]);
+
+        std::size_t level = orders[unit];
+        std::size_t index = unit >> level;
+        while (level + 1 < levels && is_free(level, index ^ 1))
+        {
+            remove(level, index ^ 1);
+            Stats::record_merge();
+
+            index /= 2;
+            level++;
+        }
+
+        give(level, index);
+        allocated_bytes -= payload;
+
+        Stats::record_free_block_added(block_size(level));
+        Stats::record_deallocate(payload, payload, allocated_bytes);
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state
+    void reset()
+    {
+        for (std::size_t level=0; level<levels; level++)
+        {
+            for (std::size_t w=0; w<words[level]; w++)
+            {
+                free_bits[level][w] = 0;
+            }
+
+            for (std::size_t w=0; w<summary_words[level]; w++)
+            {
+                summaries[level][w] = 0;
+            }
+
+            hints[level] = 0;
+            free_counts[level] = 0;
+        }
+
+        // Tile the blocks with the largest size that fits, as BuddySystemMemoryAllocator does.
+        std::size_t unit = 0;
+        for (std::size_t level=levels; level-- > 0;)
+        {
+            while (unit + (std::size_t(1) << level) <= units)
+            {
+                give(level, unit >> level);
+                unit += std::size_t(1) << level;
+            }
+        }
+
+        allocated_bytes = metadata_bytes();
+
+        Stats::record_reset(total_bytes, allocated_bytes);
+        for (std::size_t level=0; level<levels; level++)
+        {
+            Stats::record_free_block_added(block_size(level), free_counts[level]);
+        }
+    }
+
+    // Returns number of bytes allocated to memory buffer, including the side table.
+    std::size_t allocated() const
+    {
+        return allocated_bytes;
+    }
+
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return total_bytes;
+    }
+
+    // Returns true if 'addr' lies within the memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return addr >= mem && addr < mem + total_bytes;
+    }
+
+    // Returns the number of bytes before the first block, used by the side table and to align it and the
+    //  blocks.
+    std::size_t metadata_bytes() const
+    {
+        return static_cast<std::size_t>(reinterpret_cast<std::uint8_t*>(blocks) - reinterpret_cast<std::uint8_t*>(mem));
+    }
+
+    // Returns the number of free blocks of 'level'.
+    std::size_t free_blocks(std::size_t level) const
+    {
+        return free_counts[level];
+    }
+
+    // Call 'visit' with the HeapBlock of each block in the memory buffer, in address order, without
+    //  allocating. Any space at the end too small for a block is left out.
+    template <class Visitor>
+    void walk(Visitor&& visit) const
+    {
+        for (std::size_t unit=0; unit<units;)
+        {
+            const std::size_t level = orders[unit];
+            visit(HeapBlock{blocks + (unit * smallest_block_size), block_size(level), is_free(level, unit >> level), level});
+            unit += std::size_t(1) << level;
+        }
+    }
+
+    // Returns the statistics recorded by this object.
+    const Stats& stats() const
+    {
+        return *this;
+    }
+
+    // Returns the size of the largest free block in bytes.
+    std::size_t largest_free_block() const
+    {
+        for (std::size_t level=levels; level-- > 0;)
+        {
+            if (free_counts[level] > 0)
+            {
+                return block_size(level);
+            }
+        }
+
+        return 0;
+    }
+
+    // Returns the external fragmentation index, 1 - (largest free block / free bytes). Needs a
+    //  statistics policy.
+    double external_fragmentation() const
+    {
+        static_assert(Stats::enabled, "Fragmentation metrics need a statistics policy");
+
+        return Stats::external_fragmentation(largest_free_block());
+    }
+
+    // Returns the size of blocks of 'level' in bytes.
+    static constexpr std::size_t block_size(std::size_t level)
+    {
+        return smallest_block_size << level;
+    }
+
+    // Returns array of the lengths of each different size block in bytes.
+    static std::array<std::size_t, levels> block_lengths()
+    {
+        return std::array<std::size_t, levels>{block_size(0), block_size(1), block_size(2), block_size(3)};
+    }
+
+private:
+
+    // Returns true if block 'index' of 'level' is free.
+    bool is_free(std::size_t level, std::size_t index) const
+    {
+        return (free_bits[level][index / word_bits] >> (index % word_bits)) & 1;
+    }
+
+    // Mark block 'index' of 'level' as a free block.
+    void give(std::size_t level, std::size_t index)
+    {
+        const std::size_t w = index / word_bits;
+
+        free_bits[level][w] |= std::uint64_t(1) << (index % word_bits);
+        summaries[level][w / word_bits] |= std::uint64_t(1) << (w % word_bits);
+        if (w / word_bits < hints[level])
+        {
+            hints[level] = w / word_bits;
+        }
+
+        orders[index << level] = level;
+        free_counts[level]++;
+    }
+
+    // Mark free block 'index' of 'level' as no longer free, to be merged with it's buddy.
+    void remove(std::size_t level, std::size_t index)
+    {
+        const std::size_t w = index / word_bits;
+
+        free_bits[level][w] &= ~(std::uint64_t(1) << (index % word_bits));
+        if (free_bits[level][w] == 0)
+        {
+            summaries[level][w / word_bits] &= ~(std::uint64_t(1) << (w % word_bits));
+        }
+
+        free_counts[level]--;
+
+        Stats::record_free_block_removed(block_size(level));
+    }
+
+    // Remove the lowest free block of 'level', which must have one, and return it's index. Every word of
+    //  the level's summary before it's hint is 0.
+    std::size_t take(std::size_t level)
+    {
+        std::size_t s = hints[level];
+        while (summaries[level][s] == 0)
+        {
+            s++;
+        }
+        hints[level] = s;
+
+        Stats::record_visit();
+
+        const std::size_t w = (s * word_bits) + __builtin_ctzll(summaries[level][s]);
+        const std::uint64_t word = free_bits[level][w];
+        free_bits[level][w] = word & (word - 1);
+        if (free_bits[level][w] == 0)
+        {
+            summaries[level][s] &= ~(std::uint64_t(1) << (w % word_bits));
+        }
+
+        free_counts[level]--;
+
+        Stats::record_free_block_removed(block_size(level));
+        return (w * word_bits) + __builtin_ctzll(word);
+    }
+
+    // Number of blocks in each word of a bitmap.
+    static constexpr std::size_t word_bits = 64;
+
+    // Pointer to memory buffer managed by this object.
+    void* mem;
+
+    // Length of memory buffer in bytes.
+    const std::size_t total_bytes;
+
+    // Bitmap of free blocks of each level, in the side table.
+    std::array<std::uint64_t*, levels> free_bits;
+
+    // Number of words in the bitmap of each level.
+    std::array<std::size_t, levels> words;
+
+    // Summary of the bitmap of each level, with a bit set for each word that has a free block, in the
+    //  side table.
+    std::array<std::uint64_t*, levels> summaries;
+
+    // Number of words in the summary of each level.
+    std::array<std::size_t, levels> summary_words;
+
+    // Level of the block starting at each smallest block, in the side table.
+    std::uint8_t* orders;
+
+    // Address of the first block, after the side table.
+    void* blocks;
+
+    // Number of smallest blocks that fit after the side table.
+    std::size_t units;
+
+    // Index of the first word of each level's summary that may have a free block.
+    std::array<std::size_t, levels> hints;
+
+    // Number of free blocks of each level.
+    std::array<std::size_t, levels> free_counts;
+
+    // Number of bytes used in memory buffer.
+    std::size_t allocated_bytes = 0;
+
+}; // class OutOfBandBuddyAllocator
+
+#endif // OUT_OF_BAND_BUDDY_ALLOCATOR_H
@@ -0,0 +1,133 @@
+#ifndef BUCKETIZER_H
+#define BUCKETIZER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "memory_region.h"
+#include "static_memory_allocator.h"
+
+// Allocator that splits a memory buffer into equal regions, each managed by an allocator of type
+//  'Alloc', and routes requests to them in size buckets of 'step' bytes between 'min' and 'max'
+//  (inclusive). Bucket i serves requests of [min + i*step, min + (i+1)*step - 1] bytes, so blocks of
+//  similar sizes are kept together.
+template <class Alloc, std::size_t min, std::size_t max, std::size_t step>
+class Bucketizer : public StaticMemoryAllocator<Bucketizer<Alloc, min, max, step>>
+{
+public:
+
+    static_assert(is_memory_allocator<Alloc>::value, "Alloc must implement the memory allocator interface");
+    static_assert(min > 0 && min <= max && step > 0, "Bucket range must be non empty");
+    static_assert((max - min + 1) % step == 0, "Bucket range must be a multiple of step");
+
+    // Number of buckets.
+    static constexpr std::size_t bucket_count = (max - min + 1) / step;
+
+    // Constructor that takes in a reference to a memory buffer of template type T.
+    template <class T>
+    Bucketizer(T& buffer) :
+        Bucketizer(
+            buffer.data(),
+            reinterpret_cast<std::uint8_t*>(buffer.end()) - reinterpret_cast<std::uint8_t*>(buffer.begin())
+            )
+    {
+    }
+
+    // Constructor that takes in the address and size in bytes of a memory region.
+    Bucketizer(void* addr, std::size_t bytes) :
+        mem(addr),
+        total_bytes(bytes),
+        bucket_bytes(((total_bytes / bucket_count) / alignof(std::max_align_t)) * alignof(std::max_align_t)),
+        buckets(make_buckets(std::make_index_sequence<bucket_count>()))
+    {
+    }
+
+    // Allocate a number of bytes and return the address of the allocation.
+    void* allocate(std::size_t bytes)
+    {
+        if (bytes < min || bytes > max)
+        {
+            return nullptr;
+        }
+
+        return buckets[(bytes - min) / step].allocate(bytes);
+    }
+
+    // Deallocate a block of memory to free it up for re-allocation.
+    void deallocate(void* addr)
+    {
+        buckets[(reinterpret_cast<std::uint8_t*>(addr) - reinterpret_cast<std::uint8_t*>(mem)) / bucket_bytes].deallocate(addr);
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state
+    void reset()
+    {
+        for (auto& bucket : buckets)
+        {
+            bucket.reset();
+        }
+    }
+
+    // Returns number of bytes allocated to memory buffer.
+    std::size_t allocated() const
+    {
+        std::size_t bytes = 0;
+        for (const auto& bucket : buckets)
+        {
+            bytes += bucket.allocated();
+        }
+
+        return bytes;
+    }
+
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return total_bytes;
+    }
+
+    // Returns true if 'addr' lies within the part of the memory buffer managed by the buckets.
+    bool owns(void* addr) const
+    {
+        return addr >= mem && addr < mem + (bucket_count * bucket_bytes);
+    }
+
+    // Returns allocator for bucket 'i'.
+    Alloc& bucket(std::size_t i)
+    {
+        return buckets[i];
+    }
+
+private:
+
+    // Construct an allocator over an equal region of the memory buffer for each bucket.
+    template <std::size_t... I>
+    std::array<Alloc, bucket_count> make_buckets(std::index_sequence<I...>)
+    {
+        std::array<MemoryRegion, bucket_count> regions{region(I)...};
+        return std::array<Alloc, bucket_count>{Alloc(regions[I])...};
+    }
+
+    // Returns region of the memory buffer managed by bucket 'i'.
+    MemoryRegion region(std::size_t i) const
+    {
+        return MemoryRegion(mem + (i * bucket_bytes), bucket_bytes);
+    }
+
+    // Pointer to memory buffer managed by this object.
+    void* mem;
+
+    // Length of memory buffer in bytes.
+    const std::size_t total_bytes;
+
+    // Length of the region of the memory buffer managed by each bucket in bytes.
+    const std::size_t bucket_bytes;
+
+    // Allocator for each bucket.
+    std::array<Alloc, bucket_count> buckets;
+
+}; // class Bucketizer
+
+#endif // BUCKETIZER_H
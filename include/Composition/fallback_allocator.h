@@ -0,0 +1,109 @@
+#ifndef FALLBACK_ALLOCATOR_H
+#define FALLBACK_ALLOCATOR_H
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+#include "static_memory_allocator.h"
+
+// Allocator that tries to allocate from allocator 'Primary' and only allocates from allocator
+//  'Secondary' when that fails. Deallocation is routed by asking 'Primary' if it owns the address.
+template <class Primary, class Secondary>
+class FallbackAllocator : public StaticMemoryAllocator<FallbackAllocator<Primary, Secondary>>
+{
+public:
+
+    static_assert(is_memory_allocator<Primary>::value, "Primary must implement the memory allocator interface");
+    static_assert(is_memory_allocator<Secondary>::value, "Secondary must implement the memory allocator interface");
+
+    // Constructor that takes in a reference to the memory buffer of each allocator.
+    template <class PrimaryBuffer, class SecondaryBuffer>
+    FallbackAllocator(PrimaryBuffer& primary_buffer, SecondaryBuffer& secondary_buffer) :
+        primary(primary_buffer),
+        secondary(secondary_buffer)
+    {
+    }
+
+    // Constructor that takes in a tuple of constructor arguments for each allocator, used when
+    //  either allocator is itself a composition.
+    template <class PrimaryArgs, class SecondaryArgs>
+    FallbackAllocator(std::piecewise_construct_t, PrimaryArgs&& primary_args, SecondaryArgs&& secondary_args) :
+        primary(std::make_from_tuple<Primary>(std::forward<PrimaryArgs>(primary_args))),
+        secondary(std::make_from_tuple<Secondary>(std::forward<SecondaryArgs>(secondary_args)))
+    {
+    }
+
+    // Allocate a number of bytes and return the address of the allocation.
+    void* allocate(std::size_t bytes)
+    {
+        void* addr = primary.allocate(bytes);
+        if (addr == nullptr)
+        {
+            addr = secondary.allocate(bytes);
+        }
+
+        return addr;
+    }
+
+    // Deallocate a block of memory to free it up for re-allocation.
+    void deallocate(void* addr)
+    {
+        if (primary.owns(addr))
+        {
+            primary.deallocate(addr);
+        }
+        else
+        {
+            secondary.deallocate(addr);
+        }
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state
+    void reset()
+    {
+        primary.reset();
+        secondary.reset();
+    }
+
+    // Returns number of bytes allocated to memory buffers.
+    std::size_t allocated() const
+    {
+        return primary.allocated() + secondary.allocated();
+    }
+
+    // Returns size of memory buffers in bytes.
+    std::size_t length() const
+    {
+        return primary.length() + secondary.length();
+    }
+
+    // Returns true if 'addr' lies within a memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return primary.owns(addr) || secondary.owns(addr);
+    }
+
+    // Returns allocator that is tried first.
+    Primary& primary_allocator()
+    {
+        return primary;
+    }
+
+    // Returns allocator used when the primary allocator fails.
+    Secondary& secondary_allocator()
+    {
+        return secondary;
+    }
+
+private:
+
+    // Allocator that is tried first.
+    Primary primary;
+
+    // Allocator used when the primary allocator fails.
+    Secondary secondary;
+
+}; // class FallbackAllocator
+
+#endif // FALLBACK_ALLOCATOR_H
@@ -0,0 +1,76 @@
+#ifndef LOCKED_ALLOCATOR_H
+#define LOCKED_ALLOCATOR_H
+
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+#include "static_memory_allocator.h"
+
+// Allocator that makes allocator 'Alloc' safe to share between threads by holding a mutex for the
+//  duration of every call.
+template <class Alloc>
+class LockedAllocator : public StaticMemoryAllocator<LockedAllocator<Alloc>>
+{
+public:
+
+    static_assert(is_memory_allocator<Alloc>::value, "Alloc must implement the memory allocator interface");
+
+    // Constructor that forwards all of it's arguments to the constructor of the locked allocator.
+    template <class... Args>
+    LockedAllocator(Args&&... args) :
+        alloc(std::forward<Args>(args)...)
+    {
+    }
+
+    // Allocate a number of bytes and return the address of the allocation.
+    void* allocate(std::size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return alloc.allocate(bytes);
+    }
+
+    // Deallocate a block of memory to free it up for re-allocation.
+    void deallocate(void* addr)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        alloc.deallocate(addr);
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        alloc.reset();
+    }
+
+    // Returns number of bytes allocated to memory buffer.
+    std::size_t allocated() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return alloc.allocated();
+    }
+
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return alloc.length();
+    }
+
+    // Returns true if 'addr' lies within the memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return alloc.owns(addr);
+    }
+
+private:
+
+    // Allocator that all calls are forwarded to.
+    Alloc alloc;
+
+    // Mutex held for the duration of every call.
+    mutable std::mutex mutex;
+
+}; // class LockedAllocator
+
+#endif // LOCKED_ALLOCATOR_H
@@ -0,0 +1,109 @@
+#ifndef SEGREGATOR_H
+#define SEGREGATOR_H
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+#include "static_memory_allocator.h"
+
+// Allocator that routes requests of up to 'threshold' bytes to allocator 'Small' and every larger
+//  request to allocator 'Large'. Routing is resolved at compile time, so both allocators are called
+//  directly. Deallocation is routed by asking 'Small' if it owns the address.
+template <std::size_t threshold, class Small, class Large>
+class Segregator : public StaticMemoryAllocator<Segregator<threshold, Small, Large>>
+{
+public:
+
+    static_assert(is_memory_allocator<Small>::value, "Small must implement the memory allocator interface");
+    static_assert(is_memory_allocator<Large>::value, "Large must implement the memory allocator interface");
+
+    // Constructor that takes in a reference to the memory buffer of each allocator.
+    template <class SmallBuffer, class LargeBuffer>
+    Segregator(SmallBuffer& small_buffer, LargeBuffer& large_buffer) :
+        small(small_buffer),
+        large(large_buffer)
+    {
+    }
+
+    // Constructor that takes in a tuple of constructor arguments for each allocator, used when
+    //  either allocator is itself a composition.
+    template <class SmallArgs, class LargeArgs>
+    Segregator(std::piecewise_construct_t, SmallArgs&& small_args, LargeArgs&& large_args) :
+        small(std::make_from_tuple<Small>(std::forward<SmallArgs>(small_args))),
+        large(std::make_from_tuple<Large>(std::forward<LargeArgs>(large_args)))
+    {
+    }
+
+    // Allocate a number of bytes and return the address of the allocation.
+    void* allocate(std::size_t bytes)
+    {
+        if (bytes <= threshold)
+        {
+            return small.allocate(bytes);
+        }
+
+        return large.allocate(bytes);
+    }
+
+    // Deallocate a block of memory to free it up for re-allocation.
+    void deallocate(void* addr)
+    {
+        if (small.owns(addr))
+        {
+            small.deallocate(addr);
+        }
+        else
+        {
+            large.deallocate(addr);
+        }
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state
+    void reset()
+    {
+        small.reset();
+        large.reset();
+    }
+
+    // Returns number of bytes allocated to memory buffers.
+    std::size_t allocated() const
+    {
+        return small.allocated() + large.allocated();
+    }
+
+    // Returns size of memory buffers in bytes.
+    std::size_t length() const
+    {
+        return small.length() + large.length();
+    }
+
+    // Returns true if 'addr' lies within a memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return small.owns(addr) || large.owns(addr);
+    }
+
+    // Returns allocator used for requests of up to 'threshold' bytes.
+    Small& small_allocator()
+    {
+        return small;
+    }
+
+    // Returns allocator used for requests larger than 'threshold' bytes.
+    Large& large_allocator()
+    {
+        return large;
+    }
+
+private:
+
+    // Allocator for requests of up to 'threshold' bytes.
+    Small small;
+
+    // Allocator for requests larger than 'threshold' bytes.
+    Large large;
+
+}; // class Segregator
+
+#endif // SEGREGATOR_H
@@ -2,19 +2,28 @@
 #define FREE_LIST_H
 
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "compact_pointer.h"
 
 // Doubly linked list data structure used for keeping track of free blocks of memory in memory
-//  memory allocator objects.
-class FirstFitFreeList
+//  memory allocator objects. When 'compact' is true nodes hold CompactPointers with a granularity of
+//  'granularity' bytes (see compact_pointer.h), and sizes of 32 bits, or 64 when 'granularity' is 8 so
+//  they reach as far as the pointers. Nodes must then be aligned to 'granularity'.
+template <bool compact = false, std::size_t granularity = 4>
+class BasicFirstFitFreeList
 {
+    static_assert(!compact || granularity == 4 || granularity == 8, "Compact nodes have a granularity of 4 or 8 bytes");
+
 public:
 
     // Doubly linked list node used in free list.
     struct DLLNode
     {
-        std::size_t value;
-        DLLNode* next;
-        DLLNode* prev;
+        std::conditional_t<compact && granularity == 4, std::uint32_t, std::size_t> value;
+        std::conditional_t<compact, CompactPointer<DLLNode, true, granularity>, DLLNode*> next;
+        std::conditional_t<compact, CompactPointer<DLLNode, false, granularity>, DLLNode*> prev;
     };
 
     // Add node to free list after a given node 'prev_node'.
@@ -41,6 +50,11 @@ public:
             prev_node->next = new_node;
         }
 
+        if (new_node->next == nullptr)
+        {
+            tail_node = new_node;
+        }
+
         node_count++;
     }
 
@@ -57,6 +71,7 @@ public:
             new_node->next = nullptr;
 
             head_node = new_node;
+            tail_node = new_node;
 
             node_count++;
         }
@@ -68,6 +83,7 @@ public:
         if (node_count == 1)
         {
             head_node = nullptr;
+            tail_node = nullptr;
             node_count--;
             return node;
         }
@@ -85,6 +101,10 @@ public:
         {
             node->next->prev = node->prev;
         }
+        else
+        {
+            tail_node = node->prev;
+        }
 
         node_count--;
         return node;        
@@ -95,6 +115,7 @@ public:
     {
         this->node_count = 0;
         this->head_node = nullptr;
+        this->tail_node = nullptr;
     }
 
     // Returns number of nodes in free list.
@@ -104,11 +125,17 @@ public:
     }
 
     // Returns the first node in the free list.
-    DLLNode* head()
+    DLLNode* head() const
     {
         return head_node;
     }
 
+    // Returns the last node in the free list.
+    DLLNode* tail() const
+    {
+        return tail_node;
+    }
+
 private:
 
     // Returns the node preceding the correct position of 'new_node' based on ascending memory
@@ -141,6 +168,12 @@ private:
     // First node in the free list.
     DLLNode* head_node = nullptr;
 
-}; // class FirstFitFreeList
+    // Last node in the free list.
+    DLLNode* tail_node = nullptr;
+
+}; // class BasicFirstFitFreeList
+
+// Free list with nodes of std::size_t sizes and pointers.
+using FirstFitFreeList = BasicFirstFitFreeList<>;
 
 #endif // FREE_LIST_H
\ No newline at end of file
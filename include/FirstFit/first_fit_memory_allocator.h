@@ -1,43 +1,434 @@
 #ifndef FIRST_FIT_MEMORY_ALLOCATOR_H
 #define FIRST_FIT_MEMORY_ALLOCATOR_H
 
+#include <array>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
+#include "allocator_stats.h"
 #include "first_fit_free_list.h"
+#include "heap_walk.h"
 #include "memory_allocator.h"
+#include "static_memory_allocator.h"
 
-// Implementation of a memory allocator that uses the first fit algorithm to allocate memory.
-class FirstFitMemoryAllocator : public MemoryAllocator
+// Implementation of a memory allocator that uses the first fit algorithm to allocate memory. 'Stats' is the
+//  statistics policy, see allocator_stats.h.
+//
+// When 'quick_max' is greater than 0, freed blocks of up to 'quick_max' bytes are kept on quick lists, one
+//  singly linked list per block size, instead of being merged into the free list. An allocation of one of
+//  those sizes takes the most recently freed block of it's size without searching or splitting. Quick
+//  lists are only consolidated into the free list when an allocation fails, or by trim().
+//
+// When 'wilderness' is true, the untouched end of the memory buffer is a wilderness that is not on the
+//  free list. Blocks are bumped off the start of it once the free list has no block large enough, and
+//  freed blocks that border it are merged back into it. No node is written to the memory buffer until it
+//  is first allocated.
+//
+// When 'compact' is true, an allocated block only has a header of 'granularity' bytes in front of it
+//  holding it's size, and a free block keeps the CompactPointers of it's node (see compact_pointer.h) in
+//  it's payload. Blocks are then a multiple of 'granularity' bytes with room for those pointers, so a 1
+//  byte allocation takes 12 bytes rather than 25 when 'granularity' is 4, and the memory buffer can be at
+//  most 4GiB, or 32GiB when 'granularity' is 8.
+template <class Stats, std::size_t quick_max = 0, bool wilderness = false, bool compact = false, std::size_t granularity = 4>
+class BasicFirstFitMemoryAllocator final : public MemoryAllocator, public StaticMemoryAllocator<BasicFirstFitMemoryAllocator<Stats, quick_max, wilderness, compact, granularity>>, private Stats
 {
 public:
 
     // Type of free list node
-    using FLNode = FirstFitFreeList::DLLNode;
+    using FLNode = typename BasicFirstFitFreeList<compact, granularity>::DLLNode;
 
     // Constructor that takes in a reference to a memory buffer of template type T.
     template <class T>
-    FirstFitMemoryAllocator(T& buffer) : 
-        mem(buffer.data()),
-        allocated_bytes(node_size),
-        total_bytes(
-            reinterpret_cast<std::uint8_t*>(buffer.end()) 
-            - reinterpret_cast<std::uint8_t*>(buffer.begin())
+    BasicFirstFitMemoryAllocator(T& buffer) :
+        BasicFirstFitMemoryAllocator(
+            buffer.data(),
+            reinterpret_cast<std::uint8_t*>(buffer.end()) - reinterpret_cast<std::uint8_t*>(buffer.begin())
             )
     {
-        FLNode* start_node = reinterpret_cast<FLNode*>(mem);
-        start_node->value = total_bytes - node_size;
-        fl.add_node(start_node);
+    }
+
+    // Constructor that takes in the address and size in bytes of a memory region.
+    BasicFirstFitMemoryAllocator(void* addr, std::size_t bytes) :
+        mem(align_start(addr)),
+        top(mem),
+        quick{},
+        quick_count(0),
+        allocated_bytes(header_size),
+        total_bytes(usable_bytes(addr, bytes))
+    {
+        assert(!compact || total_bytes <= max_compact_bytes);
+
+        if constexpr (wilderness)
+        {
+            Stats::record_reset(total_bytes, allocated_bytes);
+            Stats::record_free_block_added(total_bytes - header_size);
+        }
+        else
+        {
+            FLNode* start_node = reinterpret_cast<FLNode*>(mem);
+            start_node->value = total_bytes - header_size;
+            fl.add_node(start_node);
+
+            Stats::record_reset(total_bytes, allocated_bytes);
+            Stats::record_free_block_added(start_node->value);
+        }
     }
 
     // Allocate a number of bytes and return the address of the allocation.
     void* allocate(std::size_t bytes)
+    {
+        bytes = block_bytes(bytes);
+
+        if constexpr (quick_max > 0)
+        {
+            if (bytes > 0 && bytes <= quick_max && quick[bytes - 1] != nullptr)
+            {
+                FLNode* node = pop_quick(bytes);
+                allocated_bytes += node->value;
+
+                Stats::record_visit();
+                Stats::record_free_block_removed(node->value);
+                Stats::record_allocate(node->value, node->value, allocated_bytes);
+                return reinterpret_cast<void*>(node) + header_size;
+            }
+        }
+
+        void* addr = allocate_block(bytes);
+
+        if constexpr (quick_max > 0)
+        {
+            // The blocks on the quick lists may merge into one that is large enough.
+            if (addr == nullptr && quick_count > 0)
+            {
+                consolidate();
+                addr = allocate_block(bytes);
+            }
+        }
+
+        if (addr == nullptr && bytes > 0)
+        {
+            Stats::record_failure();
+        }
+
+        return addr;
+    }
+
+    // Deallocate a block of memory to free it up for re-allocation.
+    void deallocate(void* addr)
+    {
+        FLNode* node = reinterpret_cast<FLNode*>(addr - header_size);
+
+        // Only read when recording statistics, so the load is not kept when they are disabled.
+        const std::size_t payload = Stats::enabled ? node->value : 0;
+
+        if constexpr (quick_max > 0)
+        {
+            if (node->value <= quick_max)
+            {
+                allocated_bytes -= node->value;
+
+                Stats::record_free_block_added(node->value);
+                push_quick(node);
+                Stats::record_deallocate(payload, payload, allocated_bytes);
+                return;
+            }
+        }
+
+        free_block(node);
+
+        Stats::record_deallocate(payload, payload, allocated_bytes);
+    }
+
+    // Merges every block on the quick lists into the free list. Does nothing without quick lists.
+    void trim()
+    {
+        if constexpr (quick_max > 0)
+        {
+            consolidate();
+        }
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state
+    void reset()
+    {
+        fl.reset();
+        quick.fill(nullptr);
+        quick_count = 0;
+        allocated_bytes = header_size;
+
+        if constexpr (wilderness)
+        {
+            top = mem;
+
+            Stats::record_reset(total_bytes, allocated_bytes);
+            Stats::record_free_block_added(total_bytes - header_size);
+        }
+        else
+        {
+            FLNode* start_node = reinterpret_cast<FLNode*>(mem);
+            start_node->value = total_bytes - header_size;
+            fl.add_node(start_node);
+
+            Stats::record_reset(total_bytes, allocated_bytes);
+            Stats::record_free_block_added(start_node->value);
+        }
+    }
+
+    // Returns number of bytes allocated to memory buffer. Blocks on the quick lists are not counted.
+    std::size_t allocated() const
+    {
+        return allocated_bytes;
+    }
+
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return total_bytes;
+    }
+
+    // Returns true if 'addr' lies within the memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return addr >= mem && addr < mem + total_bytes;
+    }
+
+    // Call 'visit' with the HeapBlock of each block in the memory buffer, in address order, without
+    //  allocating. Blocks are found by stepping over each node's size, and free blocks by following
+    //  the free list alongside, which is sorted by address. Blocks on the quick lists are free, and the
+    //  wilderness is one free block.
+    template <class Visitor>
+    void walk(Visitor&& visit) const
+    {
+        const FLNode* next_free = fl.head();
+
+        for (void* cursor = mem; cursor < top_of_blocks();)
+        {
+            const FLNode* node = reinterpret_cast<const FLNode*>(cursor);
+            bool free = (node == next_free);
+            if (free)
+            {
+                next_free = next_free->next;
+            }
+            else if constexpr (quick_max > 0)
+            {
+                free = on_quick_list(node);
+            }
+
+            const std::size_t bytes = header_size + (node->value & ~quick_flag);
+            visit(HeapBlock{cursor, bytes, free, 0});
+            cursor += bytes;
+        }
+
+        if constexpr (wilderness)
+        {
+            if (top != mem + total_bytes)
+            {
+                visit(HeapBlock{top, static_cast<std::size_t>(reinterpret_cast<std::uint8_t*>(mem) + total_bytes - reinterpret_cast<std::uint8_t*>(top)), true, 0});
+            }
+        }
+    }
+
+    // Returns the statistics recorded by this object.
+    const Stats& stats() const
+    {
+        return *this;
+    }
+
+    // Returns the size of the largest free block in bytes. Needs a statistics policy, which tracks the
+    //  largest free block of each size bucket, so the free blocks are only searched when the last of the
+    //  largest size has been removed and smaller ones are left in it's bucket.
+    std::size_t largest_free_block() const
+    {
+        static_assert(Stats::enabled, "Fragmentation metrics need a statistics policy");
+
+        if (!Stats::largest_free_known())
+        {
+            std::size_t largest = 0;
+            std::size_t count = 0;
+            const auto visit = [&](std::size_t bytes) {
+                if (bytes > largest)
+                {
+                    largest = bytes;
+                    count = 0;
+                }
+                count += (bytes == largest) ? 1 : 0;
+            };
+
+            for (const FLNode* node = fl.head(); node != nullptr; node = node->next)
+            {
+                visit(node->value);
+            }
+
+            for (std::size_t i=0; i<quick_max; i++)
+            {
+                for (const FLNode* node = quick[i]; node != nullptr; node = quick_next(node))
+                {
+                    visit(i + 1);
+                }
+            }
+
+            if constexpr (wilderness)
+            {
+                if (top != mem + total_bytes)
+                {
+                    visit(wilderness_bytes());
+                }
+            }
+
+            Stats::record_largest_free(largest, count);
+        }
+
+        return Stats::largest_free();
+    }
+
+    // Returns the external fragmentation index, 1 - (largest free block / free bytes). Needs a
+    //  statistics policy.
+    double external_fragmentation() const
+    {
+        return Stats::external_fragmentation(largest_free_block());
+    }
+
+    // Return free list.
+    BasicFirstFitFreeList<compact, granularity> free_list() const
+    {
+        return fl;
+    }
+
+    // Returns the number of blocks on the quick lists.
+    std::size_t quick_list_count() const
+    {
+        return quick_count;
+    }
+
+    // Returns the number of free bytes in the wilderness, not counting the header the next block bumped
+    //  off it will need. Returns 0 when there is no wilderness.
+    std::size_t wilderness_bytes() const
+    {
+        if constexpr (wilderness)
+        {
+            if (top != mem + total_bytes)
+            {
+                return reinterpret_cast<std::uint8_t*>(mem) + total_bytes - reinterpret_cast<std::uint8_t*>(top) - header_size;
+            }
+        }
+
+        return 0;
+    }
+
+    // Size of free list node in bytes.
+    static constexpr std::size_t node_size = sizeof(FLNode);
+
+    // Size of the header in front of each block in bytes. Compact blocks only keep their size in it, so
+    //  it is smaller than a node.
+    static constexpr std::size_t header_size = compact ? sizeof(FLNode::value) : node_size;
+
+private:
+
+    // Allocate a number of bytes from the free list, or else from the wilderness. Returns nullptr if
+    //  neither has enough space.
+    void* allocate_block(std::size_t bytes)
+    {
+        void* addr = allocate_from_free_list(bytes);
+
+        if constexpr (wilderness)
+        {
+            if (addr == nullptr && bytes > 0)
+            {
+                addr = allocate_from_wilderness(bytes);
+            }
+        }
+
+        return addr;
+    }
+
+    // Allocate a number of bytes from the start of the wilderness. Like a block on the free list, all of
+    //  the wilderness is allocated when too little would be left over for a node.
+    void* allocate_from_wilderness(std::size_t bytes)
+    {
+        const std::size_t space = wilderness_bytes();
+        if (top == mem + total_bytes || space < bytes)
+        {
+            return nullptr;
+        }
+
+        Stats::record_visit();
+        Stats::record_free_block_removed(space);
+
+        FLNode* node = reinterpret_cast<FLNode*>(top);
+        if constexpr (quick_max > 0 && !compact)
+        {
+            // The wilderness has never been written, so 'prev' is cleared so the block isn't taken for
+            //  one on a quick list.
+            node->prev = nullptr;
+        }
+
+        if (space >= bytes + node_size)
+        {
+            node->value = bytes;
+            top += header_size + bytes;
+            allocated_bytes += bytes + header_size;
+
+            Stats::record_free_block_added(space - bytes - header_size);
+        }
+        else
+        {
+            node->value = space;
+            top = mem + total_bytes;
+            allocated_bytes += space;
+        }
+
+        Stats::record_allocate(node->value, node->value, allocated_bytes);
+        return reinterpret_cast<void*>(node) + header_size;
+    }
+
+    // Merge a block that ends at the start of the wilderness into it, along with the last free block on
+    //  the free list if that ends where the block starts.
+    void free_to_wilderness(FLNode* node)
+    {
+        if (top != mem + total_bytes)
+        {
+            Stats::record_free_block_removed(wilderness_bytes());
+            allocated_bytes -= header_size + node->value;
+        }
+        else
+        {
+            allocated_bytes -= node->value;
+        }
+
+        top = node;
+
+        FLNode* last = fl.tail();
+        if (last != nullptr && reinterpret_cast<void*>(last) + header_size + last->value == top)
+        {
+            Stats::record_free_block_removed(last->value);
+
+            fl.remove_node(last);
+            allocated_bytes -= header_size;
+            top = last;
+        }
+
+        Stats::record_free_block_added(wilderness_bytes());
+    }
+
+    // Returns the end of the blocks that have been allocated from the memory buffer.
+    void* top_of_blocks() const
+    {
+        return wilderness ? top : mem + total_bytes;
+    }
+
+    // Allocate a number of bytes from the first block in the free list that is large enough. Returns
+    //  nullptr if there is no such block.
+    void* allocate_from_free_list(std::size_t bytes)
     {
         if (bytes > 0)
         {
             FLNode* cursor = fl.head();
             while (cursor != nullptr)
             {
+                Stats::record_visit();
+
                 if (cursor->value < bytes)
                 {
                     cursor = cursor->next;
@@ -45,23 +436,32 @@ public:
                 else if (cursor->value >= bytes + node_size)
                 {
                     fl.remove_node(cursor);
-                    allocated_bytes += bytes + node_size;
+                    allocated_bytes += bytes + header_size;
 
                     void* curr_node_addr = reinterpret_cast<void*>(cursor);
-                    FLNode* newnode = reinterpret_cast<FLNode*>(curr_node_addr + bytes + node_size);
-                    newnode->value = cursor->value - bytes - node_size;
+                    FLNode* newnode = reinterpret_cast<FLNode*>(curr_node_addr + bytes + header_size);
+                    newnode->value = cursor->value - bytes - header_size;
                     fl.add_node(newnode);
 
+                    Stats::record_free_block_removed(cursor->value);
+                    Stats::record_free_block_added(newnode->value);
+
                     cursor->value = bytes;
 
-                    return reinterpret_cast<FLNode*>(curr_node_addr + node_size);
+                    Stats::record_allocate(bytes, bytes, allocated_bytes);
+                    return reinterpret_cast<FLNode*>(curr_node_addr + header_size);
                 }
                 else
                 {
-                    cursor->value = bytes;
+                    // Too little is left over for a free block, so the whole block is allocated. The
+                    //  node keeps it's size so the slack is freed with it rather than lost.
+                    Stats::record_free_block_removed(cursor->value);
+
                     fl.remove_node(cursor);
-                    allocated_bytes += bytes;
-                    return reinterpret_cast<FLNode*>(reinterpret_cast<void*>(cursor) + node_size);
+                    allocated_bytes += cursor->value;
+
+                    Stats::record_allocate(cursor->value, cursor->value, allocated_bytes);
+                    return reinterpret_cast<FLNode*>(reinterpret_cast<void*>(cursor) + header_size);
                 }
             }
         }
@@ -69,11 +469,20 @@ public:
         return nullptr;
     }
 
-    // Deallocate a block of memory to free it up for re-allocation.
-    void deallocate(void* addr)
+    // Add a block to the free list, merging it with the free blocks either side of it.
+    void free_block(FLNode* node)
     {
-        void* newnode_addr = addr - node_size;
-        FLNode* node = reinterpret_cast<FLNode*>(newnode_addr);
+        void* newnode_addr = reinterpret_cast<void*>(node);
+
+        if constexpr (wilderness)
+        {
+            if (newnode_addr + header_size + node->value == top)
+            {
+                free_to_wilderness(node);
+                return;
+            }
+        }
+
         fl.add_node(node); // to update prev and next
 
         bool merge_with_prev = false;
@@ -81,79 +490,205 @@ public:
         
         if (node->prev != nullptr)
         {
-            merge_with_prev = (newnode_addr - node->prev->value - node_size == node->prev);
+            merge_with_prev = (newnode_addr - node->prev->value - header_size == node->prev);
         }
 
         if (node->next != nullptr)
         {
-            merge_with_next = newnode_addr + node_size + node->value == node->next;
+            merge_with_next = newnode_addr + header_size + node->value == node->next;
         }
         
         if (merge_with_next && merge_with_prev)
         {
+            Stats::record_free_block_removed(node->prev->value);
+            Stats::record_free_block_removed(node->next->value);
+            Stats::record_free_block_added(node->prev->value + (2*header_size) + node->value + node->next->value);
+
             fl.remove_node(node);
-            node->prev->value += (2*node_size) + node->value + node->next->value;
+            node->prev->value += (2*header_size) + node->value + node->next->value;
             fl.remove_node(node->next);
-            allocated_bytes -= (2*node_size + node->value);
+            allocated_bytes -= (2*header_size + node->value);
         }
         else if (merge_with_next)
         {
+            Stats::record_free_block_removed(node->next->value);
+            Stats::record_free_block_added(node->value + header_size + node->next->value);
+
             FLNode* removed = fl.remove_node(node->next);
-            allocated_bytes -= (node_size + node->value);
-            node->value += node_size + removed->value;
+            allocated_bytes -= (header_size + node->value);
+            node->value += header_size + removed->value;
         }
         else if (merge_with_prev)
         {
+            Stats::record_free_block_removed(node->prev->value);
+            Stats::record_free_block_added(node->prev->value + header_size + node->value);
+
             fl.remove_node(node);
-            node->prev->value += node_size + node->value;
-            allocated_bytes -= (node_size + node->value);
+            node->prev->value += header_size + node->value;
+            allocated_bytes -= (header_size + node->value);
         }
         else
         {
+            Stats::record_free_block_added(node->value);
+
             allocated_bytes -= node->value;
         }
+    }
+
+    // Move every block on the quick lists to the free list, merging it with it's neighbours.
+    void consolidate()
+    {
+        for (std::size_t bytes=1; bytes<=quick_max; bytes++)
+        {
+            while (quick[bytes - 1] != nullptr)
+            {
+                FLNode* node = pop_quick(bytes);
 
+                // free_block() frees the block from allocated_bytes again.
+                Stats::record_free_block_removed(node->value);
+                allocated_bytes += node->value;
+                free_block(node);
+            }
+        }
     }
 
-    // Deallocates all blocks and returns this object to it's initialisation state
-    void reset()
+    // Push a block onto the quick list of it's size, marking it as being on one. The link is 'next', and
+    //  'prev' pointing at the node itself is the mark, which no node on the free list or allocated block
+    //  can have. Compact blocks link forward only, so they keep the offset of the next block from 'mem'
+    //  in their payload instead, and set 'quick_flag' in their size, which is a multiple of 'granularity'.
+    void push_quick(FLNode* node)
     {
-        fl.reset();
-        allocated_bytes = node_size;
-        
-        FLNode* start_node = reinterpret_cast<FLNode*>(mem);
-        start_node->value = total_bytes - node_size;
-        fl.add_node(start_node);
+        FLNode*& head = quick[node->value - 1];
+
+        if constexpr (compact)
+        {
+            const std::uint32_t link = (head == nullptr) ? 0 : static_cast<std::uint32_t>((reinterpret_cast<std::uint8_t*>(head) - reinterpret_cast<std::uint8_t*>(mem)) / granularity + 1);
+            std::memcpy(reinterpret_cast<std::uint8_t*>(node) + header_size, &link, sizeof(link));
+            node->value |= quick_flag;
+        }
+        else
+        {
+            node->next = head;
+            node->prev = node;
+        }
+
+        head = node;
+        quick_count++;
     }
 
-    // Returns number of bytes allocated to memory buffer.
-    std::size_t allocated() const
+    // Pop the most recently freed block of 'bytes' bytes off it's quick list and clear it's mark.
+    FLNode* pop_quick(std::size_t bytes)
     {
-        return allocated_bytes;
+        FLNode* node = quick[bytes - 1];
+        quick[bytes - 1] = quick_next(node);
+
+        if constexpr (compact)
+        {
+            node->value &= ~quick_flag;
+        }
+        else
+        {
+            node->prev = nullptr;
+        }
+
+        quick_count--;
+        return node;
     }
 
-    // Returns size of memory buffer in bytes.
-    std::size_t length() const
+    // Returns the block after 'node' on it's quick list.
+    FLNode* quick_next(const FLNode* node) const
     {
-        return total_bytes;
+        if constexpr (compact)
+        {
+            std::uint32_t link;
+            std::memcpy(&link, reinterpret_cast<const std::uint8_t*>(node) + header_size, sizeof(link));
+            return (link == 0) ? nullptr : reinterpret_cast<FLNode*>(mem + ((link - 1) * granularity));
+        }
+        else
+        {
+            return node->next;
+        }
     }
 
-    // Return free list.
-    FirstFitFreeList free_list() const
+    // Returns true if the block 'node' is on a quick list.
+    bool on_quick_list(const FLNode* node) const
     {
-        return fl;
+        if constexpr (compact)
+        {
+            return (node->value & quick_flag) != 0;
+        }
+        else
+        {
+            return node->prev == node;
+        }
     }
 
-    // Size of free list node in bytes.
-    static const std::size_t node_size = sizeof(FLNode);
+    // Returns the payload of the block that holds 'bytes' bytes. Compact blocks are a multiple of
+    //  'granularity' bytes, and large enough for the node they keep in their payload once freed.
+    static std::size_t block_bytes(std::size_t bytes)
+    {
+        if constexpr (compact)
+        {
+            if (bytes > 0 && bytes <= SIZE_MAX - node_size)
+            {
+                const std::size_t payload = (bytes < node_size - header_size) ? node_size - header_size : bytes;
+                return (payload + granularity - 1) & ~(granularity - 1);
+            }
+        }
 
-private:
+        return bytes;
+    }
+
+    // Returns 'addr' rounded up to 'granularity' when blocks are compact, as their nodes must be aligned
+    //  to it.
+    static void* align_start(void* addr)
+    {
+        if constexpr (compact)
+        {
+            return reinterpret_cast<void*>((reinterpret_cast<std::uintptr_t>(addr) + granularity - 1) & ~static_cast<std::uintptr_t>(granularity - 1));
+        }
+        else
+        {
+            return addr;
+        }
+    }
+
+    // Returns how many of the 'bytes' bytes at 'addr' are used, which for compact blocks start at
+    //  align_start(addr) and are a multiple of 'granularity'.
+    static std::size_t usable_bytes(void* addr, std::size_t bytes)
+    {
+        if constexpr (compact)
+        {
+            const std::size_t skipped = reinterpret_cast<std::uint8_t*>(align_start(addr)) - reinterpret_cast<std::uint8_t*>(addr);
+            return (bytes > skipped) ? (bytes - skipped) & ~(granularity - 1) : 0;
+        }
+        else
+        {
+            return bytes;
+        }
+    }
+
+    // Bit of a compact block's size set while it is on a quick list.
+    static constexpr std::size_t quick_flag = compact ? 1 : 0;
+
+    // Largest memory buffer in bytes that compact block sizes and CompactPointers reach across.
+    static constexpr std::size_t max_compact_bytes = (granularity == 4) ? UINT32_MAX : CompactPointer<FLNode, true, granularity>::max_distance;
 
     // Pointer to memory buffer managed by this object.
     void* mem;
 
+    // Start of the wilderness, or the end of the memory buffer when there is none. Only used when
+    //  'wilderness' is true.
+    void* top;
+
     // Free list to keep track of all unallocated blocks of memory.
-    FirstFitFreeList fl;
+    BasicFirstFitFreeList<compact, granularity> fl;
+
+    // Quick list heads, where quick[i] holds the freed blocks of i+1 bytes.
+    std::array<FLNode*, quick_max> quick;
+
+    // Number of blocks on the quick lists.
+    std::size_t quick_count;
 
     // Number of bytes used in memory buffer.
     std::size_t allocated_bytes;
@@ -161,6 +696,24 @@ private:
     // Length of memory buffer in bytes.
     const std::size_t total_bytes;
 
-}; // class FirstFitMemoryAllocator
+}; // class BasicFirstFitMemoryAllocator
+
+// First fit memory allocator that records no statistics.
+using FirstFitMemoryAllocator = BasicFirstFitMemoryAllocator<NoStats>;
+
+// First fit memory allocator with quick lists for blocks of up to 'quick_max' bytes, that records no
+//  statistics.
+template <std::size_t quick_max>
+using QuickFirstFitMemoryAllocator = BasicFirstFitMemoryAllocator<NoStats, quick_max>;
+
+// First fit memory allocator that bumps blocks off a wilderness, that records no statistics.
+using WildernessFirstFitMemoryAllocator = BasicFirstFitMemoryAllocator<NoStats, 0, true>;
+
+// First fit memory allocator with compact blocks, that records no statistics.
+using CompactFirstFitMemoryAllocator = BasicFirstFitMemoryAllocator<NoStats, 0, false, true>;
+
+// First fit memory allocator with compact blocks of a granularity of 8 bytes, for memory buffers of up
+//  to 32GiB, that records no statistics.
+using LargeCompactFirstFitMemoryAllocator = BasicFirstFitMemoryAllocator<NoStats, 0, false, true, 8>;
 
 #endif // FIRST_FIT_MEMORY_ALLOCATOR_H
\ No newline at end of file
@@ -5,10 +5,20 @@
 #include <cstdint>
 
 #include "../FirstFit/first_fit_free_list.h"
+#include "allocator_stats.h"
+#include "heap_walk.h"
 #include "memory_allocator.h"
-
-// Implementation of a memory allocator that uses the next fit algorithm to allocate memory.
-class NextFitMemoryAllocator : public MemoryAllocator
+#include "static_memory_allocator.h"
+
+// Implementation of a memory allocator that uses the next fit algorithm to allocate memory. 'Stats' is the
+//  statistics policy, see allocator_stats.h.
+//
+// When 'wilderness' is true, the untouched end of the memory buffer is a wilderness that is not on the
+//  free list. Blocks are bumped off the start of it once no block on the free list is large enough, and
+//  freed blocks that border it are merged back into it. No node is written to the memory buffer until it
+//  is first allocated.
+template <class Stats, bool wilderness = false>
+class BasicNextFitMemoryAllocator final : public MemoryAllocator, public StaticMemoryAllocator<BasicNextFitMemoryAllocator<Stats, wilderness>>, private Stats
 {
 public:
 
@@ -17,23 +27,248 @@ public:
 
     // Constructor that takes in a reference to a memory buffer of template type T.
     template <class T>
-    NextFitMemoryAllocator(T& buffer) : 
-        mem(buffer.data()),
-        allocated_bytes(node_size),
-        total_bytes(
-            reinterpret_cast<std::uint8_t*>(buffer.end()) 
-            - reinterpret_cast<std::uint8_t*>(buffer.begin())
+    BasicNextFitMemoryAllocator(T& buffer) :
+        BasicNextFitMemoryAllocator(
+            buffer.data(),
+            reinterpret_cast<std::uint8_t*>(buffer.end()) - reinterpret_cast<std::uint8_t*>(buffer.begin())
             )
     {
-        FLNode* start_node = reinterpret_cast<FLNode*>(mem);
-        start_node->value = total_bytes - node_size;
-        fl.add_node(start_node);
+    }
+
+    // Constructor that takes in the address and size in bytes of a memory region.
+    BasicNextFitMemoryAllocator(void* addr, std::size_t bytes) :
+        mem(addr),
+        top(addr),
+        allocated_bytes(node_size),
+        total_bytes(bytes)
+    {
+        if constexpr (wilderness)
+        {
+            cursor = nullptr;
 
-        cursor = fl.head();
+            Stats::record_reset(total_bytes, allocated_bytes);
+            Stats::record_free_block_added(total_bytes - node_size);
+        }
+        else
+        {
+            FLNode* start_node = reinterpret_cast<FLNode*>(mem);
+            start_node->value = total_bytes - node_size;
+            fl.add_node(start_node);
+
+            cursor = fl.head();
+
+            Stats::record_reset(total_bytes, allocated_bytes);
+            Stats::record_free_block_added(start_node->value);
+        }
     }
 
     // Allocate a number of bytes and return the address of the allocation.
     void* allocate(std::size_t bytes)
+    {
+        void* addr = allocate_from_free_list(bytes);
+
+        if constexpr (wilderness)
+        {
+            if (addr == nullptr && bytes > 0)
+            {
+                addr = allocate_from_wilderness(bytes);
+            }
+        }
+
+        if (addr == nullptr && bytes > 0)
+        {
+            Stats::record_failure();
+        }
+
+        return addr;
+    }
+
+    // Deallocate a block of memory to free it up for re-allocation.
+    void deallocate(void* addr)
+    {
+        FLNode* node = reinterpret_cast<FLNode*>(addr - node_size);
+
+        // Only read when recording statistics, so the load is not kept when they are disabled.
+        const std::size_t payload = Stats::enabled ? node->value : 0;
+
+        if constexpr (wilderness)
+        {
+            if (addr + node->value == top)
+            {
+                free_to_wilderness(node);
+
+                Stats::record_deallocate(payload, payload, allocated_bytes);
+                return;
+            }
+        }
+
+        free_block(node);
+
+        Stats::record_deallocate(payload, payload, allocated_bytes);
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state
+    void reset()
+    {
+        fl.reset();
+        allocated_bytes = node_size;
+
+        if constexpr (wilderness)
+        {
+            top = mem;
+            cursor = nullptr;
+
+            Stats::record_reset(total_bytes, allocated_bytes);
+            Stats::record_free_block_added(total_bytes - node_size);
+        }
+        else
+        {
+            FLNode* start_node = reinterpret_cast<FLNode*>(mem);
+            start_node->value = total_bytes - node_size;
+            fl.add_node(start_node);
+
+            cursor = fl.head();
+
+            Stats::record_reset(total_bytes, allocated_bytes);
+            Stats::record_free_block_added(start_node->value);
+        }
+    }
+
+    // Returns number of bytes allocated to memory buffer.
+    std::size_t allocated() const
+    {
+        return allocated_bytes;
+    }
+
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return total_bytes;
+    }
+
+    // Returns true if 'addr' lies within the memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return addr >= mem && addr < mem + total_bytes;
+    }
+
+    // Call 'visit' with the HeapBlock of each block in the memory buffer, in address order, without
+    //  allocating. Blocks are found by stepping over each node's size, and free blocks by following
+    //  the free list alongside, which is sorted by address. The wilderness is one free block.
+    template <class Visitor>
+    void walk(Visitor&& visit) const
+    {
+        const FLNode* next_free = fl.head();
+
+        for (void* cursor = mem; cursor < (wilderness ? top : mem + total_bytes);)
+        {
+            const FLNode* node = reinterpret_cast<const FLNode*>(cursor);
+            const bool free = (node == next_free);
+            if (free)
+            {
+                next_free = next_free->next;
+            }
+
+            visit(HeapBlock{cursor, node_size + node->value, free, 0});
+            cursor += node_size + node->value;
+        }
+
+        if constexpr (wilderness)
+        {
+            if (top != mem + total_bytes)
+            {
+                visit(HeapBlock{top, static_cast<std::size_t>(reinterpret_cast<std::uint8_t*>(mem) + total_bytes - reinterpret_cast<std::uint8_t*>(top)), true, 0});
+            }
+        }
+    }
+
+    // Returns the statistics recorded by this object.
+    const Stats& stats() const
+    {
+        return *this;
+    }
+
+    // Returns the size of the largest free block in bytes. Needs a statistics policy, which tracks the
+    //  largest free block of each size bucket, so the free list is only searched when the last of the
+    //  largest size has been removed and smaller ones are left in it's bucket.
+    std::size_t largest_free_block() const
+    {
+        static_assert(Stats::enabled, "Fragmentation metrics need a statistics policy");
+
+        if (!Stats::largest_free_known())
+        {
+            std::size_t largest = 0;
+            std::size_t count = 0;
+            const auto visit = [&](std::size_t bytes) {
+                if (bytes > largest)
+                {
+                    largest = bytes;
+                    count = 0;
+                }
+                count += (bytes == largest) ? 1 : 0;
+            };
+
+            for (const FLNode* node = fl.head(); node != nullptr; node = node->next)
+            {
+                visit(node->value);
+            }
+
+            if constexpr (wilderness)
+            {
+                if (top != mem + total_bytes)
+                {
+                    visit(wilderness_bytes());
+                }
+            }
+
+            Stats::record_largest_free(largest, count);
+        }
+
+        return Stats::largest_free();
+    }
+
+    // Returns the external fragmentation index, 1 - (largest free block / free bytes). Needs a
+    //  statistics policy.
+    double external_fragmentation() const
+    {
+        return Stats::external_fragmentation(largest_free_block());
+    }
+
+    // Return free list.
+    FirstFitFreeList free_list() const
+    {
+        return fl;
+    }
+
+    // Returns cursor
+    FLNode* get_cursor() const
+    {
+        return cursor;
+    }
+
+    // Returns the number of free bytes in the wilderness, not counting the node the next block bumped
+    //  off it will need. Returns 0 when there is no wilderness.
+    std::size_t wilderness_bytes() const
+    {
+        if constexpr (wilderness)
+        {
+            if (top != mem + total_bytes)
+            {
+                return reinterpret_cast<std::uint8_t*>(mem) + total_bytes - reinterpret_cast<std::uint8_t*>(top) - node_size;
+            }
+        }
+
+        return 0;
+    }
+
+    // Size of free list node in bytes.
+    static constexpr std::size_t node_size = sizeof(FLNode);
+
+private:
+
+    // Allocate a number of bytes from the next block in the free list, from the cursor on, that is large
+    //  enough. Returns nullptr if there is no such block.
+    void* allocate_from_free_list(std::size_t bytes)
     {
         if (cursor == nullptr)
         {
@@ -45,9 +280,11 @@ public:
         {
             FLNode* node = cursor;
 
-            int i=0;
+            std::size_t i=0;
             while (i < fl.count())
             {
+                Stats::record_visit();
+
                 if (node->value < bytes)
                 {
                     if (node->next == nullptr)
@@ -71,19 +308,33 @@ public:
                     newnode->value = node->value - bytes - node_size;
                     fl.add_node(newnode);
 
+                    Stats::record_free_block_removed(node->value);
+                    Stats::record_free_block_added(newnode->value);
+
                     cursor = newnode;
 
                     node->value = bytes;
-                    
+
+                    Stats::record_allocate(bytes, bytes, allocated_bytes);
                     return reinterpret_cast<FLNode*>(curr_node_addr + node_size);
                 }
                 else
                 {
+                    // Too little is left over for a free block, so the whole block is allocated. The
+                    //  node keeps it's size so the slack is freed with it rather than lost.
+                    Stats::record_free_block_removed(node->value);
+
                     cursor = node->next;
 
-                    node->value = bytes;
                     fl.remove_node(node);
-                    allocated_bytes += bytes;
+                    allocated_bytes += node->value;
+
+                    if (cursor == nullptr)
+                    {
+                        cursor = fl.head();
+                    }
+
+                    Stats::record_allocate(node->value, node->value, allocated_bytes);
                     return reinterpret_cast<FLNode*>(reinterpret_cast<void*>(node) + node_size);
                 }
             }
@@ -92,11 +343,77 @@ public:
         return nullptr;
     }
 
-    // Deallocate a block of memory to free it up for re-allocation.
-    void deallocate(void* addr)
+    // Allocate a number of bytes from the start of the wilderness. Like a block on the free list, all of
+    //  the wilderness is allocated when too little would be left over for a node.
+    void* allocate_from_wilderness(std::size_t bytes)
     {
-        void* newnode_addr = addr - node_size;
-        FLNode* node = reinterpret_cast<FLNode*>(newnode_addr);
+        const std::size_t space = wilderness_bytes();
+        if (top == mem + total_bytes || space < bytes)
+        {
+            return nullptr;
+        }
+
+        Stats::record_visit();
+        Stats::record_free_block_removed(space);
+
+        FLNode* node = reinterpret_cast<FLNode*>(top);
+        if (space >= bytes + node_size)
+        {
+            node->value = bytes;
+            top += node_size + bytes;
+            allocated_bytes += bytes + node_size;
+
+            Stats::record_free_block_added(space - bytes - node_size);
+        }
+        else
+        {
+            node->value = space;
+            top = mem + total_bytes;
+            allocated_bytes += space;
+        }
+
+        Stats::record_allocate(node->value, node->value, allocated_bytes);
+        return reinterpret_cast<void*>(node) + node_size;
+    }
+
+    // Merge a block that ends at the start of the wilderness into it, along with the last free block on
+    //  the free list if that ends where the block starts.
+    void free_to_wilderness(FLNode* node)
+    {
+        if (top != mem + total_bytes)
+        {
+            Stats::record_free_block_removed(wilderness_bytes());
+            allocated_bytes -= node_size + node->value;
+        }
+        else
+        {
+            allocated_bytes -= node->value;
+        }
+
+        top = node;
+
+        FLNode* last = fl.tail();
+        if (last != nullptr && reinterpret_cast<void*>(last) + node_size + last->value == top)
+        {
+            Stats::record_free_block_removed(last->value);
+
+            fl.remove_node(last);
+            allocated_bytes -= node_size;
+            top = last;
+
+            if (cursor == last)
+            {
+                cursor = fl.head();
+            }
+        }
+
+        Stats::record_free_block_added(wilderness_bytes());
+    }
+
+    // Add a block to the free list, merging it with the free blocks either side of it.
+    void free_block(FLNode* node)
+    {
+        void* newnode_addr = reinterpret_cast<void*>(node);
         fl.add_node(node);
 
         bool merge_with_prev = false;
@@ -114,6 +431,10 @@ public:
 
         if (merge_with_next && merge_with_prev)
         {
+            Stats::record_free_block_removed(node->prev->value);
+            Stats::record_free_block_removed(node->next->value);
+            Stats::record_free_block_added(node->prev->value + (2*node_size) + node->value + node->next->value);
+
             if (cursor == node->next)
             {
                 if (node->next->next == nullptr)
@@ -133,6 +454,9 @@ public:
         }
         else if (merge_with_next)
         {
+            Stats::record_free_block_removed(node->next->value);
+            Stats::record_free_block_added(node->value + node_size + node->next->value);
+
             if (cursor == node->next)
             {
                 cursor = node;
@@ -144,12 +468,17 @@ public:
         }
         else if (merge_with_prev)
         {
+            Stats::record_free_block_removed(node->prev->value);
+            Stats::record_free_block_added(node->prev->value + node_size + node->value);
+
             fl.remove_node(node);
             node->prev->value += node_size + node->value;
             allocated_bytes -= (node_size + node->value);
         }
         else
         {
+            Stats::record_free_block_added(node->value);
+
             allocated_bytes -= node->value;
 
             if (fl.count() == 1)
@@ -159,51 +488,13 @@ public:
         }
     }
 
-    // Deallocates all blocks and returns this object to it's initialisation state
-    void reset()
-    {
-        fl.reset();
-        allocated_bytes = node_size;
-        
-        FLNode* start_node = reinterpret_cast<FLNode*>(mem);
-        start_node->value = total_bytes - node_size;
-        fl.add_node(start_node);
-
-        cursor = fl.head();
-    }
-
-    // Returns number of bytes allocated to memory buffer.
-    std::size_t allocated() const
-    {
-        return allocated_bytes;
-    }
-
-    // Returns size of memory buffer in bytes.
-    std::size_t length() const
-    {
-        return total_bytes;
-    }
-
-    // Return free list.
-    FirstFitFreeList free_list() const
-    {
-        return fl;
-    }
-
-    // Returns cursor
-    FLNode* get_cursor() const
-    {
-        return cursor;
-    }
-
-    // Size of free list node in bytes.
-    static const std::size_t node_size = sizeof(FLNode);
-
-private:
-
     // Pointer to memory buffer managed by this object.
     void* mem;
 
+    // Start of the wilderness, or the end of the memory buffer when there is none. Only used when
+    //  'wilderness' is true.
+    void* top;
+
     // Free list to keep track of all unallocated blocks of memory.
     FirstFitFreeList fl;
 
@@ -216,6 +507,12 @@ private:
     // Length of memory buffer in bytes.
     const std::size_t total_bytes;
 
-}; // class NextFitMemoryAllocator
+}; // class BasicNextFitMemoryAllocator
+
+// Next fit memory allocator that records no statistics.
+using NextFitMemoryAllocator = BasicNextFitMemoryAllocator<NoStats>;
+
+// Next fit memory allocator that bumps blocks off a wilderness, that records no statistics.
+using WildernessNextFitMemoryAllocator = BasicNextFitMemoryAllocator<NoStats, true>;
 
 #endif // NEXT_FIT_MEMORY_ALLOCATOR_H
\ No newline at end of file
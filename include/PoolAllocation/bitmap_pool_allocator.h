@@ -0,0 +1,481 @@
+#ifndef BITMAP_POOL_ALLOCATOR_H
+#define BITMAP_POOL_ALLOCATOR_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "allocator_stats.h"
+#include "heap_walk.h"
+#include "memory_allocator.h"
+#include "static_memory_allocator.h"
+
+// Implementation of a memory allocator that allocates blocks of 'block_size' bytes from a pool, like
+//  PoolAllocationMemoryAllocator, but keeps which blocks are free in a bitmap at the start of the memory
+//  buffer instead of a free list. Blocks have no node, and a set bit marks a free block.
+//
+// Every word of the bitmap before the hint is known to have no free blocks, so the lowest free block is
+//  found by scanning on from the hint for a non zero word and counting it's trailing zeros. Built with
+//  AVX2 or AVX-512 enabled, the scan tests 4 or 8 words at a time. Deallocating moves the hint back to
+//  the freed block's word if it is lower. 'Stats' is the statistics policy, see allocator_stats.h. When
+//  it is enabled, the bitmap is followed by a table of the size requested for each block, so the memory
+//  buffer fits fewer blocks.
+template<std::size_t block_size, class Stats = NoStats>
+class BitmapPoolAllocator final : public MemoryAllocator, public StaticMemoryAllocator<BitmapPoolAllocator<block_size, Stats>>, private Stats
+{
+public:
+
+    // Constructor that takes in a reference to a memory buffer of template type T.
+    template <class T>
+    BitmapPoolAllocator(T& buffer) :
+        BitmapPoolAllocator(
+            buffer.data(),
+            reinterpret_cast<std::uint8_t*>(buffer.end()) - reinterpret_cast<std::uint8_t*>(buffer.begin())
+            )
+    {
+    }
+
+    // Constructor that takes in the address and size in bytes of a memory region.
+    BitmapPoolAllocator(void* addr, std::size_t bytes) :
+        mem(addr),
+        total_bytes(bytes),
+        blocks_count(count_blocks(bytes)),
+        words_count(words_for(blocks_count)),
+        bitmap(reinterpret_cast<std::uint64_t*>(addr)),
+        requested_sizes(reinterpret_cast<requested_type*>(addr + (words_count * sizeof(std::uint64_t)))),
+        blocks(reinterpret_cast<void*>(requested_sizes) + table_bytes(blocks_count))
+    {
+        static_assert(block_size > 0, "Blocks must be at least 1 byte");
+        assert(block_size <= total_bytes);
+
+        reset();
+    }
+
+    // Allocate a single block and return the address of the allocation.
+    void* allocate()
+    {
+        return allocate(block_size);
+    }
+
+    // Allocate a number of bytes and return the address of the allocation.
+    void* allocate(std::size_t bytes)
+    {
+        if (bytes > 0 && bytes <= block_size && blocks_allocated < blocks_count)
+        {
+            hint = find_free_word(hint);
+            Stats::record_visit();
+
+            const std::uint64_t word = bitmap[hint];
+            const std::size_t index = (hint * word_bits) + __builtin_ctzll(word);
+            bitmap[hint] = word & (word - 1);
+
+            allocated_bytes += block_size;
+            blocks_allocated++;
+
+            if constexpr (Stats::enabled)
+            {
+                requested_sizes[index] = bytes;
+            }
+
+            Stats::record_free_block_removed(block_size);
+            Stats::record_allocate(bytes, block_size, allocated_bytes);
+            return blocks + (index * block_size);
+        }
+
+        if (bytes > 0)
+        {
+            Stats::record_failure();
+        }
+
+        return nullptr;
+    }
+
+    // Allocate a run of 'n_blocks' blocks in a row and return the address of the first. The run is
+    //  run_bytes(n_blocks) bytes long and is freed with deallocate_run.
+    void* allocate_run(std::size_t n_blocks)
+    {
+        if (n_blocks > 0 && n_blocks <= blocks_count - blocks_allocated)
+        {
+            const std::size_t index = find_free_run(n_blocks);
+            if (index < blocks_count)
+            {
+                mark(index, n_blocks, false);
+
+                allocated_bytes += n_blocks * block_size;
+                blocks_allocated += n_blocks;
+
+                Stats::record_free_block_removed(block_size, n_blocks);
+                Stats::record_allocate(n_blocks * block_size, n_blocks * block_size, allocated_bytes);
+                return blocks + (index * block_size);
+            }
+        }
+
+        if (n_blocks > 0)
+        {
+            Stats::record_failure();
+        }
+
+        return nullptr;
+    }
+
+    // Deallocate a run of 'n_blocks' blocks allocated by allocate_run.
+    void deallocate_run(void* addr, std::size_t n_blocks)
+    {
+        const std::size_t index = static_cast<std::size_t>(reinterpret_cast<std::uint8_t*>(addr) - reinterpret_cast<std::uint8_t*>(blocks)) / block_size;
+
+        mark(index, n_blocks, true);
+        if (index / word_bits < hint)
+        {
+            hint = index / word_bits;
+        }
+
+        allocated_bytes -= n_blocks * block_size;
+        blocks_allocated -= n_blocks;
+
+        Stats::record_free_block_added(block_size, n_blocks);
+        Stats::record_deallocate(n_blocks * block_size, n_blocks * block_size, allocated_bytes);
+    }
+
+    // Deallocate a block of memory to free it up for re-allocation.
+    void deallocate(void* addr)
+    {
+        const std::size_t index = static_cast<std::size_t>(reinterpret_cast<std::uint8_t*>(addr) - reinterpret_cast<std::uint8_t*>(blocks)) / block_size;
+        const std::size_t word = index / word_bits;
+
+        std::size_t requested = 0;
+        if constexpr (Stats::enabled)
+        {
+            requested = requested_sizes[index];
+        }
+
+        bitmap[word] |= std::uint64_t(1) << (index % word_bits);
+        if (word < hint)
+        {
+            hint = word;
+        }
+
+        allocated_bytes -= block_size;
+        blocks_allocated--;
+
+        Stats::record_free_block_added(block_size);
+        Stats::record_deallocate(requested, block_size, allocated_bytes);
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state
+    void reset()
+    {
+        for (std::size_t i=0; i<words_count; i++)
+        {
+            bitmap[i] = ~std::uint64_t(0);
+        }
+
+        // Bits past the last block are never free.
+        if (blocks_count % word_bits != 0)
+        {
+            bitmap[words_count - 1] = (std::uint64_t(1) << (blocks_count % word_bits)) - 1;
+        }
+
+        hint = 0;
+        allocated_bytes = (words_count * sizeof(std::uint64_t)) + table_bytes(blocks_count);
+        blocks_allocated = 0;
+
+        Stats::record_reset(total_bytes, allocated_bytes);
+        Stats::record_free_block_added(block_size, blocks_count);
+    }
+
+    // Returns number of bytes allocated to memory buffer, including the bitmap and table of requested sizes.
+    std::size_t allocated() const
+    {
+        return allocated_bytes;
+    }
+
+    // Returns number of blocks allocated.
+    std::size_t allocated_blocks() const
+    {
+        return blocks_allocated;
+    }
+
+    // Returns total number of blocks in memory buffer.
+    std::size_t total_blocks() const
+    {
+        return blocks_count;
+    }
+
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return total_bytes;
+    }
+
+    // Returns true if 'addr' lies within the memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return addr >= mem && addr < mem + total_bytes;
+    }
+
+    // Returns the length of each block in bytes.
+    static std::size_t block_length()
+    {
+        return block_size;
+    }
+
+    // Returns the number of bytes that can be used in a run of 'n_blocks' blocks.
+    static std::size_t run_bytes(std::size_t n_blocks)
+    {
+        return n_blocks * block_size;
+    }
+
+    // Returns true if the block at 'index' is free.
+    bool is_free(std::size_t index) const
+    {
+        return (bitmap[index / word_bits] >> (index % word_bits)) & 1;
+    }
+
+    // Call 'visit' with the HeapBlock of each block in the memory buffer, in address order, without
+    //  allocating. The bitmap and table of requested sizes before the blocks are left out.
+    template <class Visitor>
+    void walk(Visitor&& visit) const
+    {
+        for (std::size_t i=0; i<blocks_count; i++)
+        {
+            visit(HeapBlock{blocks + (i * block_size), block_size, is_free(i), 0});
+        }
+    }
+
+    // Returns the statistics recorded by this object.
+    const Stats& stats() const
+    {
+        return *this;
+    }
+
+    // Returns the size of the largest free block in bytes.
+    std::size_t largest_free_block() const
+    {
+        return (blocks_allocated < blocks_count) ? block_size : 0;
+    }
+
+    // Returns the external fragmentation index, 1 - (largest free block / free bytes). Needs a
+    //  statistics policy.
+    double external_fragmentation() const
+    {
+        static_assert(Stats::enabled, "Fragmentation metrics need a statistics policy");
+
+        return Stats::external_fragmentation(largest_free_block());
+    }
+
+    // Number of blocks each word of the bitmap holds.
+    static constexpr std::size_t word_bits = 64;
+
+private:
+
+    // Returns the number of bitmap words needed for 'count' blocks.
+    static constexpr std::size_t words_for(std::size_t count)
+    {
+        return (count + word_bits - 1) / word_bits;
+    }
+
+    // Type of each entry in the table of requested sizes, wide enough for any request a block can serve.
+    using requested_type = std::conditional_t<(block_size <= UINT16_MAX), std::uint16_t, std::size_t>;
+
+    // Returns the number of bytes in the table of requested sizes for 'count' blocks, rounded up to a whole
+    //  word so blocks keep the bitmap's alignment. Only kept when recording statistics.
+    static constexpr std::size_t table_bytes(std::size_t count)
+    {
+        if constexpr (Stats::enabled)
+        {
+            return (((count * sizeof(requested_type)) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t)) * sizeof(std::uint64_t);
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    // Returns the number of blocks that fit in 'bytes' bytes along with their bitmap and table of
+    //  requested sizes. Each block needs block_size bytes, 1 bit and it's table entry, but the bitmap and
+    //  table are made of whole words.
+    static std::size_t count_blocks(std::size_t bytes)
+    {
+        std::size_t count = (bytes * 8) / ((block_size * 8) + 1 + (Stats::enabled ? sizeof(requested_type) * 8 : 0));
+        while (count > 0 && (words_for(count) * sizeof(std::uint64_t)) + table_bytes(count) + (count * block_size) > bytes)
+        {
+            count--;
+        }
+
+        return count;
+    }
+
+    // Returns the index of the first block of the lowest run of 'n_blocks' free blocks, or blocks_count
+    //  if there is none. Words with no free blocks are skipped by find_free_word, and words with every
+    //  block free are added to the run whole.
+    std::size_t find_free_run(std::size_t n_blocks)
+    {
+        std::size_t run_start = 0;
+        std::size_t run_length = 0;
+
+        for (std::size_t w = hint; w < words_count; w++)
+        {
+            if (run_length == 0)
+            {
+                w = find_free_word(w);
+                if (w == words_count)
+                {
+                    break;
+                }
+            }
+
+            Stats::record_visit();
+
+            const std::uint64_t word = bitmap[w];
+            if (word == ~std::uint64_t(0))
+            {
+                if (run_length == 0)
+                {
+                    run_start = w * word_bits;
+                }
+
+                run_length += word_bits;
+                if (run_length >= n_blocks)
+                {
+                    return run_start;
+                }
+
+                continue;
+            }
+
+            std::size_t bit = 0;
+            while (bit < word_bits)
+            {
+                const std::uint64_t rest = word >> bit;
+                if (rest == 0)
+                {
+                    run_length = 0;
+                    break;
+                }
+
+                // Allocated blocks end the run.
+                const std::size_t allocated = __builtin_ctzll(rest);
+                if (allocated > 0)
+                {
+                    run_length = 0;
+                    bit += allocated;
+                    continue;
+                }
+
+                // Bits past the end of 'word' shift in as zeros, so ~rest is never 0 here.
+                const std::size_t free = __builtin_ctzll(~rest);
+                if (run_length == 0)
+                {
+                    run_start = (w * word_bits) + bit;
+                }
+
+                run_length += free;
+                if (run_length >= n_blocks)
+                {
+                    return run_start;
+                }
+
+                bit += free;
+            }
+        }
+
+        return blocks_count;
+    }
+
+    // Mark 'count' blocks from the block at 'index' on as free, or as allocated.
+    void mark(std::size_t index, std::size_t count, bool free)
+    {
+        while (count > 0)
+        {
+            const std::size_t bit = index % word_bits;
+            const std::size_t bits = std::min(count, word_bits - bit);
+            const std::uint64_t mask = ((bits == word_bits) ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1) << bit;
+
+            if (free)
+            {
+                bitmap[index / word_bits] |= mask;
+            }
+            else
+            {
+                bitmap[index / word_bits] &= ~mask;
+            }
+
+            index += bits;
+            count -= bits;
+        }
+    }
+
+    // Returns the index of the first word of the bitmap from 'first' on with a free block, or
+    //  words_count if there is none.
+    std::size_t find_free_word(std::size_t first) const
+    {
+        std::size_t i = first;
+
+#if defined(__AVX512F__)
+        for (; i + 8 <= words_count; i += 8)
+        {
+            const __m512i words = _mm512_loadu_si512(bitmap + i);
+            const __mmask8 nonzero = _mm512_test_epi64_mask(words, words);
+            if (nonzero != 0)
+            {
+                return i + __builtin_ctz(nonzero);
+            }
+        }
+#elif defined(__AVX2__)
+        for (; i + 4 <= words_count; i += 4)
+        {
+            const __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bitmap + i));
+            if (!_mm256_testz_si256(words, words))
+            {
+                break;
+            }
+        }
+#endif
+
+        while (i < words_count && bitmap[i] == 0)
+        {
+            i++;
+        }
+
+        return i;
+    }
+
+    // Pointer to memory buffer managed by this object.
+    void* mem;
+
+    // Length of memory buffer in bytes.
+    const std::size_t total_bytes;
+
+    // Total number of blocks in memory buffer.
+    const std::size_t blocks_count;
+
+    // Number of words in the bitmap.
+    const std::size_t words_count;
+
+    // Bitmap of free blocks, at the start of the memory buffer.
+    std::uint64_t* const bitmap;
+
+    // Size requested for each block, after the bitmap. Only kept when recording statistics.
+    requested_type* const requested_sizes;
+
+    // Address of the first block, after the bitmap and table of requested sizes.
+    void* const blocks;
+
+    // Index of the word of the bitmap to start searching from. No word before it has a free block.
+    std::size_t hint;
+
+    // Number of bytes used in memory buffer.
+    std::size_t allocated_bytes;
+
+    // Number of blocks allocated.
+    std::size_t blocks_allocated;
+
+}; // class BitmapPoolAllocator
+
+#endif // BITMAP_POOL_ALLOCATOR_H
@@ -3,9 +3,11 @@
 
 #include <cstddef>
 
+#include "compact_pointer.h"
+
 // Singly linked list data structure with no values stored used for keeping track of free blocks of memory in memory
-//  memory allocator objects.
-template <std::size_t block_size>
+//  memory allocator objects. When 'compact' is true nodes hold a CompactPointer, see compact_pointer.h.
+template <std::size_t block_size, bool compact = false>
 class PoolAllocationFreeList
 {
 public:
@@ -13,7 +15,7 @@ public:
     // Singly linked list node used in free list.
     struct SLLNode
     {
-        SLLNode* next;
+        NodePointer<SLLNode, compact> next;
     };
 
     // Add node to free list after a given node 'prev_node'.
@@ -50,6 +52,20 @@ public:
         }
     }
 
+    // Add 'count' nodes, 'stride' bytes apart from 'new_node' on, to the correct position in free list
+    //  based on memory addresses in ascending order.
+    void add_nodes(SLLNode* new_node, std::size_t count, std::size_t stride)
+    {
+        SLLNode* prev_node = (node_count > 0) ? find_prev(new_node) : nullptr;
+
+        for (std::size_t i=0; i<count; i++)
+        {
+            SLLNode* node = reinterpret_cast<SLLNode*>(reinterpret_cast<void*>(new_node) + (i * stride));
+            add_node(node, prev_node);
+            prev_node = node;
+        }
+    }
+
     // Remove node from free list by updating pointers between adjacent nodes.
     SLLNode* remove_node(SLLNode* node)
     {
@@ -73,6 +89,35 @@ public:
         return node;        
     }
     
+    // Remove 'count' nodes in a row from free list, starting with the node after 'prev_node' or with
+    //  the first node if it is nullptr. Returns the first node removed.
+    SLLNode* remove_nodes(SLLNode* prev_node, std::size_t count)
+    {
+        SLLNode* first = head_node;
+        if (prev_node != nullptr)
+        {
+            first = prev_node->next;
+        }
+
+        SLLNode* last = first;
+        for (std::size_t i=1; i<count; i++)
+        {
+            last = last->next;
+        }
+
+        if (prev_node == nullptr)
+        {
+            head_node = last->next;
+        }
+        else
+        {
+            prev_node->next = last->next;
+        }
+
+        node_count -= count;
+        return first;
+    }
+
     // Reset this free list back to it's initialisation state.
     void reset()
     {
@@ -87,27 +132,27 @@ public:
     }
 
     // Returns the first node in the free list.
-    SLLNode* head()
+    SLLNode* head() const
     {
         return head_node;
     }
 
 private:
 
-    // Returns the node preceding the correct position of 'new_node' based on ascending memory
+    // Returns the node preceding 'new_node', or the correct position of it, based on ascending memory
     //  addresses.
     SLLNode* find_prev(SLLNode* new_node)
     {
         SLLNode* cursor = head_node;
 
-        if (cursor > new_node)
+        if (cursor >= new_node)
         {
             return nullptr;
         }
 
         while (cursor->next != nullptr)
         {
-            if (cursor->next > new_node)
+            if (cursor->next >= new_node)
             {
                 return cursor;
             }
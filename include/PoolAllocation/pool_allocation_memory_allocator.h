@@ -1,33 +1,47 @@
 #ifndef POOL_ALLOCATION_MEMORY_ALLOCATOR_H
 #define POOL_ALLOCATION_MEMORY_ALLOCATOR_H
 
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include "PoolAllocation/pool_allocation_free_list.h"
+#include "allocator_stats.h"
+#include "heap_walk.h"
 #include "memory_allocator.h"
+#include "static_memory_allocator.h"
 
-// Implementation of a memory allocator that uses the pool allocation algorithm to allocate memory.
-template<std::size_t block_size>
-class PoolAllocationMemoryAllocator : public MemoryAllocator
+// Implementation of a memory allocator that uses the pool allocation algorithm to allocate memory. 'Stats' is
+//  the statistics policy, see allocator_stats.h. When 'compact' is true, nodes hold a CompactPointer (see
+//  compact_pointer.h), which makes them 4 bytes rather than 8, and the memory buffer can be at most 4GiB.
+template<std::size_t block_size, class Stats = NoStats, bool compact = false>
+class PoolAllocationMemoryAllocator final : public MemoryAllocator, public StaticMemoryAllocator<PoolAllocationMemoryAllocator<block_size, Stats, compact>>, private Stats
 {
 public:
 
     // Type of free list node
-    using FLNode = typename PoolAllocationFreeList<block_size>::SLLNode;
+    using FLNode = typename PoolAllocationFreeList<block_size, compact>::SLLNode;
 
     // Constructor that takes in a reference to a memory buffer of template type T.
     template <class T>
-    PoolAllocationMemoryAllocator(T& buffer) : 
-        mem(buffer.data()),
+    PoolAllocationMemoryAllocator(T& buffer) :
+        PoolAllocationMemoryAllocator(
+            buffer.data(),
+            reinterpret_cast<std::uint8_t*>(buffer.end()) - reinterpret_cast<std::uint8_t*>(buffer.begin())
+            )
+    {
+    }
+
+    // Constructor that takes in the address and size in bytes of a memory region.
+    PoolAllocationMemoryAllocator(void* addr, std::size_t bytes) :
+        mem(addr),
         allocated_bytes(node_size),
-        total_bytes(
-            reinterpret_cast<std::uint8_t*>(buffer.end()) 
-            - reinterpret_cast<std::uint8_t*>(buffer.begin())
-            ),
+        total_bytes(bytes),
         blocks_count(total_bytes / (node_size + block_size))
     {
         assert(block_size <= total_bytes);
+        assert(!compact || total_bytes <= CompactPointer<FLNode>::max_distance);
 
         void* cursor = mem;
         
@@ -37,7 +51,7 @@ public:
 
         FLNode* prev_node = node;
 
-        while (cursor + node_size + block_size <= buffer.end())
+        while (cursor + node_size + block_size <= mem + total_bytes)
         {
             node = reinterpret_cast<FLNode*>(cursor);
             fl.add_node(node, prev_node);
@@ -46,6 +60,9 @@ public:
             cursor += node_size + block_size;
             allocated_bytes += node_size;
         }
+
+        Stats::record_reset(total_bytes, allocated_bytes);
+        Stats::record_free_block_added(block_size, fl.count());
     }
 
     // Allocate a single block and return the address of the allocation.
@@ -62,21 +79,112 @@ public:
             auto node = fl.remove_node(fl.head());
             allocated_bytes += block_size;
             blocks_allocated++;
+
+            if constexpr (Stats::enabled)
+            {
+                // The node of an allocated block is unused, so it holds the requested size. It's copied
+                //  rather than written through another type.
+                const NodeSize<compact> size = bytes;
+                std::memcpy(reinterpret_cast<void*>(node), &size, sizeof(size));
+            }
+
+            Stats::record_free_block_removed(block_size);
+            Stats::record_allocate(bytes, block_size, allocated_bytes);
             return reinterpret_cast<FLNode*>(reinterpret_cast<void*>(node) + node_size);
         }
 
+        if (bytes > 0)
+        {
+            Stats::record_failure();
+        }
+
+        return nullptr;
+    }
+
+    // Allocate a run of 'n_blocks' blocks in a row and return the address of the first. The run is
+    //  run_bytes(n_blocks) bytes long, covering the nodes of all but the first block, and is freed with
+    //  deallocate_run.
+    void* allocate_run(std::size_t n_blocks)
+    {
+        if (n_blocks > 0 && n_blocks <= fl.count())
+        {
+            // The free list is sorted by address, so a run is 'n_blocks' nodes in a row of it that are
+            //  each directly after the one before.
+            FLNode* prev = nullptr;
+            FLNode* first = fl.head();
+            FLNode* last = first;
+            std::size_t length = 1;
+
+            while (length < n_blocks && last->next != nullptr)
+            {
+                Stats::record_visit();
+
+                FLNode* next = last->next;
+                if (reinterpret_cast<void*>(next) == reinterpret_cast<void*>(last) + node_size + block_size)
+                {
+                    length++;
+                }
+                else
+                {
+                    prev = last;
+                    first = next;
+                    length = 1;
+                }
+
+                last = next;
+            }
+
+            if (length == n_blocks)
+            {
+                fl.remove_nodes(prev, n_blocks);
+                allocated_bytes += n_blocks * block_size;
+                blocks_allocated += n_blocks;
+
+                Stats::record_free_block_removed(block_size, n_blocks);
+                Stats::record_allocate(n_blocks * block_size, n_blocks * block_size, allocated_bytes);
+                return reinterpret_cast<void*>(first) + node_size;
+            }
+        }
+
+        if (n_blocks > 0)
+        {
+            Stats::record_failure();
+        }
+
         return nullptr;
     }
 
+    // Deallocate a run of 'n_blocks' blocks allocated by allocate_run.
+    void deallocate_run(void* addr, std::size_t n_blocks)
+    {
+        fl.add_nodes(reinterpret_cast<FLNode*>(addr - node_size), n_blocks, node_size + block_size);
+
+        allocated_bytes -= n_blocks * block_size;
+        blocks_allocated -= n_blocks;
+
+        Stats::record_free_block_added(block_size, n_blocks);
+        Stats::record_deallocate(n_blocks * block_size, n_blocks * block_size, allocated_bytes);
+    }
+
     // Deallocate a block of memory to free it up for re-allocation.
     void deallocate(void* addr)
     {
         void* newnode_addr = addr - node_size;
         FLNode* node = reinterpret_cast<FLNode*>(newnode_addr);
+
+        NodeSize<compact> requested = 0;
+        if constexpr (Stats::enabled)
+        {
+            std::memcpy(&requested, reinterpret_cast<const void*>(node), sizeof(requested));
+        }
+
         fl.add_node(node);
 
         allocated_bytes -= block_size;
         blocks_allocated--;
+
+        Stats::record_free_block_added(block_size);
+        Stats::record_deallocate(requested, block_size, allocated_bytes);
     }
 
     // Deallocates all blocks and returns this object to it's initialisation state
@@ -103,6 +211,9 @@ public:
             cursor += node_size + block_size;
             allocated_bytes += node_size;
         }
+
+        Stats::record_reset(total_bytes, allocated_bytes);
+        Stats::record_free_block_added(block_size, fl.count());
     }
 
     // Returns number of bytes allocated to memory buffer.
@@ -129,14 +240,69 @@ public:
         return total_bytes;
     }
 
+    // Returns true if 'addr' lies within the memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return addr >= mem && addr < mem + total_bytes;
+    }
+
     // Returns the length of each block in bytes.
     static std::size_t block_length()
     {
         return block_size;
     }
 
+    // Returns the number of bytes that can be used in a run of 'n_blocks' blocks.
+    static std::size_t run_bytes(std::size_t n_blocks)
+    {
+        return (n_blocks * block_size) + ((n_blocks - 1) * node_size);
+    }
+
+    // Call 'visit' with the HeapBlock of each block in the memory buffer, in address order, without
+    //  allocating. Free blocks are found by following the free list alongside, which is sorted by
+    //  address.
+    template <class Visitor>
+    void walk(Visitor&& visit) const
+    {
+        const FLNode* next_free = fl.head();
+
+        void* cursor = mem;
+        for (std::size_t i=0; i<blocks_count; i++)
+        {
+            const bool free = (reinterpret_cast<const FLNode*>(cursor) == next_free);
+            if (free)
+            {
+                next_free = next_free->next;
+            }
+
+            visit(HeapBlock{cursor, node_size + block_size, free, 0});
+            cursor += node_size + block_size;
+        }
+    }
+
+    // Returns the statistics recorded by this object.
+    const Stats& stats() const
+    {
+        return *this;
+    }
+
+    // Returns the size of the largest free block in bytes.
+    std::size_t largest_free_block() const
+    {
+        return (fl.count() > 0) ? block_size : 0;
+    }
+
+    // Returns the external fragmentation index, 1 - (largest free block / free bytes). Needs a
+    //  statistics policy.
+    double external_fragmentation() const
+    {
+        static_assert(Stats::enabled, "Fragmentation metrics need a statistics policy");
+
+        return Stats::external_fragmentation(largest_free_block());
+    }
+
     // Return free list.
-    PoolAllocationFreeList<block_size> free_list() const
+    PoolAllocationFreeList<block_size, compact> free_list() const
     {
         return fl;
     }
@@ -150,7 +316,7 @@ private:
     void* mem;
 
     // Free list to keep track of all unallocated blocks of memory.
-    PoolAllocationFreeList<block_size> fl;
+    PoolAllocationFreeList<block_size, compact> fl;
 
     // Number of bytes used in memory buffer.
     std::size_t allocated_bytes;
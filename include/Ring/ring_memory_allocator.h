@@ -0,0 +1,178 @@
+#ifndef RING_MEMORY_ALLOCATOR_H
+#define RING_MEMORY_ALLOCATOR_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "memory_allocator.h"
+#include "static_memory_allocator.h"
+
+// Implementation of a memory allocator for blocks freed in roughly the order they were allocated. Blocks
+//  are allocated at the head of a ring buffer and reclaimed from the tail. A block that does not fit
+//  before the end of the memory buffer is moved to the start instead of being split, and the gap left
+//  behind is reclaimed along with it. A block freed before the tail reaches it is only marked free, and
+//  is reclaimed once every block allocated before it has been freed.
+//
+//  With 'spsc' set, one thread can allocate while another deallocates without a lock, as the head is
+//  only written by the allocating thread and the tail only by the deallocating thread.
+template<std::size_t alignment = 8, bool spsc = false>
+class RingMemoryAllocator final : public MemoryAllocator, public StaticMemoryAllocator<RingMemoryAllocator<alignment, spsc>>
+{
+public:
+
+    static_assert(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of 2");
+
+    // Header at the start of every record in the ring buffer.
+    struct Header
+    {
+        // Length of the record in bytes, including header and padding.
+        std::uint32_t length;
+
+        // Non zero once the block has been deallocated.
+        std::uint32_t free;
+    };
+
+    // Size of record header in bytes, rounded up to keep blocks aligned.
+    static constexpr std::size_t header_size = ((sizeof(Header) + alignment - 1) / alignment) * alignment;
+
+    // Constructor that takes in a reference to a memory buffer of template type T.
+    template <class T>
+    RingMemoryAllocator(T& buffer) :
+        RingMemoryAllocator(
+            buffer.data(),
+            reinterpret_cast<std::uint8_t*>(buffer.end()) - reinterpret_cast<std::uint8_t*>(buffer.begin())
+            )
+    {
+    }
+
+    // Constructor that takes in the address and size in bytes of a memory region.
+    RingMemoryAllocator(void* addr, std::size_t bytes) :
+        mem(reinterpret_cast<std::uint8_t*>(addr)),
+        total_bytes(bytes),
+        capacity((total_bytes / header_size) * header_size)
+    {
+        assert((reinterpret_cast<std::uintptr_t>(mem) & (alignment - 1)) == 0);
+    }
+
+    // Allocate a number of bytes at the head of the ring buffer and return the address of the allocation.
+    void* allocate(std::size_t bytes)
+    {
+        if (bytes == 0 || bytes > capacity)
+        {
+            return nullptr;
+        }
+
+        const std::size_t record = ((header_size + bytes + header_size - 1) / header_size) * header_size;
+        if (record > capacity)
+        {
+            return nullptr;
+        }
+
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        const std::size_t t = tail.load(acquire);
+
+        const std::size_t offset = h % capacity;
+        const std::size_t gap = (offset + record > capacity) ? capacity - offset : 0;
+        if ((h - t) + gap + record > capacity)
+        {
+            return nullptr;
+        }
+
+        if (gap != 0)
+        {
+            *reinterpret_cast<Header*>(mem + offset) = Header{static_cast<std::uint32_t>(gap), 1};
+        }
+
+        std::uint8_t* rec = mem + ((offset + gap) % capacity);
+        *reinterpret_cast<Header*>(rec) = Header{static_cast<std::uint32_t>(record), 0};
+
+        head.store(h + gap + record, release);
+
+        return rec + header_size;
+    }
+
+    // Deallocate a block of memory to free it up for re-allocation. The memory is only reused once every
+    //  block allocated before it has also been deallocated.
+    void deallocate(void* addr)
+    {
+        assert(owns(addr));
+
+        reinterpret_cast<Header*>(reinterpret_cast<std::uint8_t*>(addr) - header_size)->free = 1;
+
+        reclaim();
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state. Must not be called
+    //  while another thread is allocating or deallocating.
+    void reset()
+    {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+    // Returns number of bytes between the tail and the head of the ring buffer, including headers,
+    //  padding, gaps left by wrapping and blocks waiting to be reclaimed.
+    std::size_t allocated() const
+    {
+        return head.load(acquire) - tail.load(acquire);
+    }
+
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return total_bytes;
+    }
+
+    // Returns true if 'addr' lies within the memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return addr >= mem && addr < mem + total_bytes;
+    }
+
+private:
+
+    // Memory orders used to publish the head and tail, which only need to synchronise in spsc mode.
+    static constexpr std::memory_order acquire = spsc ? std::memory_order_acquire : std::memory_order_relaxed;
+    static constexpr std::memory_order release = spsc ? std::memory_order_release : std::memory_order_relaxed;
+
+    // Advance the tail past every freed record at the tail of the ring buffer.
+    void reclaim()
+    {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        const std::size_t h = head.load(acquire);
+
+        while (t != h)
+        {
+            const Header* header = reinterpret_cast<const Header*>(mem + (t % capacity));
+            if (header->free == 0)
+            {
+                break;
+            }
+
+            t += header->length;
+        }
+
+        tail.store(t, release);
+    }
+
+    // Pointer to memory buffer managed by this object.
+    std::uint8_t* const mem;
+
+    // Length of memory buffer in bytes.
+    const std::size_t total_bytes;
+
+    // Length of the ring buffer in bytes. Records and the ring buffer are whole multiples of the header
+    //  size, so a gap left by wrapping always has room for a header.
+    const std::size_t capacity;
+
+    // Total number of bytes ever allocated at the head and reclaimed from the tail. Their offsets in the
+    //  ring buffer are these modulo it's capacity. Each is on it's own cache line so the allocating and
+    //  deallocating threads don't share one in spsc mode.
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+
+}; // class RingMemoryAllocator
+
+#endif // RING_MEMORY_ALLOCATOR_H
@@ -0,0 +1,464 @@
+#ifndef SLAB_MEMORY_ALLOCATOR_H
+#define SLAB_MEMORY_ALLOCATOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "allocator_stats.h"
+#include "memory_allocator.h"
+#include "static_memory_allocator.h"
+
+// Table of size classes used by the slab memory allocator, spaced 4 to a doubling above 64 bytes, and
+//  a lookup table mapping a request to it's size class.
+struct SlabSizeClasses
+{
+    // Number of size classes.
+    static constexpr std::size_t count = 29;
+
+    // Largest number of bytes in a size class.
+    static constexpr std::size_t max_bytes = 4096;
+
+    // Length of the blocks of each size class in bytes.
+    static constexpr std::array<std::size_t, count> sizes = {
+        8, 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512,
+        640, 768, 896, 1024, 1280, 1536, 1792, 2048, 2560, 3072, 3584, 4096
+    };
+
+    // Builds the table mapping a request, rounded up to a multiple of 8 bytes, to it's size class.
+    static constexpr std::array<std::uint8_t, (max_bytes / 8) + 1> make_lookup()
+    {
+        std::array<std::uint8_t, (max_bytes / 8) + 1> table{};
+
+        std::size_t size_class = 0;
+        for (std::size_t i=0; i<table.size(); i++)
+        {
+            while (sizes[size_class] < i*8)
+            {
+                size_class++;
+            }
+
+            table[i] = size_class;
+        }
+
+        return table;
+    }
+
+    // Returns the size class of a request of 'bytes' bytes, where 0 < 'bytes' <= 'max_bytes'.
+    static constexpr std::size_t class_of(std::size_t bytes)
+    {
+        return lookup[(bytes + 7) / 8];
+    }
+
+    // Table mapping a request, rounded up to a multiple of 8 bytes, to it's size class.
+    static const std::array<std::uint8_t, (max_bytes / 8) + 1> lookup;
+
+}; // struct SlabSizeClasses
+
+inline constexpr std::array<std::uint8_t, (SlabSizeClasses::max_bytes / 8) + 1> SlabSizeClasses::lookup = SlabSizeClasses::make_lookup();
+
+// Implementation of a memory allocator that serves requests of up to 4096 bytes from a table of size
+//  classes. The memory buffer is carved into fixed size slabs on demand, each slab acting as a pool of
+//  blocks of one size class. Empty slabs are returned to the memory buffer for reuse by any size class.
+//  'Stats' is the statistics policy, see allocator_stats.h. When it is enabled, each slab's header is
+//  followed by a table of the size requested for each of it's blocks, so they fit fewer blocks.
+template<std::size_t slab_size = 16384, class Stats = NoStats>
+class SlabMemoryAllocator final : public MemoryAllocator, public StaticMemoryAllocator<SlabMemoryAllocator<slab_size, Stats>>, private Stats
+{
+public:
+
+    // Number of size classes.
+    static constexpr std::size_t size_class_count = SlabSizeClasses::count;
+
+    // Largest number of bytes that can be allocated.
+    static constexpr std::size_t max_bytes = SlabSizeClasses::max_bytes;
+
+    static_assert(slab_size >= 2*max_bytes, "Slab must fit at least 1 block of the largest size class");
+
+    // Header at the start of every slab in use.
+    struct SlabHeader
+    {
+        // Previous and next slabs in the list of slabs with free blocks of the same size class, or
+        //  next slab in the list of empty slabs.
+        SlabHeader* prev;
+        SlabHeader* next;
+
+        // Singly linked list of blocks deallocated in this slab.
+        void* free_head;
+
+        // Size class of the blocks in this slab.
+        std::uint32_t size_class;
+
+        // Number of blocks allocated in this slab.
+        std::uint32_t used;
+
+        // Number of blocks handed out from the untouched end of this slab.
+        std::uint32_t carved;
+
+        // Number of blocks that fit in this slab.
+        std::uint32_t capacity;
+    };
+
+    // Size of slab header in bytes, rounded up to keep blocks 16 byte aligned.
+    static constexpr std::size_t header_size = ((sizeof(SlabHeader) + 15) / 16) * 16;
+
+    // Constructor that takes in a reference to a memory buffer of template type T.
+    template <class T>
+    SlabMemoryAllocator(T& buffer) :
+        SlabMemoryAllocator(
+            buffer.data(),
+            reinterpret_cast<std::uint8_t*>(buffer.end()) - reinterpret_cast<std::uint8_t*>(buffer.begin())
+            )
+    {
+    }
+
+    // Constructor that takes in the address and size in bytes of a memory region.
+    SlabMemoryAllocator(void* addr, std::size_t bytes) :
+        mem(addr),
+        total_bytes(bytes),
+        slabs_count(total_bytes / slab_size)
+    {
+        reset();
+    }
+
+    // Allocate a number of bytes and return the address of the allocation.
+    void* allocate(std::size_t bytes)
+    {
+        if (bytes == 0 || bytes > max_bytes)
+        {
+            if (bytes > 0)
+            {
+                Stats::record_failure();
+            }
+
+            return nullptr;
+        }
+
+        const std::size_t size_class = SlabSizeClasses::class_of(bytes);
+
+        SlabHeader* slab = partial[size_class];
+        if (slab == nullptr)
+        {
+            slab = new_slab(size_class);
+            if (slab == nullptr)
+            {
+                Stats::record_failure();
+                return nullptr;
+            }
+        }
+
+        void* addr;
+        if (slab->free_head != nullptr)
+        {
+            addr = slab->free_head;
+            slab->free_head = *reinterpret_cast<void**>(addr);
+        }
+        else
+        {
+            addr = reinterpret_cast<void*>(slab) + blocks_offset(size_class) + (slab->carved * SlabSizeClasses::sizes[size_class]);
+            slab->carved++;
+        }
+
+        slab->used++;
+        if (slab->used == slab->capacity)
+        {
+            remove_partial(slab);
+        }
+
+        allocated_bytes += SlabSizeClasses::sizes[size_class];
+
+        if constexpr (Stats::enabled)
+        {
+            requested_sizes(slab)[block_index(slab, addr)] = bytes;
+        }
+
+        Stats::record_free_block_removed(SlabSizeClasses::sizes[size_class]);
+        Stats::record_allocate(bytes, SlabSizeClasses::sizes[size_class], allocated_bytes);
+        return addr;
+    }
+
+    // Deallocate a block of memory to free it up for re-allocation.
+    void deallocate(void* addr)
+    {
+        SlabHeader* slab = slab_of(addr);
+
+        std::size_t requested = 0;
+        if constexpr (Stats::enabled)
+        {
+            requested = requested_sizes(slab)[block_index(slab, addr)];
+        }
+
+        *reinterpret_cast<void**>(addr) = slab->free_head;
+        slab->free_head = addr;
+
+        if (slab->used == slab->capacity)
+        {
+            add_partial(slab);
+        }
+
+        slab->used--;
+        allocated_bytes -= SlabSizeClasses::sizes[slab->size_class];
+
+        Stats::record_free_block_added(SlabSizeClasses::sizes[slab->size_class]);
+
+        if (slab->used == 0)
+        {
+            remove_partial(slab);
+
+            slab->next = free_slabs;
+            free_slabs = slab;
+            free_slabs_count++;
+
+            allocated_bytes -= blocks_offset(slab->size_class);
+
+            Stats::record_free_block_removed(SlabSizeClasses::sizes[slab->size_class], slab->capacity);
+            Stats::record_free_block_added(slab_size);
+        }
+
+        Stats::record_deallocate(requested, SlabSizeClasses::sizes[slab->size_class], allocated_bytes);
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state
+    void reset()
+    {
+        partial.fill(nullptr);
+        free_slabs = nullptr;
+        free_slabs_count = 0;
+        carved_slabs = 0;
+        allocated_bytes = 0;
+
+        Stats::record_reset(total_bytes, allocated_bytes);
+        Stats::record_free_block_added(slab_size, slabs_count);
+    }
+
+    // Returns number of bytes allocated to memory buffer.
+    std::size_t allocated() const
+    {
+        return allocated_bytes;
+    }
+
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return total_bytes;
+    }
+
+    // Returns true if 'addr' lies within the memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return addr >= mem && addr < mem + total_bytes;
+    }
+
+    // Returns the statistics recorded by this object.
+    const Stats& stats() const
+    {
+        return *this;
+    }
+
+    // Returns the size of the largest free block in bytes, counting an unused slab as one free block.
+    std::size_t largest_free_block() const
+    {
+        if (unused_slabs() > 0)
+        {
+            return slab_size;
+        }
+
+        for (std::size_t size_class=size_class_count; size_class>0; size_class--)
+        {
+            if (partial[size_class-1] != nullptr)
+            {
+                return SlabSizeClasses::sizes[size_class-1];
+            }
+        }
+
+        return 0;
+    }
+
+    // Returns the external fragmentation index, 1 - (largest free block / free bytes). Needs a
+    //  statistics policy.
+    double external_fragmentation() const
+    {
+        static_assert(Stats::enabled, "Fragmentation metrics need a statistics policy");
+
+        return Stats::external_fragmentation(largest_free_block());
+    }
+
+    // Returns total number of slabs in memory buffer.
+    std::size_t total_slabs() const
+    {
+        return slabs_count;
+    }
+
+    // Returns number of slabs not used by any size class.
+    std::size_t unused_slabs() const
+    {
+        return free_slabs_count + (slabs_count - carved_slabs);
+    }
+
+    // Returns the length of each slab in bytes.
+    static constexpr std::size_t slab_length()
+    {
+        return slab_size;
+    }
+
+    // Returns the size class that a request of 'bytes' bytes is served from.
+    static constexpr std::size_t class_of(std::size_t bytes)
+    {
+        return SlabSizeClasses::class_of(bytes);
+    }
+
+    // Returns the length of the blocks of size class 'size_class' in bytes.
+    static constexpr std::size_t class_length(std::size_t size_class)
+    {
+        return SlabSizeClasses::sizes[size_class];
+    }
+
+private:
+
+    // Take an empty slab, either one that has been returned or an untouched one, and set it up for
+    //  blocks of size class 'size_class'. Returns nullptr if every slab is in use.
+    SlabHeader* new_slab(std::size_t size_class)
+    {
+        SlabHeader* slab;
+        if (free_slabs != nullptr)
+        {
+            slab = free_slabs;
+            free_slabs = slab->next;
+            free_slabs_count--;
+        }
+        else if (carved_slabs < slabs_count)
+        {
+            slab = reinterpret_cast<SlabHeader*>(mem + (carved_slabs * slab_size));
+            carved_slabs++;
+        }
+        else
+        {
+            return nullptr;
+        }
+
+        slab->free_head = nullptr;
+        slab->size_class = size_class;
+        slab->used = 0;
+        slab->carved = 0;
+        slab->capacity = capacity_of(size_class);
+
+        add_partial(slab);
+        allocated_bytes += blocks_offset(size_class);
+
+        Stats::record_free_block_removed(slab_size);
+        Stats::record_free_block_added(SlabSizeClasses::sizes[size_class], slab->capacity);
+
+        return slab;
+    }
+
+    // Returns the number of blocks of size class 'size_class' that fit in a slab. When recording
+    //  statistics each block also needs an entry in the table of requested sizes, and the table is
+    //  rounded up to keep blocks 16 byte aligned.
+    static constexpr std::size_t capacity_of(std::size_t size_class)
+    {
+        if constexpr (Stats::enabled)
+        {
+            return (slab_size - header_size - 15) / (SlabSizeClasses::sizes[size_class] + sizeof(std::uint16_t));
+        }
+        else
+        {
+            return (slab_size - header_size) / SlabSizeClasses::sizes[size_class];
+        }
+    }
+
+    // Returns the offset in bytes of the first block of a slab of size class 'size_class', after it's
+    //  header and table of requested sizes.
+    static constexpr std::size_t blocks_offset(std::size_t size_class)
+    {
+        if constexpr (Stats::enabled)
+        {
+            return header_size + ((((capacity_of(size_class) * sizeof(std::uint16_t)) + 15) / 16) * 16);
+        }
+        else
+        {
+            return header_size;
+        }
+    }
+
+    // Returns the table of the size requested for each block of 'slab', after it's header. Only kept
+    //  when recording statistics.
+    static std::uint16_t* requested_sizes(SlabHeader* slab)
+    {
+        return reinterpret_cast<std::uint16_t*>(reinterpret_cast<std::uint8_t*>(slab) + header_size);
+    }
+
+    // Returns the index of the block at 'addr' in 'slab'.
+    static std::size_t block_index(SlabHeader* slab, void* addr)
+    {
+        const std::size_t offset = reinterpret_cast<std::uint8_t*>(addr) - reinterpret_cast<std::uint8_t*>(slab);
+        return (offset - blocks_offset(slab->size_class)) / SlabSizeClasses::sizes[slab->size_class];
+    }
+
+    // Returns the header of the slab containing 'addr'.
+    SlabHeader* slab_of(void* addr) const
+    {
+        std::size_t offset = reinterpret_cast<std::uint8_t*>(addr) - reinterpret_cast<std::uint8_t*>(mem);
+        return reinterpret_cast<SlabHeader*>(mem + (offset - (offset % slab_size)));
+    }
+
+    // Add 'slab' to the front of the list of slabs with free blocks of it's size class.
+    void add_partial(SlabHeader* slab)
+    {
+        SlabHeader*& head = partial[slab->size_class];
+
+        slab->prev = nullptr;
+        slab->next = head;
+        if (head != nullptr)
+        {
+            head->prev = slab;
+        }
+
+        head = slab;
+    }
+
+    // Remove 'slab' from the list of slabs with free blocks of it's size class.
+    void remove_partial(SlabHeader* slab)
+    {
+        if (slab->prev == nullptr)
+        {
+            partial[slab->size_class] = slab->next;
+        }
+        else
+        {
+            slab->prev->next = slab->next;
+        }
+
+        if (slab->next != nullptr)
+        {
+            slab->next->prev = slab->prev;
+        }
+    }
+
+    // Pointer to memory buffer managed by this object.
+    void* mem;
+
+    // Length of memory buffer in bytes.
+    const std::size_t total_bytes;
+
+    // Total number of slabs in memory buffer.
+    const std::size_t slabs_count;
+
+    // Number of slabs carved from the start of the memory buffer so far.
+    std::size_t carved_slabs = 0;
+
+    // List of slabs with free blocks for each size class.
+    std::array<SlabHeader*, size_class_count> partial;
+
+    // List of empty slabs returned to the memory buffer.
+    SlabHeader* free_slabs = nullptr;
+
+    // Number of slabs in the list of empty slabs.
+    std::size_t free_slabs_count = 0;
+
+    // Number of bytes used in memory buffer, including slab headers and the rounding of requests up
+    //  to their size class.
+    std::size_t allocated_bytes = 0;
+
+}; // class SlabMemoryAllocator
+
+#endif // SLAB_MEMORY_ALLOCATOR_H
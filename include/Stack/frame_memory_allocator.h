@@ -0,0 +1,196 @@
+#ifndef FRAME_MEMORY_ALLOCATOR_H
+#define FRAME_MEMORY_ALLOCATOR_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "memory_allocator.h"
+#include "static_memory_allocator.h"
+
+// Implementation of a double ended stack allocator. Short lived blocks are pushed down from the top of
+//  the memory buffer and persistent blocks are pushed up from the bottom, so the two share one buffer
+//  without fragmenting it. Each end is freed in the reverse order to which it was allocated, and every
+//  short lived block can be freed at once by end_frame. Each block has a 4 byte header just before it
+//  holding the offset of it's end of the stack before it was allocated, so buffers are limited to 4GiB.
+template<std::size_t alignment = alignof(std::max_align_t)>
+class FrameMemoryAllocator final : public MemoryAllocator, public StaticMemoryAllocator<FrameMemoryAllocator<alignment>>
+{
+public:
+
+    static_assert(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of 2");
+
+    // Header stored just before every block.
+    using Header = std::uint32_t;
+
+    // Constructor that takes in a reference to a memory buffer of template type T.
+    template <class T>
+    FrameMemoryAllocator(T& buffer) :
+        FrameMemoryAllocator(
+            buffer.data(),
+            reinterpret_cast<std::uint8_t*>(buffer.end()) - reinterpret_cast<std::uint8_t*>(buffer.begin())
+            )
+    {
+    }
+
+    // Constructor that takes in the address and size in bytes of a memory region.
+    FrameMemoryAllocator(void* addr, std::size_t bytes) :
+        mem(reinterpret_cast<std::uint8_t*>(addr)),
+        total_bytes(bytes),
+        top(total_bytes)
+    {
+        assert(total_bytes <= UINT32_MAX);
+    }
+
+    // Allocate a number of bytes for the current frame from the top of the memory buffer and return the
+    //  address of the allocation.
+    void* allocate(std::size_t bytes)
+    {
+        if (bytes == 0 || bytes > top - bottom)
+        {
+            return nullptr;
+        }
+
+        std::uint8_t* addr = align_down(mem + top - bytes);
+        if (addr < mem + bottom + header_size)
+        {
+            return nullptr;
+        }
+
+        write_header(addr, top);
+        top = (addr - header_size) - mem;
+
+        return addr;
+    }
+
+    // Allocate a number of bytes that outlive the current frame from the bottom of the memory buffer and
+    //  return the address of the allocation.
+    void* allocate_persistent(std::size_t bytes)
+    {
+        if (bytes == 0)
+        {
+            return nullptr;
+        }
+
+        std::size_t padding = pad(mem + bottom + header_size);
+        const std::size_t space = top - bottom;
+        if (padding + header_size > space || bytes > space - padding - header_size)
+        {
+            return nullptr;
+        }
+
+        std::uint8_t* addr = mem + bottom + padding + header_size;
+        write_header(addr, bottom);
+        bottom += padding + header_size + bytes;
+
+        return addr;
+    }
+
+    // Deallocate the last block allocated from the same end of the memory buffer as 'addr'. Blocks from
+    //  each end must be deallocated in the reverse order to which they were allocated.
+    void deallocate(void* addr)
+    {
+        assert(owns(addr));
+
+        if (addr >= mem + top)
+        {
+            top = read_header(addr);
+        }
+        else
+        {
+            bottom = read_header(addr);
+        }
+    }
+
+    // Deallocate every block allocated for the current frame.
+    void end_frame()
+    {
+        top = total_bytes;
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state
+    void reset()
+    {
+        bottom = 0;
+        top = total_bytes;
+    }
+
+    // Returns number of bytes allocated to memory buffer, including headers and alignment padding.
+    std::size_t allocated() const
+    {
+        return bottom + (total_bytes - top);
+    }
+
+    // Returns number of bytes allocated for the current frame.
+    std::size_t frame_allocated() const
+    {
+        return total_bytes - top;
+    }
+
+    // Returns number of bytes allocated for persistent blocks.
+    std::size_t persistent_allocated() const
+    {
+        return bottom;
+    }
+
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return total_bytes;
+    }
+
+    // Returns true if 'addr' lies within the memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return addr >= mem && addr < mem + total_bytes;
+    }
+
+    // Size of block header in bytes.
+    static const std::size_t header_size = sizeof(Header);
+
+private:
+
+    // Write the header of the block at 'addr'. Headers are only aligned if 'alignment' is at least their
+    //  size, so they are copied rather than accessed in place.
+    static void write_header(std::uint8_t* addr, std::size_t offset)
+    {
+        const Header header = static_cast<Header>(offset);
+        std::memcpy(addr - header_size, &header, header_size);
+    }
+
+    // Returns the offset held in the header of the block at 'addr'.
+    static std::size_t read_header(const void* addr)
+    {
+        Header header;
+        std::memcpy(&header, reinterpret_cast<const std::uint8_t*>(addr) - header_size, header_size);
+        return header;
+    }
+
+    // Returns number of bytes needed after 'addr' to align it.
+    static std::size_t pad(const std::uint8_t* addr)
+    {
+        return (alignment - (reinterpret_cast<std::uintptr_t>(addr) & (alignment - 1))) & (alignment - 1);
+    }
+
+    // Returns 'addr' rounded down to a multiple of alignment.
+    static std::uint8_t* align_down(std::uint8_t* addr)
+    {
+        return addr - (reinterpret_cast<std::uintptr_t>(addr) & (alignment - 1));
+    }
+
+    // Pointer to memory buffer managed by this object.
+    std::uint8_t* const mem;
+
+    // Length of memory buffer in bytes.
+    const std::size_t total_bytes;
+
+    // Offset of the top of the persistent stack, which grows up from the start of the memory buffer.
+    std::size_t bottom = 0;
+
+    // Offset of the bottom of the frame stack, which grows down from the end of the memory buffer.
+    std::size_t top;
+
+}; // class FrameMemoryAllocator
+
+#endif // FRAME_MEMORY_ALLOCATOR_H
@@ -0,0 +1,136 @@
+#ifndef STACK_MEMORY_ALLOCATOR_H
+#define STACK_MEMORY_ALLOCATOR_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "memory_allocator.h"
+#include "static_memory_allocator.h"
+
+// Implementation of a memory allocator that allocates by pushing blocks onto the top of a stack and
+//  frees them by popping in the reverse order. Each block has a 4 byte header just before it holding
+//  the offset of the top of the stack before it was allocated, so buffers are limited to 4GiB.
+template<std::size_t alignment = alignof(std::max_align_t)>
+class StackMemoryAllocator final : public MemoryAllocator, public StaticMemoryAllocator<StackMemoryAllocator<alignment>>
+{
+public:
+
+    static_assert(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of 2");
+
+    // Header stored just before every block.
+    using Header = std::uint32_t;
+
+    // Constructor that takes in a reference to a memory buffer of template type T.
+    template <class T>
+    StackMemoryAllocator(T& buffer) :
+        StackMemoryAllocator(
+            buffer.data(),
+            reinterpret_cast<std::uint8_t*>(buffer.end()) - reinterpret_cast<std::uint8_t*>(buffer.begin())
+            )
+    {
+    }
+
+    // Constructor that takes in the address and size in bytes of a memory region.
+    StackMemoryAllocator(void* addr, std::size_t bytes) :
+        mem(reinterpret_cast<std::uint8_t*>(addr)),
+        total_bytes(bytes)
+    {
+        assert(total_bytes <= UINT32_MAX);
+    }
+
+    // Allocate a number of bytes on the top of the stack and return the address of the allocation.
+    void* allocate(std::size_t bytes)
+    {
+        if (bytes == 0)
+        {
+            return nullptr;
+        }
+
+        std::size_t padding = pad(mem + top + header_size);
+        const std::size_t space = total_bytes - top;
+        if (padding + header_size > space || bytes > space - padding - header_size)
+        {
+            return nullptr;
+        }
+
+        std::uint8_t* addr = mem + top + padding + header_size;
+        write_header(addr, top);
+        top += padding + header_size + bytes;
+
+        return addr;
+    }
+
+    // Deallocate the block on the top of the stack. Blocks must be deallocated in the reverse order to
+    //  which they were allocated.
+    void deallocate(void* addr)
+    {
+        assert(addr >= mem && addr < mem + top);
+
+        top = read_header(addr);
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state
+    void reset()
+    {
+        top = 0;
+    }
+
+    // Returns number of bytes allocated to memory buffer, including headers and alignment padding.
+    std::size_t allocated() const
+    {
+        return top;
+    }
+
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return total_bytes;
+    }
+
+    // Returns true if 'addr' lies within the memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return addr >= mem && addr < mem + total_bytes;
+    }
+
+    // Size of block header in bytes.
+    static const std::size_t header_size = sizeof(Header);
+
+private:
+
+    // Write the header of the block at 'addr'. Headers are only aligned if 'alignment' is at least their
+    //  size, so they are copied rather than accessed in place.
+    static void write_header(std::uint8_t* addr, std::size_t offset)
+    {
+        const Header header = static_cast<Header>(offset);
+        std::memcpy(addr - header_size, &header, header_size);
+    }
+
+    // Returns the offset held in the header of the block at 'addr'.
+    static std::size_t read_header(const void* addr)
+    {
+        Header header;
+        std::memcpy(&header, reinterpret_cast<const std::uint8_t*>(addr) - header_size, header_size);
+        return header;
+    }
+
+    // Returns number of bytes needed after 'addr' to align it.
+    static std::size_t pad(const std::uint8_t* addr)
+    {
+        return (alignment - (reinterpret_cast<std::uintptr_t>(addr) & (alignment - 1))) & (alignment - 1);
+    }
+
+    // Pointer to memory buffer managed by this object.
+    std::uint8_t* const mem;
+
+    // Length of memory buffer in bytes.
+    const std::size_t total_bytes;
+
+    // Offset of the top of the stack from the start of the memory buffer.
+    std::size_t top = 0;
+
+}; // class StackMemoryAllocator
+
+#endif // STACK_MEMORY_ALLOCATOR_H
@@ -0,0 +1,153 @@
+#ifndef ALLOCATION_TRACE_H
+#define ALLOCATION_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Type of event in an allocation trace.
+enum class TraceOp : std::uint8_t
+{
+    allocate = 0,
+    deallocate = 1,
+    reallocate = 2
+};
+
+// Event in an allocation trace. Blocks are identified by an id given to them when they are first
+//  allocated, so a trace can be replayed against any allocator. 'size' is unused for deallocate.
+struct TraceEvent
+{
+    TraceOp op;
+    std::uint32_t id;
+    std::uint64_t size;
+
+    bool operator==(const TraceEvent& other) const
+    {
+        return op == other.op && id == other.id && size == other.size;
+    }
+};
+
+// Reading and writing allocation traces in a compact binary format. A trace is the 4 bytes "MATR", a
+//  version byte, and then each event as it's op byte followed by it's id and (except for deallocate)
+//  it's size, as unsigned LEB128 variable length integers. Most events take 3 to 5 bytes.
+class AllocationTrace
+{
+public:
+
+    // Version of the format written.
+    static constexpr std::uint8_t version = 1;
+
+    // Write 'events' to the file at 'path'. Returns false if the file could not be written.
+    static bool write(const std::string& path, const std::vector<TraceEvent>& events)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return false;
+        }
+
+        std::vector<std::uint8_t> bytes = {'M', 'A', 'T', 'R', version};
+        bytes.reserve(5 + (events.size() * 5));
+
+        for (const TraceEvent& event : events)
+        {
+            bytes.push_back(static_cast<std::uint8_t>(event.op));
+            write_varint(bytes, event.id);
+            if (event.op != TraceOp::deallocate)
+            {
+                write_varint(bytes, event.size);
+            }
+        }
+
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return static_cast<bool>(file);
+    }
+
+    // Read the trace in the file at 'path' into 'events'. Returns false if the file could not be read
+    //  or is not a valid trace.
+    static bool read(const std::string& path, std::vector<TraceEvent>& events)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (bytes.size() < 5 || bytes[0] != 'M' || bytes[1] != 'A' || bytes[2] != 'T' || bytes[3] != 'R' || bytes[4] != version)
+        {
+            return false;
+        }
+
+        events.clear();
+
+        std::size_t pos = 5;
+        while (pos < bytes.size())
+        {
+            TraceEvent event{static_cast<TraceOp>(bytes[pos++]), 0, 0};
+            if (event.op > TraceOp::reallocate)
+            {
+                return false;
+            }
+
+            std::uint64_t id;
+            if (!read_varint(bytes, pos, id) || id > UINT32_MAX)
+            {
+                return false;
+            }
+            event.id = static_cast<std::uint32_t>(id);
+
+            if (event.op != TraceOp::deallocate && !read_varint(bytes, pos, event.size))
+            {
+                return false;
+            }
+
+            events.push_back(event);
+        }
+
+        return true;
+    }
+
+    // Append 'value' to 'bytes' as an unsigned LEB128 integer.
+    static void write_varint(std::vector<std::uint8_t>& bytes, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+
+        bytes.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    // Read an unsigned LEB128 integer from 'bytes' at 'pos' into 'value' and move 'pos' past it.
+    //  Returns false if it runs past the end of 'bytes' or does not fit in 64 bits.
+    static bool read_varint(const std::vector<std::uint8_t>& bytes, std::size_t& pos, std::uint64_t& value)
+    {
+        value = 0;
+        for (unsigned int shift=0; pos < bytes.size() && shift < 64; shift += 7)
+        {
+            const std::uint8_t byte = bytes[pos++];
+
+            // Only the lowest bit of the 10th byte is left to fill.
+            if (shift == 63 && (byte & 0x7e) != 0)
+            {
+                return false;
+            }
+
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+}; // class AllocationTrace
+
+#endif // ALLOCATION_TRACE_H
@@ -0,0 +1,387 @@
+#ifndef HEAP_SNAPSHOT_H
+#define HEAP_SNAPSHOT_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Trace/allocation_trace.h"
+#include "heap_walk.h"
+
+// Block of a heap snapshot, at an offset from the start of the memory buffer.
+struct SnapshotBlock
+{
+    std::uint64_t offset;
+    std::uint64_t bytes;
+    bool free;
+    std::uint8_t level;
+
+    bool operator==(const SnapshotBlock& other) const
+    {
+        return offset == other.offset && bytes == other.bytes && free == other.free && level == other.level;
+    }
+};
+
+// Layout of the memory buffer of an allocator at one point in time, taken by walking it's blocks.
+struct HeapSnapshot
+{
+    // Name of the snapshot, such as the allocator and when it was taken. Must not contain a comma.
+    std::string label;
+
+    // Bytes from the start of the first block to the end of the last.
+    std::uint64_t length = 0;
+
+    std::vector<SnapshotBlock> blocks;
+
+    // Take a snapshot of 'alloc', which must have a walk() method (see heap_walk.h). Offsets are from
+    //  the first block, which is at the start of the memory buffer.
+    template <class Alloc>
+    static HeapSnapshot take(const Alloc& alloc, const std::string& label)
+    {
+        HeapSnapshot snapshot;
+        snapshot.label = label;
+
+        const void* first = nullptr;
+        alloc.walk([&](const HeapBlock& block) {
+            if (first == nullptr)
+            {
+                first = block.addr;
+            }
+
+            const std::uint64_t offset = static_cast<const std::uint8_t*>(block.addr) - static_cast<const std::uint8_t*>(first);
+            snapshot.blocks.push_back({offset, block.bytes, block.free, static_cast<std::uint8_t>(block.level)});
+            snapshot.length = offset + block.bytes;
+        });
+
+        return snapshot;
+    }
+};
+
+// Format of a heap snapshot file.
+enum class SnapshotFormat
+{
+    // A header line and then a line for each block of each snapshot:
+    //  label,length,offset,bytes,free,level
+    csv,
+
+    // The 4 bytes "MAHS" and a version byte, and then each snapshot as it's label (length and
+    //  characters), it's length and it's number of blocks, followed by each block as the gap since the
+    //  end of the previous block, it's size, and a byte holding it's level shifted left by 1 and
+    //  whether it's free in the lowest bit. Numbers are unsigned LEB128 variable length integers, so
+    //  most blocks take 3 bytes.
+    binary
+};
+
+// Writes snapshots of allocators to a file as they are taken, such as at intervals during a benchmark.
+class HeapSnapshotWriter
+{
+public:
+
+    // Version of the binary format written.
+    static constexpr std::uint8_t version = 1;
+
+    // Constructor that takes in the path of the file to write and the format to write it in.
+    HeapSnapshotWriter(const std::string& path, SnapshotFormat format) :
+        file(path, std::ios::binary | std::ios::trunc),
+        format(format)
+    {
+        if (format == SnapshotFormat::csv)
+        {
+            file << "label,length,offset,bytes,free,level\n";
+        }
+        else
+        {
+            const char magic[] = {'M', 'A', 'H', 'S', static_cast<char>(version)};
+            file.write(magic, sizeof(magic));
+        }
+    }
+
+    // Returns true if every snapshot so far was written.
+    bool good() const
+    {
+        return static_cast<bool>(file);
+    }
+
+    // Walk 'alloc' and write a snapshot of it named 'label'. The allocator is walked once first to find
+    //  the length and number of blocks, which the binary format writes before the blocks.
+    template <class Alloc>
+    void write(const Alloc& alloc, const std::string& label)
+    {
+        const void* first = nullptr;
+        std::uint64_t end = 0;
+        std::size_t count = 0;
+
+        alloc.walk([&](const HeapBlock& block) {
+            if (first == nullptr)
+            {
+                first = block.addr;
+            }
+            end = static_cast<const std::uint8_t*>(block.addr) - static_cast<const std::uint8_t*>(first) + block.bytes;
+            count++;
+        });
+
+        bytes.clear();
+
+        if (format == SnapshotFormat::binary)
+        {
+            AllocationTrace::write_varint(bytes, label.size());
+            bytes.insert(bytes.end(), label.begin(), label.end());
+            AllocationTrace::write_varint(bytes, end);
+            AllocationTrace::write_varint(bytes, count);
+        }
+
+        std::uint64_t previous_end = 0;
+        alloc.walk([&](const HeapBlock& block) {
+            const std::uint64_t offset = static_cast<const std::uint8_t*>(block.addr) - static_cast<const std::uint8_t*>(first);
+
+            if (format == SnapshotFormat::csv)
+            {
+                file << label << "," << end << "," << offset << "," << block.bytes << "," << block.free << "," << block.level << "\n";
+            }
+            else
+            {
+                AllocationTrace::write_varint(bytes, offset - previous_end);
+                AllocationTrace::write_varint(bytes, block.bytes);
+                bytes.push_back(static_cast<std::uint8_t>((block.level << 1) | (block.free ? 1 : 0)));
+            }
+
+            previous_end = offset + block.bytes;
+        });
+
+        if (format == SnapshotFormat::binary)
+        {
+            file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        }
+        file.flush();
+    }
+
+    // Read every snapshot in the file at 'path', written in either format, into 'snapshots'. Returns
+    //  false if the file could not be read or is not valid.
+    static bool read(const std::string& path, std::vector<HeapSnapshot>& snapshots)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        snapshots.clear();
+
+        if (bytes.size() >= 5 && bytes[0] == 'M' && bytes[1] == 'A' && bytes[2] == 'H' && bytes[3] == 'S')
+        {
+            return bytes[4] == version && read_binary(bytes, snapshots);
+        }
+
+        return read_csv(std::string(bytes.begin(), bytes.end()), snapshots);
+    }
+
+private:
+
+    // Read snapshots in the binary format from 'bytes'.
+    static bool read_binary(const std::vector<std::uint8_t>& bytes, std::vector<HeapSnapshot>& snapshots)
+    {
+        std::size_t pos = 5;
+        while (pos < bytes.size())
+        {
+            HeapSnapshot snapshot;
+
+            std::uint64_t label_size, count;
+            if (!AllocationTrace::read_varint(bytes, pos, label_size) || label_size > bytes.size() - pos)
+            {
+                return false;
+            }
+            snapshot.label.assign(bytes.begin() + pos, bytes.begin() + pos + label_size);
+            pos += label_size;
+
+            if (!AllocationTrace::read_varint(bytes, pos, snapshot.length) || !AllocationTrace::read_varint(bytes, pos, count))
+            {
+                return false;
+            }
+
+            std::uint64_t offset = 0;
+            for (std::uint64_t i=0; i<count; i++)
+            {
+                std::uint64_t gap, size;
+                if (!AllocationTrace::read_varint(bytes, pos, gap) || !AllocationTrace::read_varint(bytes, pos, size) || pos >= bytes.size())
+                {
+                    return false;
+                }
+
+                const std::uint8_t flags = bytes[pos++];
+                offset += gap;
+                snapshot.blocks.push_back({offset, size, (flags & 1) != 0, static_cast<std::uint8_t>(flags >> 1)});
+                offset += size;
+            }
+
+            snapshots.push_back(std::move(snapshot));
+        }
+
+        return true;
+    }
+
+    // Read snapshots in the CSV format from 'text'. Consecutive lines with the same label belong to the
+    //  same snapshot.
+    static bool read_csv(const std::string& text, std::vector<HeapSnapshot>& snapshots)
+    {
+        std::istringstream lines(text);
+        std::string line;
+        if (!std::getline(lines, line) || line != "label,length,offset,bytes,free,level")
+        {
+            return false;
+        }
+
+        while (std::getline(lines, line))
+        {
+            const std::size_t comma = line.find(',');
+            if (comma == std::string::npos)
+            {
+                return false;
+            }
+
+            const std::string label = line.substr(0, comma);
+            std::istringstream fields(line.substr(comma + 1));
+
+            std::uint64_t length, offset, size;
+            unsigned int free, level;
+            char c1, c2, c3, c4;
+            if (!(fields >> length >> c1 >> offset >> c2 >> size >> c3 >> free >> c4 >> level))
+            {
+                return false;
+            }
+
+            if (snapshots.empty() || snapshots.back().label != label)
+            {
+                snapshots.push_back(HeapSnapshot{label, length, {}});
+            }
+            snapshots.back().blocks.push_back({offset, size, free != 0, static_cast<std::uint8_t>(level)});
+        }
+
+        return true;
+    }
+
+    std::ofstream file;
+    const SnapshotFormat format;
+
+    // Binary snapshot being written, kept so it's storage is reused.
+    std::vector<std::uint8_t> bytes;
+
+}; // class HeapSnapshotWriter
+
+// Renders a heap snapshot as a heat strip, an image in which the memory buffer runs left to right and
+//  then top to bottom, one row after another. Each pixel covers an equal range of bytes and is coloured
+//  from blue when free to red when allocated, so pixels over a mix of small free and allocated blocks
+//  take a colour in between and fragmented regions stand out. Bytes not in any block are black.
+class HeapMapRenderer
+{
+public:
+
+    // Constructor that takes in the size of the image in pixels.
+    HeapMapRenderer(std::size_t width, std::size_t height) :
+        width(std::max<std::size_t>(width, 1)),
+        height(std::max<std::size_t>(height, 1))
+    {
+    }
+
+    // Write 'snapshot' to 'out' as a binary PPM image.
+    void render_ppm(const HeapSnapshot& snapshot, std::ostream& out) const
+    {
+        const std::vector<Colour> pixels = colour(snapshot);
+
+        out << "P6\n" << width << " " << height << "\n255\n";
+        for (const Colour& c : pixels)
+        {
+            out.write(reinterpret_cast<const char*>(c.data()), c.size());
+        }
+    }
+
+    // Write 'snapshot' to 'out' as an SVG image, with each run of pixels of one colour in a row drawn
+    //  as one rectangle.
+    void render_svg(const HeapSnapshot& snapshot, std::ostream& out) const
+    {
+        const std::vector<Colour> pixels = colour(snapshot);
+
+        out << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width << "\" height=\"" << height << "\" shape-rendering=\"crispEdges\">\n";
+        out << "<title>" << snapshot.label << "</title>\n";
+        for (std::size_t y=0; y<height; y++)
+        {
+            for (std::size_t x=0; x<width;)
+            {
+                const Colour& c = pixels[y*width + x];
+                std::size_t run = 1;
+                while (x + run < width && pixels[y*width + x + run] == c)
+                {
+                    run++;
+                }
+
+                out << "<rect x=\"" << x << "\" y=\"" << y << "\" width=\"" << run << "\" height=\"1\" fill=\"rgb(";
+                out << static_cast<int>(c[0]) << "," << static_cast<int>(c[1]) << "," << static_cast<int>(c[2]) << ")\"/>\n";
+                x += run;
+            }
+        }
+        out << "</svg>\n";
+    }
+
+private:
+
+    using Colour = std::array<std::uint8_t, 3>;
+
+    // Returns the colour of each pixel of 'snapshot', row by row.
+    std::vector<Colour> colour(const HeapSnapshot& snapshot) const
+    {
+        const std::size_t pixels = width * height;
+        const double bytes_per_pixel = std::max(1.0, static_cast<double>(snapshot.length) / pixels);
+
+        // Bytes of each pixel that are in a block, and that are in an allocated block.
+        std::vector<double> covered(pixels, 0.0);
+        std::vector<double> used(pixels, 0.0);
+
+        for (const SnapshotBlock& block : snapshot.blocks)
+        {
+            const double first = block.offset / bytes_per_pixel;
+            const double last = (block.offset + block.bytes) / bytes_per_pixel;
+
+            for (std::size_t p = static_cast<std::size_t>(first); p < pixels && p < last; p++)
+            {
+                const double overlap = (std::min(last, p + 1.0) - std::max(first, static_cast<double>(p))) * bytes_per_pixel;
+                covered[p] += overlap;
+                if (!block.free)
+                {
+                    used[p] += overlap;
+                }
+            }
+        }
+
+        const Colour free_colour = {30, 60, 170};
+        const Colour used_colour = {220, 50, 30};
+
+        std::vector<Colour> colours(pixels, Colour{0, 0, 0});
+        for (std::size_t p=0; p<pixels; p++)
+        {
+            if (covered[p] > 0)
+            {
+                const double u = used[p] / covered[p];
+                for (std::size_t i=0; i<3; i++)
+                {
+                    colours[p][i] = static_cast<std::uint8_t>(free_colour[i] + u * (used_colour[i] - free_colour[i]) + 0.5);
+                }
+            }
+        }
+
+        return colours;
+    }
+
+    // Size of the image in pixels.
+    const std::size_t width;
+    const std::size_t height;
+
+}; // class HeapMapRenderer
+
+#endif // HEAP_SNAPSHOT_H
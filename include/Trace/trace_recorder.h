@@ -0,0 +1,154 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Trace/allocation_trace.h"
+#include "static_memory_allocator.h"
+
+// Allocator that forwards every call to allocator 'Alloc' and records it as an allocation trace that can
+//  be written with AllocationTrace and replayed. 'Alloc' can be a reference, e.g. MemoryAllocator&, to
+//  record an allocator that already exists.
+template <class Alloc>
+class TraceRecorder : public StaticMemoryAllocator<TraceRecorder<Alloc>>
+{
+public:
+
+    // Constructor that forwards all of it's arguments to the constructor of the recorded allocator.
+    template <class... Args>
+    TraceRecorder(Args&&... args) :
+        alloc(std::forward<Args>(args)...)
+    {
+    }
+
+    // Allocate a number of bytes and return the address of the allocation. Failed allocations are
+    //  recorded too, so a replay makes the same request.
+    void* allocate(std::size_t bytes)
+    {
+        void* addr = alloc.allocate(bytes);
+
+        const std::uint32_t id = next_id++;
+        trace.push_back(TraceEvent{TraceOp::allocate, id, bytes});
+
+        if (addr != nullptr)
+        {
+            blocks[addr] = Block{id, bytes};
+        }
+
+        return addr;
+    }
+
+    // Deallocate a block of memory to free it up for re-allocation.
+    void deallocate(void* addr)
+    {
+        auto block = blocks.find(addr);
+        if (block != blocks.end())
+        {
+            trace.push_back(TraceEvent{TraceOp::deallocate, block->second.id, 0});
+            blocks.erase(block);
+        }
+
+        alloc.deallocate(addr);
+    }
+
+    // Resize the block at 'addr' to 'bytes' by allocating a new block, copying the contents and
+    //  deallocating the old block, and return the address of the new block. If the allocation fails
+    //  nullptr is returned and the old block is left as it was.
+    void* reallocate(void* addr, std::size_t bytes)
+    {
+        auto block = blocks.find(addr);
+        if (block == blocks.end())
+        {
+            return allocate(bytes);
+        }
+
+        const Block old = block->second;
+        trace.push_back(TraceEvent{TraceOp::reallocate, old.id, bytes});
+
+        void* new_addr = alloc.allocate(bytes);
+        if (new_addr == nullptr)
+        {
+            return nullptr;
+        }
+
+        std::memcpy(new_addr, addr, std::min(old.size, bytes));
+        blocks.erase(block);
+        alloc.deallocate(addr);
+        blocks[new_addr] = Block{old.id, bytes};
+
+        return new_addr;
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state. Live blocks are
+    //  recorded as deallocated.
+    void reset()
+    {
+        for (const auto& block : blocks)
+        {
+            trace.push_back(TraceEvent{TraceOp::deallocate, block.second.id, 0});
+        }
+
+        blocks.clear();
+        alloc.reset();
+    }
+
+    // Returns number of bytes allocated to memory buffer.
+    std::size_t allocated() const
+    {
+        return alloc.allocated();
+    }
+
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return alloc.length();
+    }
+
+    // Returns true if 'addr' lies within the memory buffer managed by this object.
+    bool owns(void* addr) const
+    {
+        return alloc.owns(addr);
+    }
+
+    // Returns the events recorded so far.
+    const std::vector<TraceEvent>& events() const
+    {
+        return trace;
+    }
+
+    // Returns the recorded allocator.
+    Alloc& get()
+    {
+        return alloc;
+    }
+
+private:
+
+    // Id and size of a live block.
+    struct Block
+    {
+        std::uint32_t id;
+        std::size_t size;
+    };
+
+    // Allocator that all calls are forwarded to.
+    Alloc alloc;
+
+    // Events recorded so far.
+    std::vector<TraceEvent> trace;
+
+    // Id and size of every live block, by address.
+    std::unordered_map<void*, Block> blocks;
+
+    // Id given to the next allocation.
+    std::uint32_t next_id = 0;
+
+}; // class TraceRecorder
+
+#endif // TRACE_RECORDER_H
@@ -0,0 +1,234 @@
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Trace/allocation_trace.h"
+
+// Type trait that is true if 'T' reports it's external fragmentation, i.e. has an enabled statistics
+//  policy.
+template <class T, class = void>
+struct has_external_fragmentation : std::false_type {};
+
+template <class T>
+struct has_external_fragmentation<T, std::void_t<
+    decltype(std::declval<const T&>().stats()),
+    decltype(double{std::declval<const T&>().external_fragmentation()})
+    >> : std::bool_constant<std::decay_t<decltype(std::declval<const T&>().stats())>::enabled> {};
+
+// Point in a replay at which the state of the allocator was sampled.
+struct ReplaySample
+{
+    // Index of the event the sample was taken after.
+    std::size_t event;
+
+    // Bytes allocated by the allocator.
+    std::size_t allocated;
+
+    // External fragmentation index of the allocator, or 0 if it does not report it.
+    double fragmentation;
+};
+
+// Results of replaying an allocation trace.
+struct ReplayResult
+{
+    // Number of events replayed.
+    std::size_t events = 0;
+
+    // Time taken to replay every event in seconds.
+    double seconds = 0;
+
+    // Time taken by each event in nanoseconds, sorted, if the replay was timed.
+    std::vector<std::uint64_t> latencies;
+
+    // Largest value of allocated() during the replay.
+    std::size_t peak_allocated = 0;
+
+    // Index of every allocate or reallocate event that failed.
+    std::vector<std::size_t> failures;
+
+    // State of the allocator sampled at intervals through the replay.
+    std::vector<ReplaySample> samples;
+
+    // Returns number of events replayed per second.
+    double throughput() const
+    {
+        return (seconds > 0) ? events / seconds : 0;
+    }
+
+    // Returns the latency that fraction 'p' of events took no longer than in nanoseconds.
+    std::uint64_t latency_percentile(double p) const
+    {
+        if (latencies.empty())
+        {
+            return 0;
+        }
+
+        return latencies[std::min(static_cast<std::size_t>(p * latencies.size()), latencies.size() - 1)];
+    }
+};
+
+// Replays allocation traces against an allocator. Blocks are held in a table with a slot for each
+//  distinct id in the trace, found for every event before replay starts, so replay does no allocation
+//  of it's own once started and the table's size does not depend on how large the ids are. The
+//  allocator is reset
+//  first, so replaying the same trace against the same allocator always makes the same calls in
+//  the same order and ends in the same state.
+class TraceReplay
+{
+public:
+
+    // Replay 'events' against 'alloc', sampling it's state every 'sample_interval' events and after
+    //  the last event. If 'timed' is set the latency of every event is measured.
+    template <class Alloc>
+    static ReplayResult replay(Alloc& alloc, const std::vector<TraceEvent>& events, std::size_t sample_interval = 1024, bool timed = true)
+    {
+        ReplayResult result;
+        result.events = events.size();
+
+        // Map each id to a dense slot in the order of the sorted ids.
+        std::vector<std::uint32_t> ids(events.size());
+        for (std::size_t i=0; i<events.size(); i++)
+        {
+            ids[i] = events[i].id;
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+        std::vector<std::size_t> slots(events.size());
+        for (std::size_t i=0; i<events.size(); i++)
+        {
+            slots[i] = std::lower_bound(ids.begin(), ids.end(), events[i].id) - ids.begin();
+        }
+        std::vector<Block> blocks(ids.size(), Block{nullptr, 0});
+
+        if (timed)
+        {
+            result.latencies.reserve(events.size());
+        }
+        if (sample_interval > 0)
+        {
+            result.samples.reserve(events.size() / sample_interval + 1);
+        }
+
+        alloc.reset();
+
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i=0; i<events.size(); i++)
+        {
+            if (timed)
+            {
+                const auto event_start = std::chrono::steady_clock::now();
+                const bool ok = apply(alloc, events[i], blocks[slots[i]]);
+                const auto event_end = std::chrono::steady_clock::now();
+
+                result.latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(event_end - event_start).count());
+                if (!ok)
+                {
+                    result.failures.push_back(i);
+                }
+            }
+            else if (!apply(alloc, events[i], blocks[slots[i]]))
+            {
+                result.failures.push_back(i);
+            }
+
+            result.peak_allocated = std::max(result.peak_allocated, static_cast<std::size_t>(alloc.allocated()));
+
+            if (sample_interval > 0 && ((i + 1) % sample_interval == 0 || i + 1 == events.size()))
+            {
+                result.samples.push_back(sample(alloc, i));
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        result.seconds = std::chrono::duration<double>(end - start).count();
+        std::sort(result.latencies.begin(), result.latencies.end());
+
+        for (const Block& block : blocks)
+        {
+            if (block.addr != nullptr)
+            {
+                alloc.deallocate(block.addr);
+            }
+        }
+
+        return result;
+    }
+
+private:
+
+    // Address and size of a block allocated during a replay.
+    struct Block
+    {
+        void* addr;
+        std::size_t size;
+    };
+
+    // Apply 'event' to 'alloc', where 'block' is the slot for it's id. Returns false if it was an
+    //  allocation that failed. A failed reallocation leaves the old block as it was, and deallocating a
+    //  block that failed to allocate does nothing.
+    template <class Alloc>
+    static bool apply(Alloc& alloc, const TraceEvent& event, Block& block)
+    {
+        switch (event.op)
+        {
+        case TraceOp::allocate:
+            block.addr = alloc.allocate(event.size);
+            block.size = event.size;
+            return block.addr != nullptr || event.size == 0;
+
+        case TraceOp::deallocate:
+            if (block.addr != nullptr)
+            {
+                alloc.deallocate(block.addr);
+                block.addr = nullptr;
+            }
+            return true;
+
+        case TraceOp::reallocate:
+        {
+            void* addr = alloc.allocate(event.size);
+            if (addr == nullptr)
+            {
+                return event.size == 0;
+            }
+
+            if (block.addr != nullptr)
+            {
+                std::memcpy(addr, block.addr, std::min(block.size, static_cast<std::size_t>(event.size)));
+                alloc.deallocate(block.addr);
+            }
+            block.addr = addr;
+            block.size = event.size;
+            return true;
+        }
+        }
+
+        return true;
+    }
+
+    // Returns the state of 'alloc' after event 'i'.
+    template <class Alloc>
+    static ReplaySample sample(const Alloc& alloc, std::size_t i)
+    {
+        if constexpr (has_external_fragmentation<Alloc>::value)
+        {
+            return ReplaySample{i, alloc.allocated(), alloc.external_fragmentation()};
+        }
+        else
+        {
+            return ReplaySample{i, alloc.allocated(), 0};
+        }
+    }
+
+}; // class TraceReplay
+
+#endif // TRACE_REPLAY_H
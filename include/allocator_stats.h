@@ -0,0 +1,352 @@
+#ifndef ALLOCATOR_STATS_H
+#define ALLOCATOR_STATS_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+// Statistics policies that a memory allocator is templated on. The allocator inherits privately from
+//  it's policy and calls the record methods as it allocates and deallocates, and returns the policy
+//  from it's stats method.
+
+// Statistics policy that records nothing. It has no members and every record method is empty, so an
+//  allocator using it compiles to the same code as one with no statistics at all.
+struct NoStats
+{
+    static constexpr bool enabled = false;
+
+    void record_allocate(std::size_t, std::size_t, std::size_t) {}
+    void record_deallocate(std::size_t, std::size_t, std::size_t) {}
+    void record_failure() {}
+    void record_visit() {}
+    void record_split() {}
+    void record_merge() {}
+    void record_free_block_added(std::size_t, std::size_t = 1) {}
+    void record_free_block_removed(std::size_t, std::size_t = 1) {}
+    void record_reset(std::size_t, std::size_t) {}
+
+}; // struct NoStats
+
+// Statistics policy that counts allocations and deallocations per power of 2 size bucket and tracks
+//  how the memory buffer is used. It also keeps a histogram of free blocks, with the largest free block
+//  in each size bucket and how many there are of it, updated as blocks are added to and removed from the
+//  free lists, from which fragmentation is reported without walking them.
+class AllocatorStats
+{
+public:
+
+    static constexpr bool enabled = true;
+
+    // Number of size buckets. Bucket i holds blocks of 2^i to 2^(i+1)-1 bytes, and the last bucket also
+    //  holds every larger block.
+    static constexpr std::size_t bucket_count = 40;
+
+    // Returns the size bucket of a block of 'bytes' bytes.
+    static constexpr std::size_t bucket_of(std::size_t bytes)
+    {
+        const std::size_t bucket = (bytes > 1) ? 63 - __builtin_clzll(bytes) : 0;
+        return (bucket < bucket_count) ? bucket : bucket_count - 1;
+    }
+
+    // Returns number of blocks allocated from size bucket 'bucket'.
+    std::size_t allocations(std::size_t bucket) const
+    {
+        return allocation_counts[bucket];
+    }
+
+    // Returns number of blocks deallocated from size bucket 'bucket'.
+    std::size_t deallocations(std::size_t bucket) const
+    {
+        return deallocation_counts[bucket];
+    }
+
+    // Returns number of bytes in allocated blocks that are usable by their owner.
+    std::size_t payload_bytes() const
+    {
+        return payload;
+    }
+
+    // Returns number of bytes used by the allocator itself, i.e. headers, free list nodes and padding.
+    std::size_t metadata_bytes() const
+    {
+        return used - payload;
+    }
+
+    // Returns number of bytes neither allocated nor used by the allocator.
+    std::size_t free_bytes() const
+    {
+        return total - used;
+    }
+
+    // Returns the largest number of bytes that have been in use, payload and metadata, at once.
+    std::size_t peak_bytes() const
+    {
+        return peak;
+    }
+
+    // Returns number of allocations that returned nullptr.
+    std::size_t failed_allocations() const
+    {
+        return failures;
+    }
+
+    // Returns number of free list nodes visited while searching for a block.
+    std::size_t nodes_visited() const
+    {
+        return visits;
+    }
+
+    // Returns number of blocks split in two.
+    std::size_t splits() const
+    {
+        return split_count;
+    }
+
+    // Returns number of pairs of blocks merged into one.
+    std::size_t merges() const
+    {
+        return merge_count;
+    }
+
+    // Returns number of free blocks.
+    std::size_t free_blocks() const
+    {
+        return free_block_count;
+    }
+
+    // Returns number of bytes in free blocks that could be allocated, i.e. free bytes not counting the
+    //  headers of free blocks.
+    std::size_t free_block_bytes() const
+    {
+        return free_block_total;
+    }
+
+    // Returns number of free blocks in size bucket 'bucket'.
+    std::size_t free_histogram(std::size_t bucket) const
+    {
+        return free_counts[bucket];
+    }
+
+    // Returns the highest size bucket holding a free block, or 0 if there are none.
+    std::size_t top_free_bucket() const
+    {
+        return (nonempty_buckets != 0) ? 63 - __builtin_clzll(nonempty_buckets) : 0;
+    }
+
+    // Returns number of bytes lost to allocations being rounded up to a block size.
+    std::size_t internal_fragmentation() const
+    {
+        return payload - requested;
+    }
+
+    // Returns true if the size of the largest free block is known without searching for it. It is only
+    //  lost when the last free block of the largest size is removed while smaller blocks are left in
+    //  it's size bucket, and found again once a block at least as large is added or the bucket empties.
+    bool largest_free_known() const
+    {
+        return (stale_buckets & (std::uint64_t{1} << top_free_bucket())) == 0;
+    }
+
+    // Returns the size of the largest free block in bytes, or 0 if there are none, if
+    //  largest_free_known.
+    std::size_t largest_free() const
+    {
+        return free_max[top_free_bucket()];
+    }
+
+    // Record the size of the largest free block, and how many free blocks there are of it, after the
+    //  allocator has searched for it.
+    void record_largest_free(std::size_t bytes, std::size_t count) const
+    {
+        const std::size_t bucket = bucket_of(bytes);
+
+        free_max[bucket] = bytes;
+        free_max_count[bucket] = count;
+        stale_buckets &= ~(std::uint64_t{1} << bucket);
+    }
+
+    // Returns the external fragmentation index, 1 - (largest free block / free block bytes), given the
+    //  size of the largest free block. 0 means all free memory is in one block.
+    double external_fragmentation(std::size_t largest_free_block) const
+    {
+        if (free_block_total == 0)
+        {
+            return 0;
+        }
+
+        return 1.0 - (static_cast<double>(largest_free_block) / free_block_total);
+    }
+
+    // Record a block of 'payload' bytes being allocated for a request of 'requested' bytes, leaving
+    //  'used' bytes in use.
+    void record_allocate(std::size_t requested, std::size_t payload, std::size_t used)
+    {
+        allocation_counts[bucket_of(payload)]++;
+        this->requested += requested;
+        this->payload += payload;
+        this->used = used;
+
+        if (used > peak)
+        {
+            peak = used;
+        }
+    }
+
+    // Record a block of 'payload' bytes allocated for a request of 'requested' bytes being
+    //  deallocated, leaving 'used' bytes in use.
+    void record_deallocate(std::size_t requested, std::size_t payload, std::size_t used)
+    {
+        deallocation_counts[bucket_of(payload)]++;
+        this->requested -= requested;
+        this->payload -= payload;
+        this->used = used;
+    }
+
+    // Record an allocation failing.
+    void record_failure()
+    {
+        failures++;
+    }
+
+    // Record a free list node being visited.
+    void record_visit()
+    {
+        visits++;
+    }
+
+    // Record a block being split.
+    void record_split()
+    {
+        split_count++;
+    }
+
+    // Record 2 blocks being merged.
+    void record_merge()
+    {
+        merge_count++;
+    }
+
+    // Record 'count' free blocks of 'bytes' bytes being added to the free lists.
+    void record_free_block_added(std::size_t bytes, std::size_t count = 1)
+    {
+        const std::size_t bucket = bucket_of(bytes);
+
+        if (count > 0)
+        {
+            // A stale maximum is larger than every block left in the bucket.
+            if (free_counts[bucket] == 0 || bytes > free_max[bucket] || ((stale_buckets & (std::uint64_t{1} << bucket)) != 0 && bytes == free_max[bucket]))
+            {
+                free_max[bucket] = bytes;
+                free_max_count[bucket] = count;
+                stale_buckets &= ~(std::uint64_t{1} << bucket);
+            }
+            else if (bytes == free_max[bucket])
+            {
+                free_max_count[bucket] += count;
+            }
+        }
+
+        free_counts[bucket] += count;
+        nonempty_buckets |= std::uint64_t{1} << bucket;
+        free_block_count += count;
+        free_block_total += bytes * count;
+    }
+
+    // Record 'count' free blocks of 'bytes' bytes being removed from the free lists.
+    void record_free_block_removed(std::size_t bytes, std::size_t count = 1)
+    {
+        const std::size_t bucket = bucket_of(bytes);
+
+        free_counts[bucket] -= count;
+        if (free_counts[bucket] == 0)
+        {
+            nonempty_buckets &= ~(std::uint64_t{1} << bucket);
+            free_max[bucket] = 0;
+            free_max_count[bucket] = 0;
+            stale_buckets &= ~(std::uint64_t{1} << bucket);
+        }
+        else if (count > 0 && bytes == free_max[bucket] && (stale_buckets & (std::uint64_t{1} << bucket)) == 0)
+        {
+            assert(free_max_count[bucket] >= count);
+
+            // The maximum is kept once it's blocks are gone, as a bound on the blocks left.
+            free_max_count[bucket] -= count;
+            if (free_max_count[bucket] == 0)
+            {
+                stale_buckets |= std::uint64_t{1} << bucket;
+            }
+        }
+        free_block_count -= count;
+        free_block_total -= bytes * count;
+    }
+
+    // Record the allocator being reset, with a memory buffer of 'total' bytes and 'used' bytes in use.
+    //  The counters carry on from before the reset, but the free block histogram is cleared so the
+    //  allocator can add it's initial free blocks.
+    void record_reset(std::size_t total, std::size_t used)
+    {
+        free_counts.fill(0);
+        nonempty_buckets = 0;
+        free_block_count = 0;
+        free_block_total = 0;
+        free_max.fill(0);
+        free_max_count.fill(0);
+        stale_buckets = 0;
+
+        this->requested = 0;
+        this->payload = 0;
+        this->used = used;
+        this->total = total;
+
+        if (used > peak)
+        {
+            peak = used;
+        }
+    }
+
+private:
+
+    // Number of blocks allocated and deallocated from each size bucket.
+    std::array<std::size_t, bucket_count> allocation_counts{};
+    std::array<std::size_t, bucket_count> deallocation_counts{};
+
+    // Number of free blocks in each size bucket, and a bit set for each bucket that is not empty.
+    std::array<std::size_t, bucket_count> free_counts{};
+    std::uint64_t nonempty_buckets = 0;
+
+    // Number of free blocks and bytes in them.
+    std::size_t free_block_count = 0;
+    std::size_t free_block_total = 0;
+
+    // Largest free block in each size bucket and the number of free blocks of it, and a bit set for
+    //  each bucket whose largest block has been removed, leaving the maximum as a bound. Updated by const
+    //  methods when the allocator searches for the largest free block.
+    mutable std::array<std::size_t, bucket_count> free_max{};
+    mutable std::array<std::size_t, bucket_count> free_max_count{};
+    mutable std::uint64_t stale_buckets = 0;
+
+    // Number of bytes requested by allocations.
+    std::size_t requested = 0;
+
+    // Number of bytes in allocated blocks usable by their owner.
+    std::size_t payload = 0;
+
+    // Number of bytes in use, payload and metadata.
+    std::size_t used = 0;
+
+    // Length of memory buffer in bytes.
+    std::size_t total = 0;
+
+    // Largest number of bytes in use at once.
+    std::size_t peak = 0;
+
+    // Event counters.
+    std::size_t failures = 0;
+    std::size_t visits = 0;
+    std::size_t split_count = 0;
+    std::size_t merge_count = 0;
+
+}; // class AllocatorStats
+
+#endif // ALLOCATOR_STATS_H
@@ -0,0 +1,111 @@
+#ifndef COMPACT_POINTER_H
+#define COMPACT_POINTER_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Pointer to a T that is stored as an unsigned 32 bit distance from it's own address, in units of
+//  'granularity' bytes, so it needs no base address and behaves like a T* when read or assigned. A
+//  'forward' pointer only points to higher addresses and any other only to lower ones, which is all the
+//  links of a free list sorted by address need, so it can point to anything within 4GiB times
+//  'granularity' of itself. When 'granularity' is greater than 1 the distance is taken from the pointer's
+//  address rounded down to it, and what it points to must be aligned to it. A distance of 0 is nullptr,
+//  which is never a valid target as a pointer never points at itself.
+template <class T, bool forward = true, std::size_t granularity = 1>
+class CompactPointer
+{
+public:
+
+    CompactPointer() = default;
+
+    CompactPointer(T* ptr)
+    {
+        set(ptr);
+    }
+
+    // Copies are made relative to their own address, so they point at the same T.
+    CompactPointer(const CompactPointer& other)
+    {
+        set(other.get());
+    }
+
+    CompactPointer& operator=(const CompactPointer& other)
+    {
+        set(other.get());
+        return *this;
+    }
+
+    CompactPointer& operator=(T* ptr)
+    {
+        set(ptr);
+        return *this;
+    }
+
+    // Returns the pointer.
+    T* get() const
+    {
+        if (distance == 0)
+        {
+            return nullptr;
+        }
+
+        const std::uintptr_t bytes = static_cast<std::uintptr_t>(distance) * granularity;
+        return reinterpret_cast<T*>(forward ? base() + bytes : base() - bytes);
+    }
+
+    operator T*() const
+    {
+        return get();
+    }
+
+    T* operator->() const
+    {
+        return get();
+    }
+
+    // Largest distance in bytes between a pointer and what it points to.
+    static constexpr std::size_t max_distance = static_cast<std::size_t>(UINT32_MAX) * granularity;
+
+private:
+
+    // Returns the address distances are taken from.
+    std::uintptr_t base() const
+    {
+        return reinterpret_cast<std::uintptr_t>(this) & ~static_cast<std::uintptr_t>(granularity - 1);
+    }
+
+    void set(T* ptr)
+    {
+        if (ptr == nullptr)
+        {
+            distance = 0;
+            return;
+        }
+
+        const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(ptr);
+        assert(forward ? addr > base() : addr < base());
+        assert(addr % granularity == 0);
+
+        const std::uintptr_t bytes = forward ? addr - base() : base() - addr;
+        assert(bytes <= max_distance);
+
+        distance = static_cast<std::uint32_t>(bytes / granularity);
+    }
+
+    // Distance in units of 'granularity' bytes from base(), or 0 for nullptr.
+    std::uint32_t distance;
+
+}; // class CompactPointer
+
+// Type of the pointers to the next node in free lists sorted by address, a CompactPointer when 'compact'
+//  is true.
+template <class T, bool compact>
+using NodePointer = std::conditional_t<compact, CompactPointer<T>, T*>;
+
+// Type of the block sizes in free list nodes, 32 bits when 'compact' is true.
+template <bool compact>
+using NodeSize = std::conditional_t<compact, std::uint32_t, std::size_t>;
+
+#endif // COMPACT_POINTER_H
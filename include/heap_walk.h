@@ -0,0 +1,34 @@
+#ifndef HEAP_WALK_H
+#define HEAP_WALK_H
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Physical block of a memory buffer, as visited by the walk() method of a memory allocator.
+struct HeapBlock
+{
+    // Address of the start of the block, including it's node.
+    void* addr;
+
+    // Size of the block in bytes, including it's node.
+    std::size_t bytes;
+
+    // True if the block is free.
+    bool free;
+
+    // Index of the block size in allocators with more than one, from 0 for the smallest. Always 0 in
+    //  the others.
+    std::size_t level;
+};
+
+// True for memory allocators with a walk(visit) method visiting each HeapBlock of their memory buffer.
+template <class T, class = void>
+struct has_heap_walk : std::false_type {};
+
+template <class T>
+struct has_heap_walk<T, std::void_t<
+    decltype(std::declval<const T&>().walk(std::declval<void (*)(const HeapBlock&)>()))
+    >> : std::true_type {};
+
+#endif // HEAP_WALK_H
@@ -0,0 +1,54 @@
+#ifndef MEMORY_REGION_H
+#define MEMORY_REGION_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Non-owning view of a contiguous region of memory. It has the same data/begin/end interface as the
+//  containers used as memory buffers, so it can be passed to the constructor of any memory allocator.
+class MemoryRegion
+{
+public:
+
+    // Constructor that takes in the start address and length in bytes of the region.
+    MemoryRegion(void* addr, std::size_t bytes) :
+        first(reinterpret_cast<std::uint8_t*>(addr)),
+        bytes(bytes)
+    {
+    }
+
+    // Returns the start address of the region.
+    std::uint8_t* data() const
+    {
+        return first;
+    }
+
+    // Returns the start address of the region.
+    std::uint8_t* begin() const
+    {
+        return first;
+    }
+
+    // Returns the address one past the end of the region.
+    std::uint8_t* end() const
+    {
+        return first + bytes;
+    }
+
+    // Returns length of the region in bytes.
+    std::size_t size() const
+    {
+        return bytes;
+    }
+
+private:
+
+    // Start address of the region.
+    std::uint8_t* first;
+
+    // Length of the region in bytes.
+    std::size_t bytes;
+
+}; // class MemoryRegion
+
+#endif // MEMORY_REGION_H
@@ -0,0 +1,113 @@
+#ifndef STATIC_MEMORY_ALLOCATOR_H
+#define STATIC_MEMORY_ALLOCATOR_H
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "memory_allocator.h"
+
+// Type trait that is true if 'T' provides the memory allocator interface (allocate, deallocate,
+//  allocated, length and reset) as non-virtual or virtual member functions.
+template <class T, class = void>
+struct is_memory_allocator : std::false_type {};
+
+template <class T>
+struct is_memory_allocator<T, std::void_t<
+    decltype(std::declval<void*&>() = std::declval<T&>().allocate(std::size_t{})),
+    decltype(std::declval<T&>().deallocate(std::declval<void*>())),
+    decltype(std::size_t{std::declval<const T&>().allocated()}),
+    decltype(std::size_t{std::declval<const T&>().length()}),
+    decltype(std::declval<T&>().reset())
+    >> : std::true_type {};
+
+// Static (compile time) interface for a memory allocator class using the curiously recurring template
+//  pattern. Generic code templated on a class deriving from this calls it's methods directly, so
+//  allocate/deallocate can be inlined instead of going through the vtable of MemoryAllocator.
+template <class Derived>
+class StaticMemoryAllocator
+{
+public:
+
+    // Returns the derived memory allocator.
+    Derived& derived()
+    {
+        return static_cast<Derived&>(*this);
+    }
+
+    // Returns the derived memory allocator.
+    const Derived& derived() const
+    {
+        return static_cast<const Derived&>(*this);
+    }
+
+protected:
+
+    // Checks the derived class implements the interface once it is a complete type.
+    ~StaticMemoryAllocator()
+    {
+        static_assert(is_memory_allocator<Derived>::value, "Derived must implement the memory allocator interface");
+    }
+
+}; // class StaticMemoryAllocator
+
+// Thin adapter that exposes a statically dispatched memory allocator of type 'Allocator' through the
+//  MemoryAllocator interface, for code that needs to choose an allocator at runtime.
+template <class Allocator>
+class MemoryAllocatorAdapter : public MemoryAllocator
+{
+public:
+
+    static_assert(is_memory_allocator<Allocator>::value, "Allocator must implement the memory allocator interface");
+
+    // Constructor that forwards all of it's arguments to the constructor of the adapted allocator.
+    template <class... Args>
+    MemoryAllocatorAdapter(Args&&... args) :
+        alloc(std::forward<Args>(args)...)
+    {
+    }
+
+    // Allocate a number of bytes and return the address of the allocation.
+    void* allocate(std::size_t bytes)
+    {
+        return alloc.allocate(bytes);
+    }
+
+    // Deallocate a block of memory to free it up for re-allocation.
+    void deallocate(void* addr)
+    {
+        alloc.deallocate(addr);
+    }
+
+    // Returns number of bytes allocated to memory buffer.
+    std::size_t allocated() const
+    {
+        return alloc.allocated();
+    }
+
+    // Returns size of memory buffer in bytes.
+    std::size_t length() const
+    {
+        return alloc.length();
+    }
+
+    // Deallocates all blocks and returns this object to it's initialisation state
+    void reset()
+    {
+        alloc.reset();
+    }
+
+    // Returns the adapted allocator.
+    Allocator& get()
+    {
+        return alloc;
+    }
+
+private:
+
+    // Statically dispatched allocator that all calls are forwarded to.
+    Allocator alloc;
+
+}; // class MemoryAllocatorAdapter
+
+#endif // STATIC_MEMORY_ALLOCATOR_H
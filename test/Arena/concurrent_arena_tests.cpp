@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Arena/concurrent_arena_allocator.h"
+#include "memory_region.h"
+
+TEST(Constructor, ByteArray)
+{
+    alignas(16) std::array<std::uint8_t, 65536> arr;
+
+    ConcurrentArenaAllocator<> ca(arr);
+
+    EXPECT_EQ(ca.length(), 65536);
+    EXPECT_EQ(ca.allocated(), 0);
+}
+
+TEST(Constructor, Region)
+{
+    alignas(16) std::array<std::uint8_t, 65536> arr;
+
+    ConcurrentArenaAllocator<> ca(arr.data(), 32768);
+
+    EXPECT_EQ(ca.length(), 32768);
+    EXPECT_EQ(ca.allocated(), 0);
+}
+
+TEST(Allocate, First)
+{
+    alignas(16) std::array<std::uint8_t, 65536> arr;
+    ConcurrentArenaAllocator<> ca(arr);
+
+    void* addr = ca.allocate(32);
+
+    EXPECT_EQ(addr, reinterpret_cast<void*>(arr.data()));
+    EXPECT_EQ(ca.allocated(), 4096);
+}
+
+TEST(Allocate, Nothing)
+{
+    alignas(16) std::array<std::uint8_t, 65536> arr;
+    ConcurrentArenaAllocator<> ca(arr);
+
+    EXPECT_EQ(ca.allocate(0), nullptr);
+    EXPECT_EQ(ca.allocated(), 0);
+}
+
+TEST(Allocate, SameChunk)
+{
+    alignas(16) std::array<std::uint8_t, 65536> arr;
+    ConcurrentArenaAllocator<16> ca(arr);
+
+    void* addr1 = ca.allocate(1);
+    void* addr2 = ca.allocate(1);
+
+    EXPECT_EQ(addr2, addr1 + 16);
+    EXPECT_EQ(ca.allocated(), 4096);
+}
+
+TEST(Allocate, NewChunk)
+{
+    alignas(16) std::array<std::uint8_t, 65536> arr;
+    ConcurrentArenaAllocator<> ca(arr);
+
+    ca.allocate(4000);
+    void* addr = ca.allocate(200);
+
+    EXPECT_EQ(addr, reinterpret_cast<void*>(arr.data()) + 4096);
+    EXPECT_EQ(ca.allocated(), 2*4096);
+}
+
+TEST(Allocate, LargerThanChunk)
+{
+    alignas(16) std::array<std::uint8_t, 65536> arr;
+    ConcurrentArenaAllocator<> ca(arr);
+
+    void* addr = ca.allocate(10000);
+
+    EXPECT_NE(addr, nullptr);
+    EXPECT_GE(ca.allocated(), 10000);
+}
+
+TEST(Allocate, NoSpace)
+{
+    alignas(16) std::array<std::uint8_t, 8192> arr;
+    ConcurrentArenaAllocator<> ca(arr);
+
+    EXPECT_NE(ca.allocate(4000), nullptr);
+    EXPECT_NE(ca.allocate(4000), nullptr);
+    EXPECT_EQ(ca.allocate(4000), nullptr);
+    EXPECT_EQ(ca.allocated(), 8192);
+}
+
+TEST(Allocate, FailureKeepsCursor)
+{
+    alignas(16) std::array<std::uint8_t, 8192> arr;
+    ConcurrentArenaAllocator<> ca(arr);
+
+    EXPECT_NE(ca.allocate(4000), nullptr);
+    for (int i=0; i<10; i++)
+    {
+        EXPECT_EQ(ca.allocate(10000), nullptr);
+    }
+
+    // Failed requests don't move the cursor, so the rest of the memory buffer is still used.
+    EXPECT_EQ(ca.allocated(), 4096);
+    EXPECT_NE(ca.allocate(4000), nullptr);
+    EXPECT_EQ(ca.allocated(), 8192);
+}
+
+TEST(Allocate, HugeRequest)
+{
+    alignas(16) std::array<std::uint8_t, 8192> arr;
+    ConcurrentArenaAllocator<> ca(arr);
+
+    void* addr = ca.allocate(1);
+    const std::size_t allocated = ca.allocated();
+
+    // The padding and size, or the size rounded up, would wrap round to fit.
+    EXPECT_EQ(ca.allocate(SIZE_MAX), nullptr);
+    EXPECT_EQ(ca.allocate(SIZE_MAX - 8), nullptr);
+    EXPECT_EQ(ca.allocated(), allocated);
+    EXPECT_EQ(ca.allocate(1), addr + 16);
+}
+
+TEST(Allocate, UncontendedChunkSize)
+{
+    alignas(16) std::array<std::uint8_t, 65536> arr;
+    ConcurrentArenaAllocator<16, 4096, 16384> ca(arr);
+
+    for (int i=0; i<10; i++)
+    {
+        ca.allocate(4000);
+    }
+
+    EXPECT_EQ(ca.next_chunk_length(), 4096);
+}
+
+TEST(Allocate, Threads)
+{
+    const std::size_t threads_count = 8;
+    const std::size_t allocs_count = 1000;
+
+    std::vector<std::uint8_t> buffer(threads_count * allocs_count * 64);
+    MemoryRegion region(buffer.data(), buffer.size());
+    ConcurrentArenaAllocator<16, 1024, 16384> ca(region);
+
+    std::vector<std::vector<std::uint8_t*>> allocs(threads_count);
+
+    std::vector<std::thread> threads;
+    for (std::size_t t=0; t<threads_count; t++)
+    {
+        threads.emplace_back([&, t]()
+        {
+            for (std::size_t i=0; i<allocs_count; i++)
+            {
+                auto addr = reinterpret_cast<std::uint8_t*>(ca.allocate(24));
+                std::fill(addr, addr + 24, static_cast<std::uint8_t>(t));
+                allocs[t].push_back(addr);
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::vector<std::uint8_t*> all;
+    for (std::size_t t=0; t<threads_count; t++)
+    {
+        for (auto addr : allocs[t])
+        {
+            EXPECT_TRUE(std::all_of(addr, addr + 24, [t](std::uint8_t b) { return b == t; }));
+            all.push_back(addr);
+        }
+    }
+
+    std::sort(all.begin(), all.end());
+    for (std::size_t i=1; i<all.size(); i++)
+    {
+        EXPECT_GE(all[i] - all[i-1], 24);
+    }
+}
+
+TEST(Reset, Reuse)
+{
+    alignas(16) std::array<std::uint8_t, 65536> arr;
+    ConcurrentArenaAllocator<> ca(arr);
+
+    ca.allocate(100);
+    ca.allocate(100);
+    ca.reset();
+
+    EXPECT_EQ(ca.allocated(), 0);
+    EXPECT_EQ(ca.allocate(100), reinterpret_cast<void*>(arr.data()));
+}
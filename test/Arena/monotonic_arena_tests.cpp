@@ -0,0 +1,223 @@
+#include <array>
+#include <cstddef>
+
+#include <gtest/gtest.h>
+
+#include "Arena/monotonic_arena_allocator.h"
+
+TEST(Constructor, ByteArray)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+
+    MonotonicArenaAllocator<> ma(arr);
+
+    EXPECT_EQ(ma.length(), 256);
+    EXPECT_EQ(ma.allocated(), 0);
+    EXPECT_EQ(ma.chunks_used(), 1);
+}
+
+TEST(Constructor, Region)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+
+    MonotonicArenaAllocator<> ma(arr.data(), 128);
+    ma.add_chunk(arr.data() + 128, 128);
+
+    EXPECT_EQ(ma.length(), 256);
+    EXPECT_EQ(ma.chunks_used(), 2);
+    EXPECT_EQ(ma.allocate(16), arr.data());
+}
+
+TEST(Allocate, First)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    MonotonicArenaAllocator<> ma(arr);
+
+    void* addr = ma.allocate(32);
+
+    EXPECT_EQ(addr, reinterpret_cast<void*>(arr.data()));
+    EXPECT_EQ(ma.allocated(), 32);
+    EXPECT_EQ(ma.padding(), 0);
+}
+
+TEST(Allocate, Nothing)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    MonotonicArenaAllocator<> ma(arr);
+
+    EXPECT_EQ(ma.allocate(0), nullptr);
+    EXPECT_EQ(ma.allocated(), 0);
+}
+
+TEST(Allocate, Alignment)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    MonotonicArenaAllocator<16> ma(arr);
+
+    void* addr1 = ma.allocate(1);
+    void* addr2 = ma.allocate(1);
+
+    EXPECT_EQ(addr2, addr1 + 16);
+    EXPECT_EQ(ma.allocated(), 17);
+    EXPECT_EQ(ma.padding(), 15);
+}
+
+TEST(Allocate, NoAlignment)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    MonotonicArenaAllocator<1> ma(arr);
+
+    void* addr1 = ma.allocate(1);
+    void* addr2 = ma.allocate(1);
+
+    EXPECT_EQ(addr2, addr1 + 1);
+    EXPECT_EQ(ma.padding(), 0);
+}
+
+TEST(Allocate, NoSpace)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    MonotonicArenaAllocator<> ma(arr);
+
+    EXPECT_NE(ma.allocate(256), nullptr);
+    EXPECT_EQ(ma.allocate(1), nullptr);
+    EXPECT_EQ(ma.allocated(), 256);
+}
+
+TEST(Allocate, NextChunk)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr1;
+    alignas(16) std::array<std::uint8_t, 256> arr2;
+    MonotonicArenaAllocator<> ma(arr1);
+
+    EXPECT_TRUE(ma.add_chunk(arr2));
+    EXPECT_EQ(ma.length(), 512);
+
+    ma.allocate(200);
+    void* addr = ma.allocate(100);
+
+    EXPECT_EQ(addr, reinterpret_cast<void*>(arr2.data()));
+    EXPECT_EQ(ma.allocated(), 356);
+    EXPECT_TRUE(ma.owns(addr));
+}
+
+TEST(Allocate, TooLargeForNextChunk)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr1;
+    alignas(16) std::array<std::uint8_t, 64> arr2;
+    MonotonicArenaAllocator<> ma(arr1);
+    ma.add_chunk(arr2);
+
+    ma.allocate(200);
+
+    EXPECT_EQ(ma.allocate(100), nullptr);
+    EXPECT_EQ(ma.allocated(), 200);
+    EXPECT_NE(ma.allocate(32), nullptr);
+}
+
+TEST(Allocate, HugeRequest)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr1;
+    alignas(16) std::array<std::uint8_t, 256> arr2;
+    MonotonicArenaAllocator<> ma(arr1);
+    ma.add_chunk(arr2);
+
+    ma.allocate(1);
+
+    // The padding and size would wrap round to fit.
+    EXPECT_EQ(ma.allocate(SIZE_MAX), nullptr);
+    EXPECT_EQ(ma.allocate(SIZE_MAX - 14), nullptr);
+    EXPECT_EQ(ma.allocated(), 1);
+    EXPECT_EQ(ma.chunks_used(), 2);
+}
+
+TEST(Allocate, MaxChunks)
+{
+    alignas(16) std::array<std::uint8_t, 64> arr1;
+    alignas(16) std::array<std::uint8_t, 64> arr2;
+    MonotonicArenaAllocator<16, 1> ma(arr1);
+
+    EXPECT_FALSE(ma.add_chunk(arr2));
+    EXPECT_EQ(ma.length(), 64);
+}
+
+TEST(Deallocate, NoEffect)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    MonotonicArenaAllocator<> ma(arr);
+
+    void* addr = ma.allocate(32);
+    ma.deallocate(addr);
+
+    EXPECT_EQ(ma.allocated(), 32);
+}
+
+TEST(Rewind, Mark)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    MonotonicArenaAllocator<> ma(arr);
+
+    ma.allocate(32);
+    auto mark = ma.mark();
+    void* addr = ma.allocate(1);
+    ma.allocate(64);
+
+    ma.rewind(mark);
+
+    EXPECT_EQ(ma.allocated(), 32);
+    EXPECT_EQ(ma.padding(), 0);
+    EXPECT_EQ(ma.allocate(1), addr);
+}
+
+TEST(Rewind, AcrossChunks)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr1;
+    alignas(16) std::array<std::uint8_t, 256> arr2;
+    MonotonicArenaAllocator<> ma(arr1);
+    ma.add_chunk(arr2);
+
+    auto mark = ma.mark();
+    ma.allocate(200);
+    ma.allocate(200);
+
+    ma.rewind(mark);
+
+    EXPECT_EQ(ma.allocated(), 0);
+    EXPECT_EQ(ma.allocate(200), reinterpret_cast<void*>(arr1.data()));
+}
+
+TEST(Rewind, Scope)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    MonotonicArenaAllocator<> ma(arr);
+
+    ma.allocate(16);
+    {
+        MonotonicArenaAllocator<>::Scope scope(ma);
+        ma.allocate(100);
+        {
+            MonotonicArenaAllocator<>::Scope inner(ma);
+            ma.allocate(100);
+        }
+        EXPECT_EQ(ma.allocated(), 116);
+    }
+
+    EXPECT_EQ(ma.allocated(), 16);
+}
+
+TEST(Reset, AllChunks)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr1;
+    alignas(16) std::array<std::uint8_t, 256> arr2;
+    MonotonicArenaAllocator<> ma(arr1);
+    ma.add_chunk(arr2);
+
+    ma.allocate(200);
+    ma.allocate(3);
+    ma.allocate(200);
+    ma.reset();
+
+    EXPECT_EQ(ma.allocated(), 0);
+    EXPECT_EQ(ma.padding(), 0);
+    EXPECT_EQ(ma.allocate(1), reinterpret_cast<void*>(arr1.data()));
+}
@@ -1,5 +1,6 @@
 #include <array>
 #include <cstddef>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -19,7 +20,7 @@ TEST(Constructor, NoRem)
     EXPECT_EQ(bs.block_lengths()[3], 8+(7*NODESIZE));
     EXPECT_EQ(sizeof(arr)%(bs.block_lengths()[3] + NODESIZE), 0);
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -33,7 +34,7 @@ TEST(Constructor, Rem_Blocksize3)
 
     EXPECT_EQ(sizeof(arr)%(bs.block_lengths()[3] + NODESIZE), bs.block_lengths()[2] + NODESIZE);
     EXPECT_EQ(bs.allocated(), 11*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 1);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -47,7 +48,7 @@ TEST(Constructor, Rem_Blocksize2)
 
     EXPECT_EQ(sizeof(arr)%(bs.block_lengths()[3] + NODESIZE), bs.block_lengths()[1] + NODESIZE);
     EXPECT_EQ(bs.allocated(), 11*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 1);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -61,7 +62,7 @@ TEST(Constructor, Rem_Blocksize1)
 
     EXPECT_EQ(sizeof(arr)%(bs.block_lengths()[3] + NODESIZE), bs.block_lengths()[0] + NODESIZE);
     EXPECT_EQ(bs.allocated(), 11*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 1);
@@ -79,7 +80,7 @@ TEST(Constructor, Rem_Nodesize)
     EXPECT_EQ(bs.block_lengths()[3], 64+(7*NODESIZE));
     EXPECT_EQ(sizeof(arr)%(bs.block_lengths()[3] + NODESIZE), NODESIZE);
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -93,7 +94,7 @@ TEST(Constructor, NoRem_Blocksize4)
 
     EXPECT_EQ(sizeof(arr) - (bs.block_lengths()[3] + NODESIZE), 0);
     EXPECT_EQ(bs.allocated(), NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 1);
+    EXPECT_EQ(bs.free_blocks4(), 1);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -107,7 +108,7 @@ TEST(Constructor, NoRem_Blocksize3)
 
     EXPECT_EQ(sizeof(arr) - (bs.block_lengths()[2] + NODESIZE), 0);
     EXPECT_EQ(bs.allocated(), NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 1);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -121,7 +122,7 @@ TEST(Constructor, NoRem_Blocksize2)
 
     EXPECT_EQ(sizeof(arr) - (bs.block_lengths()[1] + NODESIZE), 0);
     EXPECT_EQ(bs.allocated(), NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 1);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -135,12 +136,24 @@ TEST(Constructor, NoRem_Blocksize1)
 
     EXPECT_EQ(sizeof(arr) - (bs.block_lengths()[0] + NODESIZE), 0);
     EXPECT_EQ(bs.allocated(), NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 1);
 }
 
+TEST(Constructor, Region)
+{
+    std::array<std::uint8_t, 80+(80*NODESIZE)> arr;
+
+    BuddySystemMemoryAllocator<1> bs(arr.data(), 40+(40*NODESIZE));
+
+    EXPECT_EQ(bs.length(), 40+(40*NODESIZE));
+    EXPECT_EQ(bs.allocated(), 5*NODESIZE);
+    EXPECT_EQ(bs.free_blocks4(), 5);
+    EXPECT_EQ(bs.free_list1().count(), 0);
+}
+
 TEST(Allocate, Nothing)
 {
     std::array<std::uint8_t, 640+(80*NODESIZE)> arr;
@@ -151,7 +164,7 @@ TEST(Allocate, Nothing)
     auto addr = bs.allocate(0);
 
     EXPECT_EQ(addr, nullptr);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(allocated_bytes, bs.allocated());
 }
 
@@ -165,7 +178,7 @@ TEST(Allocate, TooManyBytes)
     auto addr = bs.allocate(65+(7*NODESIZE));
 
     EXPECT_EQ(addr, nullptr);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(allocated_bytes, bs.allocated());
 }
 
@@ -179,7 +192,7 @@ TEST(Allocate, Blocksize4)
         bs.allocate(bs.block_lengths()[3] - 1);
     }
 
-    EXPECT_EQ(bs.free_list4().count(), 1);
+    EXPECT_EQ(bs.free_blocks4(), 1);
     EXPECT_EQ(bs.allocated(), (11*NODESIZE) + (10*bs.block_lengths()[3]));
 }
 
@@ -248,7 +261,7 @@ TEST(Allocate, EveryBlocksize10Times_Descending)
     }
 
     EXPECT_EQ(bs.allocated(), 10*(bs.block_lengths()[0]+bs.block_lengths()[1]+bs.block_lengths()[2]+bs.block_lengths()[3]) + (72*NODESIZE));
-    EXPECT_EQ(bs.free_list4().count(), 31);
+    EXPECT_EQ(bs.free_blocks4(), 31);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 1);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -277,7 +290,7 @@ TEST(Allocate, EveryBlocksize10Times_Ascending)
     }
 
     EXPECT_EQ(bs.allocated(), 10*(bs.block_lengths()[0]+bs.block_lengths()[1]+bs.block_lengths()[2]+bs.block_lengths()[3]) + (72*NODESIZE));
-    EXPECT_EQ(bs.free_list4().count(), 31);
+    EXPECT_EQ(bs.free_blocks4(), 31);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 1);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -297,7 +310,7 @@ TEST(Allocate, EveryBlocksize10Times_MixedDescending)
     }
 
     EXPECT_EQ(bs.allocated(), 10*(bs.block_lengths()[0]+bs.block_lengths()[1]+bs.block_lengths()[2]+bs.block_lengths()[3]) + (72*NODESIZE));
-    EXPECT_EQ(bs.free_list4().count(), 31);
+    EXPECT_EQ(bs.free_blocks4(), 31);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 1);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -317,7 +330,7 @@ TEST(Allocate, EveryBlocksize10Times_MixedAscending)
     }
 
     EXPECT_EQ(bs.allocated(), 10*(bs.block_lengths()[0]+bs.block_lengths()[1]+bs.block_lengths()[2]+bs.block_lengths()[3]) + (72*NODESIZE));
-    EXPECT_EQ(bs.free_list4().count(), 31);
+    EXPECT_EQ(bs.free_blocks4(), 31);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 1);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -337,7 +350,7 @@ TEST(Allocate, NoSpace)
 
     EXPECT_EQ(addr, nullptr);
     EXPECT_EQ(bs.length() - bs.allocated(), 0);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -354,7 +367,7 @@ TEST(Deallocate, First_Blocksize4)
 
     EXPECT_EQ(addr, reinterpret_cast<void*>(bs.free_list4().head())+NODESIZE);
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -371,7 +384,7 @@ TEST(Deallocate, First_Blocksize3)
 
     EXPECT_EQ(addr, reinterpret_cast<void*>(bs.free_list4().head())+NODESIZE);
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -388,7 +401,7 @@ TEST(Deallocate, First_Blocksize2)
 
     EXPECT_EQ(addr, reinterpret_cast<void*>(bs.free_list4().head())+NODESIZE);
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -405,7 +418,7 @@ TEST(Deallocate, First_Blocksize1)
 
     EXPECT_EQ(addr, reinterpret_cast<void*>(bs.free_list4().head())+NODESIZE);
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -427,7 +440,7 @@ TEST(Deallocate, First_EveryFreeList_OrderA)
     bs.deallocate(addr4);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -449,7 +462,7 @@ TEST(Deallocate, First_EveryFreeList_OrderB)
     bs.deallocate(addr3);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -471,7 +484,7 @@ TEST(Deallocate, First_EveryFreeList_OrderC)
     bs.deallocate(addr4);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -493,7 +506,7 @@ TEST(Deallocate, First_EveryFreeList_OrderD)
     bs.deallocate(addr2);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -515,7 +528,7 @@ TEST(Deallocate, First_EveryFreeList_OrderE)
     bs.deallocate(addr3);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -537,7 +550,7 @@ TEST(Deallocate, First_EveryFreeList_OrderF)
     bs.deallocate(addr2);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -559,7 +572,7 @@ TEST(Deallocate, First_EveryFreeList_OrderG)
     bs.deallocate(addr4);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -581,7 +594,7 @@ TEST(Deallocate, First_EveryFreeList_OrderH)
     bs.deallocate(addr3);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -603,7 +616,7 @@ TEST(Deallocate, First_EveryFreeList_OrderI)
     bs.deallocate(addr4);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -625,7 +638,7 @@ TEST(Deallocate, First_EveryFreeList_OrderJ)
     bs.deallocate(addr1);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -647,7 +660,7 @@ TEST(Deallocate, First_EveryFreeList_OrderK)
     bs.deallocate(addr3);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -669,7 +682,7 @@ TEST(Deallocate, First_EveryFreeList_OrderL)
     bs.deallocate(addr1);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -691,7 +704,7 @@ TEST(Deallocate, First_EveryFreeList_OrderM)
     bs.deallocate(addr4);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -713,7 +726,7 @@ TEST(Deallocate, First_EveryFreeList_OrderN)
     bs.deallocate(addr2);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -735,7 +748,7 @@ TEST(Deallocate, First_EveryFreeList_OrderO)
     bs.deallocate(addr4);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -757,7 +770,7 @@ TEST(Deallocate, First_EveryFreeList_OrderP)
     bs.deallocate(addr1);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -779,7 +792,7 @@ TEST(Deallocate, First_EveryFreeList_OrderQ)
     bs.deallocate(addr2);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -801,7 +814,7 @@ TEST(Deallocate, First_EveryFreeList_OrderR)
     bs.deallocate(addr1);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -823,7 +836,7 @@ TEST(Deallocate, First_EveryFreeList_OrderS)
     bs.deallocate(addr3);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -845,7 +858,7 @@ TEST(Deallocate, First_EveryFreeList_OrderT)
     bs.deallocate(addr2);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -867,7 +880,7 @@ TEST(Deallocate, First_EveryFreeList_OrderU)
     bs.deallocate(addr3);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -889,7 +902,7 @@ TEST(Deallocate, First_EveryFreeList_OrderV)
     bs.deallocate(addr1);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -911,7 +924,7 @@ TEST(Deallocate, First_EveryFreeList_OrderW)
     bs.deallocate(addr2);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -933,7 +946,7 @@ TEST(Deallocate, First_EveryFreeList_OrderX)
     bs.deallocate(addr1);
 
     EXPECT_EQ(bs.allocated(), 10*NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -963,7 +976,7 @@ TEST(Deallocate, Reallocate_1stBlock_FreeList4)
 
     EXPECT_EQ(addr2, addr1);
     EXPECT_EQ(bs.allocated(), bs.length());
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -993,7 +1006,7 @@ TEST(Deallocate, Reallocate_6thBlock_FreeList4)
 
     EXPECT_EQ(addr2, addr1);
     EXPECT_EQ(bs.allocated(), bs.length());
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1023,7 +1036,7 @@ TEST(Deallocate, Reallocate_10thBlock_FreeList4)
 
     EXPECT_EQ(addr2, addr1);
     EXPECT_EQ(bs.allocated(), bs.length());
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1053,7 +1066,7 @@ TEST(Deallocate, Reallocate_1stBlock_FreeList3)
 
     EXPECT_EQ(addr2, addr1);
     EXPECT_EQ(bs.allocated(), bs.length());
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1083,7 +1096,7 @@ TEST(Deallocate, Reallocate_6thBlock_FreeList3)
 
     EXPECT_EQ(addr2, addr1);
     EXPECT_EQ(bs.allocated(), bs.length());
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1113,7 +1126,7 @@ TEST(Deallocate, Reallocate_10thBlock_FreeList3)
 
     EXPECT_EQ(addr2, addr1);
     EXPECT_EQ(bs.allocated(), bs.length());
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1143,7 +1156,7 @@ TEST(Deallocate, Reallocate_1stBlock_FreeList2)
 
     EXPECT_EQ(addr2, addr1);
     EXPECT_EQ(bs.allocated(), bs.length());
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1173,7 +1186,7 @@ TEST(Deallocate, Reallocate_6thBlock_FreeList2)
 
     EXPECT_EQ(addr2, addr1);
     EXPECT_EQ(bs.allocated(), bs.length());
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1203,7 +1216,7 @@ TEST(Deallocate, Reallocate_10thBlock_FreeList2)
 
     EXPECT_EQ(addr2, addr1);
     EXPECT_EQ(bs.allocated(), bs.length());
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1233,7 +1246,7 @@ TEST(Deallocate, Reallocate_1stBlock_FreeList1)
 
     EXPECT_EQ(addr2, addr1);
     EXPECT_EQ(bs.allocated(), bs.length());
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1263,7 +1276,7 @@ TEST(Deallocate, Reallocate_6thBlock_FreeList1)
 
     EXPECT_EQ(addr2, addr1);
     EXPECT_EQ(bs.allocated(), bs.length());
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1293,7 +1306,7 @@ TEST(Deallocate, Reallocate_10thBlock_FreeList1)
 
     EXPECT_EQ(addr2, addr1);
     EXPECT_EQ(bs.allocated(), bs.length());
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1313,7 +1326,7 @@ TEST(Deallocate, Blocksize4_OrderA)
 
     EXPECT_EQ(bs.allocated(), (3*NODESIZE) + bs.block_lengths()[3]);
     EXPECT_EQ(bs.free_list4().head(), reinterpret_cast<void*>(addr1)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 2);
+    EXPECT_EQ(bs.free_blocks4(), 2);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1333,7 +1346,7 @@ TEST(Deallocate, Blocksize4_OrderB)
 
     EXPECT_EQ(bs.allocated(), (3*NODESIZE) + bs.block_lengths()[3]);
     EXPECT_EQ(bs.free_list4().head(), reinterpret_cast<void*>(addr1)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 2);
+    EXPECT_EQ(bs.free_blocks4(), 2);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1353,7 +1366,7 @@ TEST(Deallocate, Blocksize4_OrderC)
 
     EXPECT_EQ(bs.allocated(), (3*NODESIZE) + bs.block_lengths()[3]);
     EXPECT_EQ(bs.free_list4().head(), reinterpret_cast<void*>(addr1)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 2);
+    EXPECT_EQ(bs.free_blocks4(), 2);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1373,7 +1386,7 @@ TEST(Deallocate, Blocksize4_OrderD)
 
     EXPECT_EQ(bs.allocated(), (3*NODESIZE) + bs.block_lengths()[3]);
     EXPECT_EQ(bs.free_list4().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 2);
+    EXPECT_EQ(bs.free_blocks4(), 2);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1393,7 +1406,7 @@ TEST(Deallocate, Blocksize4_OrderE)
 
     EXPECT_EQ(bs.allocated(), (3*NODESIZE) + bs.block_lengths()[3]);
     EXPECT_EQ(bs.free_list4().head(), reinterpret_cast<void*>(addr1)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 2);
+    EXPECT_EQ(bs.free_blocks4(), 2);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1413,7 +1426,7 @@ TEST(Deallocate, Blocksize4_OrderF)
 
     EXPECT_EQ(bs.allocated(), (3*NODESIZE) + bs.block_lengths()[3]);
     EXPECT_EQ(bs.free_list4().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 2);
+    EXPECT_EQ(bs.free_blocks4(), 2);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1433,7 +1446,7 @@ TEST(Deallocate, Blocksize3_OrderA)
 
     EXPECT_EQ(bs.allocated(), (3*NODESIZE) + bs.block_lengths()[2]);
     EXPECT_EQ(bs.free_list3().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 2);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1453,7 +1466,7 @@ TEST(Deallocate, Blocksize3_OrderB)
 
     EXPECT_EQ(bs.allocated(), (2*NODESIZE) + bs.block_lengths()[2]);
     EXPECT_EQ(bs.free_list4().head(), reinterpret_cast<void*>(addr3)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 1);
+    EXPECT_EQ(bs.free_blocks4(), 1);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1473,7 +1486,7 @@ TEST(Deallocate, Blocksize3_OrderC)
 
     EXPECT_EQ(bs.allocated(), (3*NODESIZE) + bs.block_lengths()[2]);
     EXPECT_EQ(bs.free_list3().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 2);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1493,7 +1506,7 @@ TEST(Deallocate, Blocksize3_OrderD)
 
     EXPECT_EQ(bs.allocated(), (2*NODESIZE) + bs.block_lengths()[2]);
     EXPECT_EQ(bs.free_list4().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 1);
+    EXPECT_EQ(bs.free_blocks4(), 1);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1513,7 +1526,7 @@ TEST(Deallocate, Blocksize3_OrderE)
 
     EXPECT_EQ(bs.allocated(), (2*NODESIZE) + bs.block_lengths()[2]);
     EXPECT_EQ(bs.free_list4().head(), reinterpret_cast<void*>(addr3)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 1);
+    EXPECT_EQ(bs.free_blocks4(), 1);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1533,7 +1546,7 @@ TEST(Deallocate, Blocksize3_OrderF)
 
     EXPECT_EQ(bs.allocated(), (2*NODESIZE) + bs.block_lengths()[2]);
     EXPECT_EQ(bs.free_list4().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 1);
+    EXPECT_EQ(bs.free_blocks4(), 1);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1553,7 +1566,7 @@ TEST(Deallocate, Blocksize2_OrderA)
 
     EXPECT_EQ(bs.allocated(), (3*NODESIZE) + bs.block_lengths()[1]);
     EXPECT_EQ(bs.free_list2().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 2);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1573,7 +1586,7 @@ TEST(Deallocate, Blocksize2_OrderB)
 
     EXPECT_EQ(bs.allocated(), (2*NODESIZE) + bs.block_lengths()[1]);
     EXPECT_EQ(bs.free_list3().head(), reinterpret_cast<void*>(addr3)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 1);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1593,7 +1606,7 @@ TEST(Deallocate, Blocksize2_OrderC)
 
     EXPECT_EQ(bs.allocated(), (3*NODESIZE) + bs.block_lengths()[1]);
     EXPECT_EQ(bs.free_list2().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 2);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1613,7 +1626,7 @@ TEST(Deallocate, Blocksize2_OrderD)
 
     EXPECT_EQ(bs.allocated(), (2*NODESIZE) + bs.block_lengths()[1]);
     EXPECT_EQ(bs.free_list3().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 1);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1633,7 +1646,7 @@ TEST(Deallocate, Blocksize2_OrderE)
 
     EXPECT_EQ(bs.allocated(), (2*NODESIZE) + bs.block_lengths()[1]);
     EXPECT_EQ(bs.free_list3().head(), reinterpret_cast<void*>(addr3)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 1);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1653,7 +1666,7 @@ TEST(Deallocate, Blocksize2_OrderF)
 
     EXPECT_EQ(bs.allocated(), (2*NODESIZE) + bs.block_lengths()[1]);
     EXPECT_EQ(bs.free_list3().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 1);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1673,7 +1686,7 @@ TEST(Deallocate, Blocksize1_OrderA)
 
     EXPECT_EQ(bs.allocated(), (3*NODESIZE) + bs.block_lengths()[0]);
     EXPECT_EQ(bs.free_list1().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 2);
@@ -1693,7 +1706,7 @@ TEST(Deallocate, Blocksize1_OrderB)
 
     EXPECT_EQ(bs.allocated(), (2*NODESIZE) + bs.block_lengths()[0]);
     EXPECT_EQ(bs.free_list2().head(), reinterpret_cast<void*>(addr3)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 1);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1713,7 +1726,7 @@ TEST(Deallocate, Blocksize1_OrderC)
 
     EXPECT_EQ(bs.allocated(), (3*NODESIZE) + bs.block_lengths()[0]);
     EXPECT_EQ(bs.free_list1().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 0);
     EXPECT_EQ(bs.free_list1().count(), 2);
@@ -1733,7 +1746,7 @@ TEST(Deallocate, Blocksize1_OrderD)
 
     EXPECT_EQ(bs.allocated(), (2*NODESIZE) + bs.block_lengths()[0]);
     EXPECT_EQ(bs.free_list2().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 1);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1753,7 +1766,7 @@ TEST(Deallocate, Blocksize1_OrderE)
 
     EXPECT_EQ(bs.allocated(), (2*NODESIZE) + bs.block_lengths()[0]);
     EXPECT_EQ(bs.free_list2().head(), reinterpret_cast<void*>(addr3)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 1);
     EXPECT_EQ(bs.free_list1().count(), 0);
@@ -1773,8 +1786,397 @@ TEST(Deallocate, Blocksize1_OrderF)
 
     EXPECT_EQ(bs.allocated(), (2*NODESIZE) + bs.block_lengths()[0]);
     EXPECT_EQ(bs.free_list2().head(), reinterpret_cast<void*>(addr2)-NODESIZE);
-    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 0);
     EXPECT_EQ(bs.free_list3().count(), 0);
     EXPECT_EQ(bs.free_list2().count(), 1);
     EXPECT_EQ(bs.free_list1().count(), 0);
-}
\ No newline at end of file
+}
+
+TEST(Stats, SplitMerge)
+{
+    std::array<std::uint8_t, 64+(8*NODESIZE)> arr;
+    BuddySystemMemoryAllocator<8, AllocatorStats> bs(arr);
+
+    void* block = bs.allocate(8);
+
+    EXPECT_EQ(bs.stats().splits(), 3);
+    EXPECT_EQ(bs.stats().allocations(AllocatorStats::bucket_of(8)), 1);
+    EXPECT_EQ(bs.stats().payload_bytes(), 8);
+    EXPECT_EQ(bs.stats().metadata_bytes(), 4*NODESIZE);
+
+    bs.deallocate(block);
+
+    EXPECT_EQ(bs.stats().merges(), 3);
+    EXPECT_EQ(bs.stats().payload_bytes(), 0);
+    EXPECT_EQ(bs.stats().metadata_bytes(), NODESIZE);
+    EXPECT_EQ(bs.stats().free_bytes(), 64 + (7*NODESIZE));
+    EXPECT_EQ(bs.allocate(bs.block_lengths()[3] + 1), nullptr);
+    EXPECT_EQ(bs.stats().failed_allocations(), 1);
+}
+
+TEST(Fragmentation, Internal)
+{
+    std::array<std::uint8_t, 64+(8*NODESIZE)> arr;
+    BuddySystemMemoryAllocator<8, AllocatorStats> bs(arr);
+
+    void* block1 = bs.allocate(5);
+    void* block2 = bs.allocate(20);
+
+    EXPECT_EQ(bs.stats().internal_fragmentation(), 3 + (bs.block_lengths()[1] - 20));
+    EXPECT_EQ(bs.stats().free_blocks(), 2);
+    EXPECT_EQ(bs.stats().free_histogram(AllocatorStats::bucket_of(8)), 1);
+    EXPECT_EQ(bs.largest_free_block(), bs.block_lengths()[2]);
+
+    bs.deallocate(block1);
+    bs.deallocate(block2);
+
+    EXPECT_EQ(bs.stats().internal_fragmentation(), 0);
+    EXPECT_EQ(bs.stats().free_blocks(), 1);
+    EXPECT_EQ(bs.largest_free_block(), bs.block_lengths()[3]);
+    EXPECT_EQ(bs.external_fragmentation(), 0);
+}
+
+TEST(Walk, Levels)
+{
+    std::array<std::uint8_t, 80+(80*NODESIZE)> arr;
+    BuddySystemMemoryAllocator<1> bs(arr);
+
+    bs.allocate(1);
+
+    std::vector<HeapBlock> blocks;
+    bs.walk([&](const HeapBlock& b) { blocks.push_back(b); });
+
+    ASSERT_EQ(blocks.size(), 13);
+    EXPECT_EQ(blocks[0].level, 0);
+    EXPECT_FALSE(blocks[0].free);
+    EXPECT_EQ(blocks[1].level, 0);
+    EXPECT_TRUE(blocks[1].free);
+    EXPECT_EQ(blocks[2].level, 1);
+    EXPECT_EQ(blocks[3].level, 2);
+    for (std::size_t i=4; i<blocks.size(); i++)
+    {
+        EXPECT_EQ(blocks[i].level, 3);
+        EXPECT_TRUE(blocks[i].free);
+    }
+
+    std::size_t bytes = 0;
+    for (const HeapBlock& b : blocks)
+    {
+        EXPECT_EQ(b.addr, arr.data() + bytes);
+        EXPECT_EQ(b.bytes, bs.block_lengths()[b.level] + NODESIZE);
+        bytes += b.bytes;
+    }
+    EXPECT_EQ(bytes, sizeof(arr));
+}
+
+TEST(Compact, SplitMerge)
+{
+    using CompactBuddy = BuddySystemMemoryAllocator<8, AllocatorStats, true>;
+    const std::size_t compact_node_size = CompactBuddy::node_size;
+    EXPECT_EQ(compact_node_size, 8);
+
+    std::array<std::uint8_t, 64+(8*compact_node_size)> arr;
+    CompactBuddy bs(arr);
+
+    EXPECT_EQ(bs.block_lengths()[3], 64+(7*compact_node_size));
+    EXPECT_EQ(bs.free_blocks4(), 1);
+
+    void* block1 = bs.allocate(8);
+    void* block2 = bs.allocate(3);
+
+    EXPECT_EQ(block1, arr.data() + compact_node_size);
+    EXPECT_EQ(block2, block1 + 8 + compact_node_size);
+    EXPECT_EQ(bs.stats().splits(), 3);
+    EXPECT_EQ(bs.stats().payload_bytes(), 16);
+    EXPECT_EQ(bs.stats().internal_fragmentation(), 5);
+
+    bs.deallocate(block1);
+    bs.deallocate(block2);
+
+    EXPECT_EQ(bs.stats().merges(), 3);
+    EXPECT_EQ(bs.stats().payload_bytes(), 0);
+    EXPECT_EQ(bs.stats().internal_fragmentation(), 0);
+    EXPECT_EQ(bs.allocated(), compact_node_size);
+    EXPECT_EQ(bs.free_blocks4(), 1);
+    EXPECT_EQ(bs.free_list1().count(), 0);
+}
+
+TEST(Watermarks, PingPong)
+{
+    std::array<std::uint8_t, 4*(64+(8*NODESIZE))> arr;
+    BuddySystemMemoryAllocator<8, AllocatorStats> bs(arr);
+
+    bs.set_watermarks(0, 0, 2);
+
+    void* block = bs.allocate(8);
+    EXPECT_EQ(bs.stats().splits(), 3);
+    EXPECT_EQ(bs.free_list1().count(), 1);
+
+    // The freed block is kept in the smallest free list rather than merged, so it's split only once.
+    for (int i=0; i<100; i++)
+    {
+        bs.deallocate(block);
+        EXPECT_EQ(bs.free_list1().count(), 2);
+
+        block = bs.allocate(8);
+        EXPECT_EQ(bs.free_list1().count(), 1);
+    }
+
+    EXPECT_EQ(bs.stats().splits(), 3);
+    EXPECT_EQ(bs.stats().merges(), 0);
+}
+
+TEST(Watermarks, BatchRefill)
+{
+    std::array<std::uint8_t, 4*(64+(8*NODESIZE))> arr;
+    BuddySystemMemoryAllocator<8, AllocatorStats> bs(arr);
+
+    bs.set_watermarks(0, 2, 6);
+
+    std::vector<void*> blocks;
+    blocks.push_back(bs.allocate(8));
+
+    // Split until the smallest free list holds 6 blocks, and then take 1.
+    EXPECT_EQ(bs.stats().splits(), 6);
+    EXPECT_EQ(bs.free_list1().count(), 5);
+    EXPECT_EQ(bs.free_list2().count(), 1);
+    EXPECT_EQ(bs.free_list3().count(), 0);
+    EXPECT_EQ(bs.free_blocks4(), 3);
+
+    // No splits until it has fewer than 2.
+    for (int i=0; i<4; i++)
+    {
+        blocks.push_back(bs.allocate(8));
+    }
+    EXPECT_EQ(bs.stats().splits(), 6);
+    EXPECT_EQ(bs.free_list1().count(), 1);
+
+    blocks.push_back(bs.allocate(1));
+    EXPECT_GT(bs.stats().splits(), 6);
+    EXPECT_GE(bs.free_list1().count(), 5);
+
+    // Merged back into the largest blocks once the free list goes past it's high watermark.
+    for (void* block : blocks)
+    {
+        bs.deallocate(block);
+    }
+    EXPECT_LE(bs.free_list1().count(), 6);
+    EXPECT_GT(bs.stats().merges(), 0);
+}
+
+TEST(Watermarks, Default)
+{
+    std::array<std::uint8_t, 4*(64+(8*NODESIZE))> arr;
+    BuddySystemMemoryAllocator<8, AllocatorStats> bs(arr);
+
+    for (int i=0; i<10; i++)
+    {
+        bs.deallocate(bs.allocate(8));
+    }
+
+    EXPECT_EQ(bs.stats().splits(), 30);
+    EXPECT_EQ(bs.stats().merges(), 30);
+    EXPECT_EQ(bs.free_blocks4(), 4);
+}
+
+TEST(Lazy, Constructor)
+{
+    std::array<std::uint8_t, 640+(80*NODESIZE) + 32+(4*NODESIZE)> arr;
+    arr.fill(0xAB);
+
+    BuddySystemMemoryAllocator<8> bs(arr);
+
+    const std::size_t top_bytes = 10*(bs.block_lengths()[3] + NODESIZE);
+
+    // Only the node of the block at the end smaller than the largest is written.
+    EXPECT_EQ(bs.untouched_blocks(), 10);
+    EXPECT_EQ(bs.free_blocks4(), 10);
+    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_list3().count(), 1);
+    EXPECT_EQ(bs.allocated(), 11*NODESIZE);
+    for (std::size_t i=0; i<top_bytes; i++)
+    {
+        ASSERT_EQ(arr[i], 0xAB);
+    }
+
+    void* addr = bs.allocate(bs.block_lengths()[3]);
+
+    EXPECT_EQ(addr, arr.data() + NODESIZE);
+    EXPECT_EQ(bs.untouched_blocks(), 9);
+    EXPECT_EQ(bs.free_blocks4(), 9);
+    for (std::size_t i=bs.block_lengths()[3] + NODESIZE; i<top_bytes; i++)
+    {
+        ASSERT_EQ(arr[i], 0xAB);
+    }
+}
+
+TEST(Lazy, Reset)
+{
+    std::array<std::uint8_t, 640+(80*NODESIZE)> arr;
+    BuddySystemMemoryAllocator<8, AllocatorStats> bs(arr);
+
+    for (int i=0; i<5; i++)
+    {
+        bs.allocate(bs.block_lengths()[3]);
+        bs.allocate(1);
+    }
+    EXPECT_EQ(bs.untouched_blocks(), 4);
+
+    bs.reset();
+
+    EXPECT_EQ(bs.untouched_blocks(), 10);
+    EXPECT_EQ(bs.free_list4().count(), 0);
+    EXPECT_EQ(bs.free_list1().count(), 0);
+    EXPECT_EQ(bs.allocated(), 10*NODESIZE);
+    EXPECT_EQ(bs.stats().free_blocks(), 10);
+    EXPECT_EQ(bs.largest_free_block(), bs.block_lengths()[3]);
+    EXPECT_EQ(bs.allocate(1), arr.data() + NODESIZE);
+}
+
+TEST(Runs, Allocate)
+{
+    alignas(8) std::array<std::uint8_t, 8+640+(80*NODESIZE)> arr;
+    BuddySystemMemoryAllocator<8, NoStats, false, true> bs(arr);
+
+    const std::size_t top_bytes = bs.block_lengths()[3] + NODESIZE;
+
+    // The bitmap of blocks of the largest size is before the first block.
+    EXPECT_EQ(bs.allocated(), 8+(10*NODESIZE));
+    EXPECT_EQ(bs.free_blocks4(), 10);
+
+    EXPECT_EQ(bs.allocate((3*top_bytes) - NODESIZE), arr.data() + 8 + NODESIZE);
+    EXPECT_EQ(bs.allocate(top_bytes), arr.data() + 8 + (3*top_bytes) + NODESIZE);
+    EXPECT_EQ(bs.allocate(bs.block_lengths()[3]), arr.data() + 8 + (5*top_bytes) + NODESIZE);
+
+    EXPECT_EQ(bs.free_blocks4(), 4);
+    EXPECT_EQ(bs.allocated(), 8+(10*NODESIZE) + (6*bs.block_lengths()[3]));
+}
+
+TEST(Runs, Deallocate)
+{
+    alignas(8) std::array<std::uint8_t, 8+640+(80*NODESIZE)> arr;
+    BuddySystemMemoryAllocator<8, NoStats, false, true> bs(arr);
+
+    const std::size_t top_bytes = bs.block_lengths()[3] + NODESIZE;
+    const std::size_t allocated_bytes = bs.allocated();
+
+    void* run = bs.allocate(4*top_bytes);
+    void* top = bs.allocate(bs.block_lengths()[3]);
+
+    bs.deallocate(run);
+
+    // The run is split back into 5 blocks of the largest size.
+    EXPECT_EQ(bs.free_list4().count(), 5);
+    EXPECT_EQ(bs.free_blocks4(), 9);
+    EXPECT_EQ(bs.allocate(1), arr.data() + 8 + NODESIZE);
+
+    bs.deallocate(top);
+    bs.reset();
+
+    EXPECT_EQ(bs.allocated(), allocated_bytes);
+    EXPECT_EQ(bs.allocate(9*top_bytes), arr.data() + 8 + NODESIZE);
+}
+
+TEST(Runs, SkipsUsedBlocks)
+{
+    alignas(8) std::array<std::uint8_t, 8+640+(80*NODESIZE)> arr;
+    BuddySystemMemoryAllocator<8, NoStats, false, true> bs(arr);
+
+    const std::size_t top_bytes = bs.block_lengths()[3] + NODESIZE;
+
+    std::array<void*, 10> addrs;
+    for (std::size_t i=0; i<10; i++)
+    {
+        addrs[i] = bs.allocate(bs.block_lengths()[3]);
+    }
+
+    for (std::size_t i : {1, 3, 4, 6, 7, 8})
+    {
+        bs.deallocate(addrs[i]);
+    }
+
+    EXPECT_EQ(bs.allocate(4*top_bytes), nullptr);
+    EXPECT_EQ(bs.allocate(2*top_bytes), addrs[6]);
+    EXPECT_EQ(bs.allocate(top_bytes), addrs[3]);
+    EXPECT_EQ(bs.allocate(top_bytes), nullptr);
+    EXPECT_EQ(bs.free_list4().count(), 1);
+}
+
+TEST(Runs, SplitBlocks)
+{
+    alignas(8) std::array<std::uint8_t, 8+640+(80*NODESIZE)> arr;
+    BuddySystemMemoryAllocator<8, NoStats, false, true> bs(arr);
+
+    const std::size_t top_bytes = bs.block_lengths()[3] + NODESIZE;
+
+    // Blocks split into smaller ones aren't part of a run until they are merged again.
+    void* small = bs.allocate(1);
+
+    EXPECT_EQ(bs.allocate(9*top_bytes), nullptr);
+    EXPECT_EQ(bs.allocate(8*top_bytes), arr.data() + 8 + top_bytes + NODESIZE);
+
+    bs.deallocate(small);
+
+    EXPECT_EQ(bs.free_list4().count(), 1);
+    EXPECT_EQ(bs.allocate((2*top_bytes) - NODESIZE), nullptr);
+}
+
+TEST(Runs, Walk)
+{
+    alignas(8) std::array<std::uint8_t, 8+640+(80*NODESIZE)> arr;
+    BuddySystemMemoryAllocator<8, AllocatorStats, false, true> bs(arr);
+
+    const std::size_t top_bytes = bs.block_lengths()[3] + NODESIZE;
+
+    bs.allocate(bs.block_lengths()[3]);
+    bs.allocate(3*top_bytes);
+
+    std::vector<HeapBlock> blocks;
+    bs.walk([&](const HeapBlock& b) { blocks.push_back(b); });
+
+    ASSERT_EQ(blocks.size(), 7);
+    EXPECT_EQ(blocks[0].addr, arr.data() + 8);
+    EXPECT_FALSE(blocks[1].free);
+    EXPECT_EQ(blocks[1].level, 3);
+    EXPECT_EQ(blocks[1].bytes, 4*top_bytes);
+    EXPECT_TRUE(blocks[2].free);
+    EXPECT_EQ(blocks[2].addr, arr.data() + 8 + (5*top_bytes));
+
+    EXPECT_EQ(bs.stats().free_blocks(), 5);
+    // The nodes inside the run are part of it's payload.
+    EXPECT_EQ(bs.stats().payload_bytes(), (5*bs.block_lengths()[3]) + (3*NODESIZE));
+    EXPECT_EQ(bs.stats().metadata_bytes(), 8+(7*NODESIZE));
+}
+
+TEST(Runs, HugeRequest)
+{
+    alignas(8) std::array<std::uint8_t, 8+640+(80*NODESIZE)> arr;
+    BuddySystemMemoryAllocator<8, NoStats, false, true> bs(arr);
+
+    const std::size_t top_bytes = bs.block_lengths()[3] + NODESIZE;
+
+    // Requests near SIZE_MAX fail rather than wrapping round to a run of 0 or 1 blocks.
+    EXPECT_EQ(bs.allocate(SIZE_MAX), nullptr);
+    EXPECT_EQ(bs.allocate(SIZE_MAX - 100), nullptr);
+    EXPECT_EQ(bs.allocate((10*top_bytes) - NODESIZE + 1), nullptr);
+    EXPECT_EQ(bs.allocate((10*top_bytes) - NODESIZE), arr.data() + 8 + NODESIZE);
+}
+
+TEST(Runs, UnalignedBuffer)
+{
+    alignas(8) std::array<std::uint8_t, 8+8+640+(80*NODESIZE)> arr;
+    BuddySystemMemoryAllocator<8, AllocatorStats, false, true> bs(arr.data() + 3, arr.size() - 3);
+
+    const std::size_t top_bytes = bs.block_lengths()[3] + NODESIZE;
+
+    // The bitmap starts at the first address aligned for it's words, and the blocks after it.
+    EXPECT_EQ(bs.allocated(), 5+8+(10*NODESIZE));
+    EXPECT_EQ(bs.allocate(top_bytes), arr.data() + 8 + 8 + NODESIZE);
+
+    void* run = bs.allocate(2*top_bytes);
+    EXPECT_EQ(run, arr.data() + 8 + 8 + (2*top_bytes) + NODESIZE);
+
+    bs.deallocate(run);
+    EXPECT_EQ(bs.free_blocks4(), 8);
+    EXPECT_EQ(bs.stats().metadata_bytes(), 5+8+(9*NODESIZE));
+}
@@ -0,0 +1,232 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "BuddySystem/out_of_band_buddy_allocator.h"
+
+// Returns true if 'addr' is a multiple of 'alignment'.
+bool aligned(void* addr, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(addr) % alignment == 0;
+}
+
+TEST(Constructor, Tiling)
+{
+    alignas(64) std::array<std::uint8_t, 64*20> arr;
+
+    OutOfBandBuddyAllocator<8> bb(arr);
+
+    EXPECT_EQ(bb.block_lengths()[0], 8);
+    EXPECT_EQ(bb.block_lengths()[3], 64);
+    EXPECT_EQ(bb.metadata_bytes() % 64, 0);
+    EXPECT_EQ(bb.allocated(), bb.metadata_bytes());
+
+    // The side table is 7 words of bitmap, 4 words of summary and a byte for each of the 160 smallest
+    //  blocks, 248 bytes, which the blocks are aligned after.
+    EXPECT_EQ(bb.metadata_bytes(), 256);
+    EXPECT_EQ(bb.free_blocks(3), 16);
+    EXPECT_EQ(bb.free_blocks(2), 0);
+    EXPECT_EQ(bb.free_blocks(1), 0);
+    EXPECT_EQ(bb.free_blocks(0), 0);
+}
+
+TEST(Constructor, Rem)
+{
+    alignas(64) std::array<std::uint8_t, 64*20 + 56> arr;
+
+    OutOfBandBuddyAllocator<8> bb(arr);
+
+    EXPECT_EQ(bb.metadata_bytes(), 256);
+    EXPECT_EQ(bb.free_blocks(3), 16);
+    EXPECT_EQ(bb.free_blocks(2), 1);
+    EXPECT_EQ(bb.free_blocks(1), 1);
+    EXPECT_EQ(bb.free_blocks(0), 1);
+}
+
+TEST(Allocate, SplitsLowest)
+{
+    alignas(64) std::array<std::uint8_t, 64*20> arr;
+    OutOfBandBuddyAllocator<8> bb(arr);
+
+    void* block = bb.allocate(1);
+
+    EXPECT_EQ(block, arr.data() + bb.metadata_bytes());
+    EXPECT_EQ(bb.free_blocks(3), 15);
+    EXPECT_EQ(bb.free_blocks(2), 1);
+    EXPECT_EQ(bb.free_blocks(1), 1);
+    EXPECT_EQ(bb.free_blocks(0), 1);
+    EXPECT_EQ(bb.allocated(), bb.metadata_bytes() + 8);
+
+    EXPECT_EQ(bb.allocate(8), block + 8);
+    EXPECT_EQ(bb.allocate(16), block + 16);
+    EXPECT_EQ(bb.allocate(32), block + 32);
+    EXPECT_EQ(bb.allocate(33), block + 64);
+    EXPECT_EQ(bb.allocate(65), nullptr);
+    EXPECT_EQ(bb.allocate(0), nullptr);
+}
+
+TEST(Allocate, NaturallyAligned)
+{
+    std::vector<std::uint8_t> buffer(10000 + 3);
+    OutOfBandBuddyAllocator<16> bb(buffer.data() + 3, 10000);
+
+    srand(1);
+    for (int i=0; i<500; i++)
+    {
+        const std::size_t bytes = 1 + rand() % 128;
+        void* block = bb.allocate(bytes);
+        if (block == nullptr)
+        {
+            break;
+        }
+
+        std::size_t size = 16;
+        while (size < bytes)
+        {
+            size *= 2;
+        }
+        EXPECT_TRUE(aligned(block, size));
+    }
+}
+
+TEST(Allocate, NoSpace)
+{
+    alignas(64) std::array<std::uint8_t, 64*4> arr;
+    OutOfBandBuddyAllocator<8> bb(arr);
+
+    // 96 bytes of side table, aligned to 128, leave 2 blocks of 64 bytes.
+    std::size_t count = 0;
+    while (bb.allocate(8) != nullptr)
+    {
+        count++;
+    }
+
+    EXPECT_EQ(count, 16);
+    EXPECT_EQ(bb.largest_free_block(), 0);
+}
+
+TEST(Deallocate, MergesBack)
+{
+    alignas(64) std::array<std::uint8_t, 64*20> arr;
+    OutOfBandBuddyAllocator<8> bb(arr);
+
+    std::vector<void*> blocks;
+    for (std::size_t i=0; i<8; i++)
+    {
+        blocks.push_back(bb.allocate(8));
+    }
+    EXPECT_EQ(bb.free_blocks(3), 15);
+
+    for (std::size_t i : {6, 1, 3, 0, 7, 2, 4})
+    {
+        bb.deallocate(blocks[i]);
+    }
+    EXPECT_EQ(bb.free_blocks(0), 1);
+    EXPECT_EQ(bb.free_blocks(1), 1);
+    EXPECT_EQ(bb.free_blocks(2), 1);
+    EXPECT_EQ(bb.free_blocks(3), 15);
+
+    bb.deallocate(blocks[5]);
+    EXPECT_EQ(bb.free_blocks(0), 0);
+    EXPECT_EQ(bb.free_blocks(1), 0);
+    EXPECT_EQ(bb.free_blocks(2), 0);
+    EXPECT_EQ(bb.free_blocks(3), 16);
+    EXPECT_EQ(bb.allocated(), bb.metadata_bytes());
+}
+
+// Splitting and merging only change the side table, so nothing is written to the blocks.
+TEST(Deallocate, BlocksUntouched)
+{
+    alignas(64) std::array<std::uint8_t, 64*40> arr;
+    OutOfBandBuddyAllocator<8> bb(arr);
+
+    const std::size_t table = bb.metadata_bytes();
+    std::memset(arr.data() + table, 0xAB, arr.size() - table);
+
+    std::array<void*, 50> blocks{};
+    srand(3);
+    for (int i=0; i<5000; i++)
+    {
+        const std::size_t b = rand() % blocks.size();
+        if (blocks[b] == nullptr)
+        {
+            blocks[b] = bb.allocate(1 + rand() % 64);
+        }
+        else
+        {
+            bb.deallocate(blocks[b]);
+            blocks[b] = nullptr;
+        }
+    }
+
+    for (std::size_t i=table; i<arr.size(); i++)
+    {
+        ASSERT_EQ(arr[i], 0xAB);
+    }
+}
+
+TEST(Reset, AllFree)
+{
+    alignas(64) std::array<std::uint8_t, 64*20 + 24> arr;
+    OutOfBandBuddyAllocator<8> bb(arr);
+
+    while (bb.allocate(24) != nullptr);
+    bb.reset();
+
+    EXPECT_EQ(bb.allocated(), bb.metadata_bytes());
+    EXPECT_EQ(bb.free_blocks(3), 16);
+    EXPECT_EQ(bb.free_blocks(1), 1);
+    EXPECT_EQ(bb.free_blocks(0), 1);
+}
+
+TEST(Stats, AllocateDeallocate)
+{
+    alignas(64) std::array<std::uint8_t, 64*4> arr;
+    OutOfBandBuddyAllocator<8, AllocatorStats> bb(arr);
+
+    void* block = bb.allocate(5);
+
+    EXPECT_EQ(bb.stats().allocations(AllocatorStats::bucket_of(8)), 1);
+    EXPECT_EQ(bb.stats().payload_bytes(), 8);
+    EXPECT_EQ(bb.stats().metadata_bytes(), 128);
+    EXPECT_EQ(bb.stats().splits(), 3);
+    EXPECT_EQ(bb.stats().free_blocks(), 4);
+
+    bb.deallocate(block);
+
+    EXPECT_EQ(bb.stats().merges(), 3);
+    EXPECT_EQ(bb.stats().free_blocks(), 2);
+    EXPECT_EQ(bb.stats().free_bytes(), 2*64);
+    EXPECT_EQ(bb.external_fragmentation(), 0.5);
+}
+
+TEST(Walk, Blocks)
+{
+    alignas(64) std::array<std::uint8_t, 64*4> arr;
+    OutOfBandBuddyAllocator<8> bb(arr);
+
+    void* block = bb.allocate(8);
+    bb.allocate(16);
+
+    std::vector<HeapBlock> blocks;
+    bb.walk([&](const HeapBlock& b) { blocks.push_back(b); });
+
+    ASSERT_EQ(blocks.size(), 5);
+    EXPECT_EQ(blocks[0].addr, block);
+    EXPECT_FALSE(blocks[0].free);
+    EXPECT_EQ(blocks[0].level, 0);
+    EXPECT_TRUE(blocks[1].free);
+    EXPECT_EQ(blocks[1].bytes, 8);
+    EXPECT_FALSE(blocks[2].free);
+    EXPECT_EQ(blocks[2].level, 1);
+    EXPECT_TRUE(blocks[3].free);
+    EXPECT_EQ(blocks[3].level, 2);
+    EXPECT_TRUE(blocks[4].free);
+    EXPECT_EQ(blocks[4].bytes, 64);
+    EXPECT_EQ(blocks[4].addr, block + 64);
+}
@@ -0,0 +1,173 @@
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "Composition/bucketizer.h"
+#include "Composition/fallback_allocator.h"
+#include "Composition/segregator.h"
+#include "FirstFit/first_fit_memory_allocator.h"
+#include "PoolAllocation/pool_allocation_memory_allocator.h"
+#include "BuddySystem/buddy_system_memory_allocator.h"
+
+const std::size_t NODESIZE_FF = FirstFitMemoryAllocator::node_size;
+const std::size_t NODESIZE_PA = PoolAllocationMemoryAllocator<0>::node_size;
+
+using SmallLarge = Segregator<8, PoolAllocationMemoryAllocator<8>, FirstFitMemoryAllocator>;
+
+TEST(Segregator, AllocateSmall)
+{
+    std::array<std::uint8_t, (8+NODESIZE_PA)*10> arr1;
+    std::array<std::uint8_t, 256> arr2;
+    SmallLarge s(arr1, arr2);
+
+    void* addr = s.allocate(8);
+
+    EXPECT_EQ(addr, reinterpret_cast<void*>(arr1.data()) + NODESIZE_PA);
+    EXPECT_TRUE(s.owns(addr));
+    EXPECT_EQ(s.small_allocator().allocated_blocks(), 1);
+    EXPECT_EQ(s.large_allocator().allocated(), NODESIZE_FF);
+}
+
+TEST(Segregator, AllocateLarge)
+{
+    std::array<std::uint8_t, (8+NODESIZE_PA)*10> arr1;
+    std::array<std::uint8_t, 256> arr2;
+    SmallLarge s(arr1, arr2);
+
+    void* addr = s.allocate(9);
+
+    EXPECT_EQ(addr, reinterpret_cast<void*>(arr2.data()) + NODESIZE_FF);
+    EXPECT_EQ(s.small_allocator().allocated_blocks(), 0);
+    EXPECT_EQ(s.allocated(), (10*NODESIZE_PA) + 9 + (2*NODESIZE_FF));
+}
+
+TEST(Segregator, Deallocate)
+{
+    std::array<std::uint8_t, (8+NODESIZE_PA)*10> arr1;
+    std::array<std::uint8_t, 256> arr2;
+    SmallLarge s(arr1, arr2);
+
+    const std::size_t before = s.allocated();
+
+    void* small = s.allocate(4);
+    void* large = s.allocate(100);
+
+    s.deallocate(large);
+    s.deallocate(small);
+
+    EXPECT_EQ(s.allocated(), before);
+    EXPECT_EQ(s.length(), arr1.size() + arr2.size());
+    EXPECT_FALSE(s.owns(nullptr));
+}
+
+TEST(Segregator, Nested)
+{
+    std::array<std::uint8_t, (8+NODESIZE_PA)*10> arr1;
+    std::array<std::uint8_t, 1024> arr2;
+    std::array<std::uint8_t, 1024> arr3;
+    Segregator<128, Segregator<8, PoolAllocationMemoryAllocator<8>, BuddySystemMemoryAllocator<8>>, FirstFitMemoryAllocator> s(
+        std::piecewise_construct, std::forward_as_tuple(arr1, arr2), std::forward_as_tuple(arr3)
+        );
+
+    void* addr1 = s.allocate(8);
+    void* addr2 = s.allocate(64);
+    void* addr3 = s.allocate(256);
+
+    EXPECT_TRUE(s.small_allocator().small_allocator().owns(addr1));
+    EXPECT_TRUE(s.small_allocator().large_allocator().owns(addr2));
+    EXPECT_TRUE(s.large_allocator().owns(addr3));
+
+    const std::size_t before = s.allocated();
+    s.deallocate(addr2);
+    EXPECT_LT(s.allocated(), before);
+}
+
+TEST(FallbackAllocator, Fallback)
+{
+    std::array<std::uint8_t, (8+NODESIZE_PA)*2> arr1;
+    std::array<std::uint8_t, 256> arr2;
+    FallbackAllocator<PoolAllocationMemoryAllocator<8>, FirstFitMemoryAllocator> f(arr1, arr2);
+
+    void* addr1 = f.allocate(8);
+    void* addr2 = f.allocate(8);
+    void* addr3 = f.allocate(8);
+
+    EXPECT_TRUE(f.primary_allocator().owns(addr1));
+    EXPECT_TRUE(f.primary_allocator().owns(addr2));
+    EXPECT_TRUE(f.secondary_allocator().owns(addr3));
+
+    f.deallocate(addr3);
+    f.deallocate(addr1);
+
+    EXPECT_EQ(f.primary_allocator().allocated_blocks(), 1);
+    EXPECT_EQ(f.secondary_allocator().allocated(), NODESIZE_FF);
+}
+
+TEST(FallbackAllocator, Reset)
+{
+    std::array<std::uint8_t, (8+NODESIZE_PA)*2> arr1;
+    std::array<std::uint8_t, 256> arr2;
+    FallbackAllocator<PoolAllocationMemoryAllocator<8>, FirstFitMemoryAllocator> f(arr1, arr2);
+
+    const std::size_t before = f.allocated();
+
+    f.allocate(8);
+    f.allocate(8);
+    f.allocate(8);
+    f.reset();
+
+    EXPECT_EQ(f.allocated(), before);
+}
+
+TEST(Bucketizer, Buckets)
+{
+    std::array<std::uint8_t, 4096> arr;
+    Bucketizer<FirstFitMemoryAllocator, 1, 64, 16> b(arr);
+
+    EXPECT_EQ(b.bucket_count, 4);
+
+    void* addr1 = b.allocate(1);
+    void* addr2 = b.allocate(16);
+    void* addr3 = b.allocate(17);
+    void* addr4 = b.allocate(64);
+
+    EXPECT_TRUE(b.bucket(0).owns(addr1));
+    EXPECT_TRUE(b.bucket(0).owns(addr2));
+    EXPECT_TRUE(b.bucket(1).owns(addr3));
+    EXPECT_TRUE(b.bucket(3).owns(addr4));
+    EXPECT_EQ(b.allocate(65), nullptr);
+    EXPECT_EQ(b.allocate(0), nullptr);
+}
+
+TEST(Bucketizer, Deallocate)
+{
+    std::array<std::uint8_t, 4096> arr;
+    Bucketizer<FirstFitMemoryAllocator, 1, 64, 16> b(arr);
+
+    const std::size_t before = b.allocated();
+
+    void* addr1 = b.allocate(8);
+    void* addr2 = b.allocate(40);
+
+    b.deallocate(addr2);
+    b.deallocate(addr1);
+
+    EXPECT_EQ(b.allocated(), before);
+    EXPECT_EQ(b.allocated(), 4*NODESIZE_FF);
+}
+
+TEST(Adapter, Composition)
+{
+    std::array<std::uint8_t, (8+NODESIZE_PA)*10> arr1;
+    std::array<std::uint8_t, 256> arr2;
+    MemoryAllocatorAdapter<SmallLarge> s(arr1, arr2);
+    MemoryAllocator* ma = &s;
+
+    void* addr = ma->allocate(32);
+
+    EXPECT_TRUE(s.get().large_allocator().owns(addr));
+    EXPECT_EQ(ma->length(), arr1.size() + arr2.size());
+}
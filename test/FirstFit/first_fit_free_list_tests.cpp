@@ -293,4 +293,86 @@ TEST(Reset, Reuse)
     EXPECT_EQ(fl.count(), 2);
     EXPECT_EQ(node3, node1);
     EXPECT_EQ(node4, node2);
-}
\ No newline at end of file
+}
+
+TEST(TailNode, EmptyList)
+{
+    FirstFitFreeList fl;
+
+    EXPECT_EQ(fl.tail(), nullptr);
+}
+
+TEST(TailNode, AddEarlierAndLaterNodes)
+{
+    FirstFitFreeList fl;
+
+    std::array<std::uint8_t, 256> arr;
+    std::uint8_t* mem = arr.data();
+
+    FLNode* node1 = reinterpret_cast<FLNode*>(mem+50);
+    fl.add_node(node1);
+
+    FLNode* node2 = reinterpret_cast<FLNode*>(mem);
+    fl.add_node(node2);
+
+    EXPECT_EQ(fl.tail(), node1);
+
+    FLNode* node3 = reinterpret_cast<FLNode*>(mem+100);
+    fl.add_node(node3);
+
+    EXPECT_EQ(fl.tail(), node3);
+}
+
+TEST(TailNode, RemoveNodes)
+{
+    FirstFitFreeList fl;
+
+    std::array<std::uint8_t, 256> arr;
+    std::uint8_t* mem = arr.data();
+
+    FLNode* node1 = reinterpret_cast<FLNode*>(mem);
+    fl.add_node(node1);
+
+    FLNode* node2 = reinterpret_cast<FLNode*>(mem+50);
+    fl.add_node(node2);
+
+    fl.remove_node(node2);
+    EXPECT_EQ(fl.tail(), node1);
+
+    fl.remove_node(node1);
+    EXPECT_EQ(fl.tail(), nullptr);
+}
+
+TEST(Compact, AddRemoveNodes)
+{
+    using CompactNode = BasicFirstFitFreeList<true>::DLLNode;
+    EXPECT_EQ(sizeof(CompactNode), 12);
+
+    BasicFirstFitFreeList<true> fl;
+
+    alignas(4) std::array<std::uint8_t, 256> arr;
+    std::uint8_t* mem = arr.data();
+
+    CompactNode* node1 = reinterpret_cast<CompactNode*>(mem+100);
+    fl.add_node(node1);
+
+    CompactNode* node2 = reinterpret_cast<CompactNode*>(mem);
+    fl.add_node(node2);
+
+    CompactNode* node3 = reinterpret_cast<CompactNode*>(mem+52);
+    fl.add_node(node3);
+
+    EXPECT_EQ(fl.head(), node2);
+    EXPECT_EQ(node2->prev, nullptr);
+    EXPECT_EQ(node2->next, node3);
+    EXPECT_EQ(node3->prev, node2);
+    EXPECT_EQ(node3->next, node1);
+    EXPECT_EQ(node1->next, nullptr);
+    EXPECT_EQ(fl.tail(), node1);
+
+    fl.remove_node(node3);
+
+    EXPECT_EQ(node2->next, node1);
+    EXPECT_EQ(node1->prev, node2);
+    EXPECT_EQ(fl.count(), 2);
+}
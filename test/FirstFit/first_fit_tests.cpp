@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -24,6 +26,17 @@ TEST(Constructor, DWordArray)
     EXPECT_EQ(ff.length(), 1024);
 }
 
+TEST(Constructor, Region)
+{
+    std::array<std::uint8_t, 256> arr;
+
+    FirstFitMemoryAllocator ff(arr.data() + 64, 128);
+
+    EXPECT_EQ(ff.length(), 128);
+    EXPECT_EQ(ff.free_list().count(), 1);
+    EXPECT_EQ(ff.allocate(8), arr.data() + 64 + FirstFitMemoryAllocator::node_size);
+}
+
 TEST(Allocate, First)
 {
     std::array<std::uint8_t, 256> arr;
@@ -81,7 +94,7 @@ TEST(Allocate, HalfNodeSpace)
 
     ff.allocate(256-(1.5*ff.node_size));
 
-    EXPECT_EQ(ff.allocated(), ff.length()-0.5*ff.node_size);
+    EXPECT_EQ(ff.allocated(), ff.length());
     EXPECT_EQ(ff.free_list().count(), 0);
 }
 
@@ -246,4 +259,582 @@ TEST(Deallocate, Reallocate)
     EXPECT_EQ(block2 + ff.node_size + 32, block3);
     EXPECT_EQ(ff.free_list().count(), 2);
     EXPECT_EQ(ff.free_list().head()->value, 32);
-}
\ No newline at end of file
+}
+
+TEST(Stats, AllocateDeallocate)
+{
+    std::array<std::uint8_t, 256> arr;
+    BasicFirstFitMemoryAllocator<AllocatorStats> ff(arr);
+
+    void* block = ff.allocate(32);
+    ff.allocate(300);
+
+    EXPECT_EQ(ff.stats().allocations(AllocatorStats::bucket_of(32)), 1);
+    EXPECT_EQ(ff.stats().payload_bytes(), 32);
+    EXPECT_EQ(ff.stats().metadata_bytes(), 2*ff.node_size);
+    EXPECT_EQ(ff.stats().free_bytes(), 256 - 32 - 2*ff.node_size);
+    EXPECT_EQ(ff.stats().failed_allocations(), 1);
+    EXPECT_EQ(ff.stats().nodes_visited(), 2);
+
+    ff.deallocate(block);
+
+    EXPECT_EQ(ff.stats().deallocations(AllocatorStats::bucket_of(32)), 1);
+    EXPECT_EQ(ff.stats().payload_bytes(), 0);
+    EXPECT_EQ(ff.stats().metadata_bytes(), ff.node_size);
+    EXPECT_EQ(ff.stats().peak_bytes(), 32 + 2*ff.node_size);
+}
+
+TEST(Stats, LargestFreeRemoved)
+{
+    std::array<std::uint8_t, 1024> arr;
+    BasicFirstFitMemoryAllocator<AllocatorStats> ff(arr);
+
+    void* a = ff.allocate(100);
+    ff.allocate(8);
+    void* b = ff.allocate(60);
+    ff.allocate(8);
+    void* c = ff.allocate(80);
+    ff.allocate(8);
+    ff.allocate(ff.free_list().head()->value);
+
+    ff.deallocate(a);
+    ff.deallocate(b);
+    ff.deallocate(c);
+    EXPECT_EQ(ff.largest_free_block(), 100);
+
+    // Allocating the largest free block leaves a smaller one in it's size bucket, which is searched for
+    //  once.
+    EXPECT_EQ(ff.allocate(100), a);
+    EXPECT_FALSE(ff.stats().largest_free_known());
+    EXPECT_EQ(ff.largest_free_block(), 80);
+    EXPECT_TRUE(ff.stats().largest_free_known());
+
+    // Emptying the bucket leaves the largest block of the next one, which is known without a search.
+    ff.allocate(80);
+    EXPECT_TRUE(ff.stats().largest_free_known());
+    EXPECT_EQ(ff.stats().largest_free(), 60);
+    EXPECT_EQ(ff.largest_free_block(), 60);
+
+    ff.allocate(60);
+    EXPECT_EQ(ff.largest_free_block(), 0);
+}
+
+TEST(Fragmentation, Online)
+{
+    std::array<std::uint8_t, 4096> arr;
+    BasicFirstFitMemoryAllocator<AllocatorStats> ff(arr);
+
+    std::array<void*, 64> blocks{};
+
+    srand(42);
+    for (int i=0; i<2000; i++)
+    {
+        void*& block = blocks[rand() % blocks.size()];
+        if (block == nullptr)
+        {
+            block = ff.allocate((rand() % 64) + 1);
+        }
+        else
+        {
+            ff.deallocate(block);
+            block = nullptr;
+        }
+
+        std::size_t largest = 0;
+        std::size_t bytes = 0;
+        auto fl = ff.free_list();
+        for (auto node = fl.head(); node != nullptr; node = node->next)
+        {
+            largest = std::max(largest, node->value);
+            bytes += node->value;
+        }
+
+        ASSERT_EQ(ff.stats().free_blocks(), fl.count());
+        ASSERT_EQ(ff.stats().free_block_bytes(), bytes);
+        ASSERT_EQ(ff.largest_free_block(), largest);
+        ASSERT_DOUBLE_EQ(ff.external_fragmentation(), 1.0 - (static_cast<double>(largest) / bytes));
+    }
+}
+
+TEST(Walk, Blocks)
+{
+    std::array<std::uint8_t, 256> arr;
+    FirstFitMemoryAllocator ff(arr);
+
+    ff.allocate(16);
+    void* block = ff.allocate(32);
+    ff.allocate(8);
+    ff.deallocate(block);
+
+    std::vector<HeapBlock> blocks;
+    ff.walk([&](const HeapBlock& b) { blocks.push_back(b); });
+
+    ASSERT_EQ(blocks.size(), 4);
+    EXPECT_EQ(blocks[0].addr, arr.data());
+    EXPECT_EQ(blocks[0].bytes, 16+ff.node_size);
+    EXPECT_FALSE(blocks[0].free);
+    EXPECT_EQ(blocks[1].bytes, 32+ff.node_size);
+    EXPECT_TRUE(blocks[1].free);
+    EXPECT_EQ(blocks[2].bytes, 8+ff.node_size);
+    EXPECT_FALSE(blocks[2].free);
+    EXPECT_EQ(blocks[3].addr, blocks[2].addr + blocks[2].bytes);
+    EXPECT_EQ(blocks[3].bytes, 256-56-(3*ff.node_size));
+    EXPECT_TRUE(blocks[3].free);
+}
+
+TEST(Walk, ExactFit)
+{
+    std::array<std::uint8_t, 256> arr;
+    FirstFitMemoryAllocator ff(arr);
+
+    void* block = ff.allocate(256-(1.5*ff.node_size));
+
+    std::size_t count = 0;
+    ff.walk([&](const HeapBlock& b) {
+        EXPECT_EQ(b.bytes, 256);
+        EXPECT_FALSE(b.free);
+        count++;
+    });
+    EXPECT_EQ(count, 1);
+
+    ff.deallocate(block);
+
+    EXPECT_EQ(ff.allocated(), ff.node_size);
+    EXPECT_EQ(ff.free_list().head()->value, 256-ff.node_size);
+}
+
+TEST(QuickList, Reallocate)
+{
+    std::array<std::uint8_t, 256> arr;
+    QuickFirstFitMemoryAllocator<32> ff(arr);
+
+    void* block1 = ff.allocate(16);
+    ff.allocate(16);
+    ff.deallocate(block1);
+
+    EXPECT_EQ(ff.quick_list_count(), 1);
+    EXPECT_EQ(ff.free_list().count(), 1);
+    EXPECT_EQ(ff.allocated(), 3*ff.node_size + 16);
+
+    EXPECT_EQ(ff.allocate(16), block1);
+    EXPECT_EQ(ff.quick_list_count(), 0);
+    EXPECT_EQ(ff.allocated(), 3*ff.node_size + 32);
+}
+
+TEST(QuickList, LargeBlock)
+{
+    std::array<std::uint8_t, 256> arr;
+    QuickFirstFitMemoryAllocator<32> ff(arr);
+
+    void* block = ff.allocate(64);
+    ff.deallocate(block);
+
+    EXPECT_EQ(ff.quick_list_count(), 0);
+    EXPECT_EQ(ff.free_list().count(), 1);
+    EXPECT_EQ(ff.allocated(), ff.node_size);
+}
+
+TEST(QuickList, Trim)
+{
+    std::array<std::uint8_t, 256> arr;
+    QuickFirstFitMemoryAllocator<32> ff(arr);
+
+    void* block1 = ff.allocate(16);
+    void* block2 = ff.allocate(24);
+    ff.deallocate(block1);
+    ff.deallocate(block2);
+
+    EXPECT_EQ(ff.quick_list_count(), 2);
+    ff.trim();
+
+    EXPECT_EQ(ff.quick_list_count(), 0);
+    EXPECT_EQ(ff.free_list().count(), 1);
+    EXPECT_EQ(ff.free_list().head()->value, 256 - ff.node_size);
+    EXPECT_EQ(ff.allocated(), ff.node_size);
+}
+
+TEST(QuickList, ConsolidateOnFailure)
+{
+    std::array<std::uint8_t, 256> arr;
+    BasicFirstFitMemoryAllocator<AllocatorStats, 32> ff(arr);
+
+    std::vector<void*> blocks;
+    for (void* block = ff.allocate(8); block != nullptr; block = ff.allocate(8))
+    {
+        blocks.push_back(block);
+    }
+
+    for (void* block : blocks)
+    {
+        ff.deallocate(block);
+    }
+
+    EXPECT_EQ(ff.quick_list_count(), blocks.size());
+
+    // No single block is large enough until the quick lists are merged.
+    EXPECT_NE(ff.allocate(128), nullptr);
+    EXPECT_EQ(ff.quick_list_count(), 0);
+    EXPECT_EQ(ff.stats().failed_allocations(), 1);
+}
+
+TEST(QuickList, Walk)
+{
+    std::array<std::uint8_t, 256> arr;
+    QuickFirstFitMemoryAllocator<32> ff(arr);
+
+    void* block = ff.allocate(16);
+    ff.allocate(16);
+    ff.deallocate(block);
+
+    std::vector<HeapBlock> blocks;
+    ff.walk([&](const HeapBlock& b) { blocks.push_back(b); });
+
+    ASSERT_EQ(blocks.size(), 3);
+    EXPECT_TRUE(blocks[0].free);
+    EXPECT_FALSE(blocks[1].free);
+    EXPECT_TRUE(blocks[2].free);
+}
+
+TEST(QuickList, WalkBumpedBlock)
+{
+    // Every word holds the address of a node whose 'prev' it would be, so a node bumped off the
+    //  wilderness that kept the stale 'prev' would look like it's on a quick list.
+    std::array<std::uintptr_t, 64> arr;
+    for (std::size_t i=0; i<arr.size(); i++)
+    {
+        arr[i] = reinterpret_cast<std::uintptr_t>(&arr[i]) - offsetof(FirstFitFreeList::DLLNode, prev);
+    }
+
+    BasicFirstFitMemoryAllocator<NoStats, 32, true> ff(arr);
+
+    ff.allocate(8);
+    ff.allocate(24);
+
+    std::vector<HeapBlock> blocks;
+    ff.walk([&](const HeapBlock& b) { blocks.push_back(b); });
+
+    ASSERT_EQ(blocks.size(), 3);
+    EXPECT_FALSE(blocks[0].free);
+    EXPECT_FALSE(blocks[1].free);
+    EXPECT_TRUE(blocks[2].free);
+}
+
+TEST(QuickList, Fragmentation)
+{
+    std::array<std::uint8_t, 4096> arr;
+    BasicFirstFitMemoryAllocator<AllocatorStats, 32> ff(arr);
+
+    std::array<void*, 64> blocks{};
+
+    srand(42);
+    for (int i=0; i<2000; i++)
+    {
+        void*& block = blocks[rand() % blocks.size()];
+        if (block == nullptr)
+        {
+            block = ff.allocate((rand() % 64) + 1);
+        }
+        else
+        {
+            ff.deallocate(block);
+            block = nullptr;
+        }
+
+        std::size_t free_bytes = 0;
+        ff.walk([&](const HeapBlock& b) { free_bytes += b.free ? b.bytes - ff.node_size : 0; });
+
+        ASSERT_EQ(ff.stats().free_blocks(), ff.free_list().count() + ff.quick_list_count());
+        ASSERT_EQ(ff.stats().free_block_bytes(), free_bytes);
+        ASSERT_EQ(ff.allocated(), ff.length() - free_bytes);
+    }
+}
+
+TEST(Wilderness, Constructor)
+{
+    std::array<std::uint8_t, 256> arr;
+    arr.fill(0xAB);
+
+    WildernessFirstFitMemoryAllocator ff(arr);
+
+    EXPECT_EQ(ff.free_list().count(), 0);
+    EXPECT_EQ(ff.wilderness_bytes(), 256 - ff.node_size);
+    EXPECT_EQ(ff.allocated(), ff.node_size);
+    EXPECT_TRUE(std::all_of(arr.begin(), arr.end(), [](std::uint8_t b) { return b == 0xAB; }));
+}
+
+TEST(Wilderness, Allocate)
+{
+    std::array<std::uint8_t, 256> arr;
+    WildernessFirstFitMemoryAllocator ff(arr);
+
+    void* block1 = ff.allocate(32);
+    void* block2 = ff.allocate(32);
+
+    EXPECT_EQ(block1, reinterpret_cast<void*>(arr.data()) + ff.node_size);
+    EXPECT_EQ(block2, block1 + 32 + ff.node_size);
+    EXPECT_EQ(ff.allocated(), 64 + 3*ff.node_size);
+    EXPECT_EQ(ff.free_list().count(), 0);
+    EXPECT_EQ(ff.wilderness_bytes(), 256 - 64 - 3*ff.node_size);
+}
+
+TEST(Wilderness, AllocateAll)
+{
+    std::array<std::uint8_t, 256> arr;
+    WildernessFirstFitMemoryAllocator ff(arr);
+
+    void* block = ff.allocate(256-(1.5*ff.node_size));
+
+    EXPECT_NE(block, nullptr);
+    EXPECT_EQ(ff.allocated(), ff.length());
+    EXPECT_EQ(ff.wilderness_bytes(), 0);
+    EXPECT_EQ(ff.allocate(1), nullptr);
+
+    ff.deallocate(block);
+
+    EXPECT_EQ(ff.allocated(), ff.node_size);
+    EXPECT_EQ(ff.wilderness_bytes(), 256 - ff.node_size);
+}
+
+TEST(Wilderness, FreeList)
+{
+    std::array<std::uint8_t, 256> arr;
+    WildernessFirstFitMemoryAllocator ff(arr);
+
+    void* block1 = ff.allocate(32);
+    void* block2 = ff.allocate(32);
+    ff.deallocate(block1);
+
+    EXPECT_EQ(ff.free_list().count(), 1);
+    EXPECT_EQ(ff.allocate(16), block1);
+
+    // Too large for the block left on the free list, so it is bumped off the wilderness.
+    void* block3 = ff.allocate(40);
+    EXPECT_EQ(block3, block2 + 32 + ff.node_size);
+}
+
+TEST(Wilderness, MergeLastFreeBlock)
+{
+    std::array<std::uint8_t, 256> arr;
+    WildernessFirstFitMemoryAllocator ff(arr);
+
+    void* block1 = ff.allocate(32);
+    void* block2 = ff.allocate(32);
+    void* block3 = ff.allocate(32);
+    ff.deallocate(block2);
+    ff.deallocate(block3);
+
+    EXPECT_EQ(ff.free_list().count(), 0);
+    EXPECT_EQ(ff.wilderness_bytes(), 256 - 32 - 2*ff.node_size);
+    EXPECT_EQ(ff.allocated(), 32 + 2*ff.node_size);
+
+    ff.deallocate(block1);
+
+    EXPECT_EQ(ff.wilderness_bytes(), 256 - ff.node_size);
+    EXPECT_EQ(ff.allocated(), ff.node_size);
+}
+
+// Blocks on the free list are always before the wilderness, so the wilderness only changes how the
+//  last free block is kept.
+TEST(Wilderness, SameBlocks)
+{
+    std::array<std::uint8_t, 4096> arr1;
+    std::array<std::uint8_t, 4096> arr2;
+    BasicFirstFitMemoryAllocator<AllocatorStats> ff(arr1);
+    BasicFirstFitMemoryAllocator<AllocatorStats, 0, true> wff(arr2);
+
+    std::array<void*, 64> blocks{};
+    std::array<void*, 64> wblocks{};
+
+    srand(42);
+    for (int i=0; i<2000; i++)
+    {
+        const std::size_t b = rand() % blocks.size();
+        if (blocks[b] == nullptr)
+        {
+            const std::size_t bytes = (rand() % 128) + 1;
+            blocks[b] = ff.allocate(bytes);
+            wblocks[b] = wff.allocate(bytes);
+        }
+        else
+        {
+            ff.deallocate(blocks[b]);
+            wff.deallocate(wblocks[b]);
+            blocks[b] = nullptr;
+            wblocks[b] = nullptr;
+        }
+
+        std::vector<HeapBlock> walked;
+        std::vector<HeapBlock> wwalked;
+        ff.walk([&](const HeapBlock& block) { walked.push_back(block); });
+        wff.walk([&](const HeapBlock& block) { wwalked.push_back(block); });
+
+        ASSERT_EQ(walked.size(), wwalked.size());
+        for (std::size_t j=0; j<walked.size(); j++)
+        {
+            ASSERT_EQ(walked[j].bytes, wwalked[j].bytes);
+            ASSERT_EQ(walked[j].free, wwalked[j].free);
+        }
+
+        ASSERT_EQ(ff.allocated(), wff.allocated());
+        ASSERT_EQ(ff.stats().free_blocks(), wff.stats().free_blocks());
+        ASSERT_EQ(ff.stats().free_block_bytes(), wff.stats().free_block_bytes());
+        ASSERT_EQ(ff.largest_free_block(), wff.largest_free_block());
+    }
+}
+
+TEST(Compact, Allocate)
+{
+    alignas(4) std::array<std::uint8_t, 256> arr;
+    CompactFirstFitMemoryAllocator ff(arr);
+
+    EXPECT_EQ(ff.node_size, 12);
+    EXPECT_EQ(ff.header_size, 4);
+
+    // A block only has a header in front of it, and a payload large enough for the links of a node.
+    void* block1 = ff.allocate(1);
+    void* block2 = ff.allocate(1);
+
+    EXPECT_EQ(block1, arr.data() + ff.header_size);
+    EXPECT_EQ(block2, block1 + 8 + ff.header_size);
+    EXPECT_EQ(ff.allocated(), 3*ff.header_size + 2*8);
+
+    void* block3 = ff.allocate(10);
+    EXPECT_EQ(block3, block2 + 8 + ff.header_size);
+    EXPECT_EQ(ff.allocated(), 4*ff.header_size + 2*8 + 12);
+
+    ff.deallocate(block1);
+    ff.deallocate(block3);
+    ff.deallocate(block2);
+
+    EXPECT_EQ(ff.allocated(), ff.header_size);
+    EXPECT_EQ(ff.free_list().count(), 1);
+    EXPECT_EQ(ff.free_list().head()->value, 256 - ff.header_size);
+}
+
+TEST(Compact, BlocksPerBuffer)
+{
+    std::array<std::uint8_t, 1200> arr1;
+    FirstFitMemoryAllocator ff(arr1);
+
+    alignas(4) std::array<std::uint8_t, 1200> arr2;
+    CompactFirstFitMemoryAllocator compact_ff(arr2);
+
+    std::size_t count = 0;
+    while (ff.allocate(1) != nullptr)
+    {
+        count++;
+    }
+
+    std::size_t compact_count = 0;
+    while (compact_ff.allocate(1) != nullptr)
+    {
+        compact_count++;
+    }
+
+    // 1 byte blocks take 12 bytes rather than 25, so more than twice as many fit.
+    EXPECT_EQ(count, 48);
+    EXPECT_EQ(compact_count, 100);
+}
+
+TEST(Compact, Granularity)
+{
+    alignas(8) std::array<std::uint8_t, 260> arr;
+    LargeCompactFirstFitMemoryAllocator ff(arr);
+
+    EXPECT_EQ(ff.node_size, 16);
+    EXPECT_EQ(ff.header_size, 8);
+    EXPECT_EQ(ff.length(), 256);
+
+    void* block1 = ff.allocate(1);
+    void* block2 = ff.allocate(9);
+    void* block3 = ff.allocate(8);
+
+    EXPECT_EQ(block1, arr.data() + ff.header_size);
+    EXPECT_EQ(block2, block1 + 8 + ff.header_size);
+    EXPECT_EQ(block3, block2 + 16 + ff.header_size);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block3) % 8, 0);
+    EXPECT_EQ(ff.allocated(), 4*ff.header_size + 8 + 16 + 8);
+
+    ff.deallocate(block2);
+    ff.deallocate(block1);
+    EXPECT_EQ(ff.free_list().count(), 2);
+    EXPECT_EQ(ff.free_list().head()->value, 8 + ff.header_size + 16);
+
+    ff.deallocate(block3);
+    EXPECT_EQ(ff.allocated(), ff.header_size);
+    EXPECT_EQ(ff.free_list().head()->value, 256 - ff.header_size);
+}
+
+TEST(Compact, Range)
+{
+    using Node = CompactFirstFitMemoryAllocator::FLNode;
+    using LargeNode = LargeCompactFirstFitMemoryAllocator::FLNode;
+
+    EXPECT_EQ((CompactPointer<Node, true, 4>::max_distance), 4*static_cast<std::size_t>(UINT32_MAX));
+    EXPECT_EQ((CompactPointer<LargeNode, true, 8>::max_distance), 8*static_cast<std::size_t>(UINT32_MAX));
+
+    // Links are never followed further than this, so the addresses they hold need not be mapped.
+    alignas(8) std::array<std::uint8_t, 16> arr;
+    LargeNode* node = reinterpret_cast<LargeNode*>(arr.data());
+    const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(node);
+
+    LargeNode* far_next = reinterpret_cast<LargeNode*>(addr + (std::size_t(31) << 30));
+    node->next = far_next;
+    EXPECT_EQ(node->next, far_next);
+
+    if (addr > (std::size_t(31) << 30))
+    {
+        LargeNode* far_prev = reinterpret_cast<LargeNode*>(addr - (std::size_t(31) << 30));
+        node->prev = far_prev;
+        EXPECT_EQ(node->prev, far_prev);
+    }
+
+    node->next = nullptr;
+    EXPECT_EQ(node->next, nullptr);
+}
+
+TEST(Compact, Fragmentation)
+{
+    alignas(4) std::array<std::uint8_t, 4096> arr;
+    BasicFirstFitMemoryAllocator<AllocatorStats, 16, true, true> ff(arr);
+
+    std::array<void*, 64> blocks{};
+
+    srand(42);
+    for (int i=0; i<2000; i++)
+    {
+        void*& block = blocks[rand() % blocks.size()];
+        if (block == nullptr)
+        {
+            block = ff.allocate((rand() % 64) + 1);
+        }
+        else
+        {
+            ff.deallocate(block);
+            block = nullptr;
+        }
+
+        std::size_t free_bytes = 0;
+        std::size_t free_blocks = 0;
+        ff.walk([&](const HeapBlock& b) {
+            free_bytes += b.free ? b.bytes - ff.header_size : 0;
+            free_blocks += b.free ? 1 : 0;
+        });
+
+        ASSERT_EQ(ff.stats().free_blocks(), free_blocks);
+        ASSERT_EQ(ff.stats().free_block_bytes(), free_bytes);
+        ASSERT_EQ(ff.allocated(), ff.length() - free_bytes);
+    }
+
+    for (void* block : blocks)
+    {
+        if (block != nullptr)
+        {
+            ff.deallocate(block);
+        }
+    }
+    ff.trim();
+
+    EXPECT_EQ(ff.allocated(), ff.header_size);
+    EXPECT_EQ(ff.wilderness_bytes(), 4096 - ff.header_size);
+}
@@ -1,5 +1,6 @@
 #include <array>
 #include <cstddef>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -26,6 +27,17 @@ TEST(Constructor, DWordArray)
     EXPECT_EQ(nf.get_cursor(), nf.free_list().head());
 }
 
+TEST(Constructor, Region)
+{
+    std::array<std::uint8_t, 256> arr;
+
+    NextFitMemoryAllocator nf(arr.data() + 64, 128);
+
+    EXPECT_EQ(nf.length(), 128);
+    EXPECT_EQ(nf.free_list().count(), 1);
+    EXPECT_EQ(nf.allocate(8), arr.data() + 64 + NextFitMemoryAllocator::node_size);
+}
+
 TEST(Allocate, First)
 {
     std::array<std::uint8_t, 256> arr;
@@ -88,7 +100,7 @@ TEST(Allocate, HalfNodeSpace)
 
     nf.allocate(256-(1.5*nf.node_size));
 
-    EXPECT_EQ(nf.allocated(), nf.length()-0.5*nf.node_size);
+    EXPECT_EQ(nf.allocated(), nf.length());
     EXPECT_EQ(nf.free_list().count(), 0);
     EXPECT_EQ(nf.get_cursor(), nullptr);
 }
@@ -212,4 +224,182 @@ TEST(Deallocate, Reallocate)
     EXPECT_EQ(nf.free_list().count(), 2);
     EXPECT_EQ(nf.free_list().head()->value, 32);
     EXPECT_EQ(nf.get_cursor(), block3 + 40);
-}
\ No newline at end of file
+}
+
+TEST(Stats, AllocateDeallocate)
+{
+    std::array<std::uint8_t, 256> arr;
+    BasicNextFitMemoryAllocator<AllocatorStats> nf(arr);
+
+    void* block = nf.allocate(32);
+    nf.allocate(300);
+
+    EXPECT_EQ(nf.stats().allocations(AllocatorStats::bucket_of(32)), 1);
+    EXPECT_EQ(nf.stats().payload_bytes(), 32);
+    EXPECT_EQ(nf.stats().metadata_bytes(), 2*nf.node_size);
+    EXPECT_EQ(nf.stats().failed_allocations(), 1);
+    EXPECT_EQ(nf.stats().nodes_visited(), 2);
+
+    nf.deallocate(block);
+
+    EXPECT_EQ(nf.stats().deallocations(AllocatorStats::bucket_of(32)), 1);
+    EXPECT_EQ(nf.stats().payload_bytes(), 0);
+    EXPECT_EQ(nf.stats().peak_bytes(), 32 + 2*nf.node_size);
+}
+
+TEST(Stats, LargestFreeRemoved)
+{
+    std::array<std::uint8_t, 1024> arr;
+    BasicNextFitMemoryAllocator<AllocatorStats> nf(arr);
+
+    void* a = nf.allocate(100);
+    nf.allocate(8);
+    void* b = nf.allocate(60);
+    nf.allocate(8);
+    void* c = nf.allocate(80);
+    nf.allocate(8);
+    nf.allocate(nf.free_list().head()->value);
+
+    nf.deallocate(a);
+    nf.deallocate(b);
+    nf.deallocate(c);
+    EXPECT_EQ(nf.largest_free_block(), 100);
+
+    // Allocating the largest free block leaves a smaller one in it's size bucket, which is searched for
+    //  once.
+    EXPECT_EQ(nf.allocate(100), a);
+    EXPECT_FALSE(nf.stats().largest_free_known());
+    EXPECT_EQ(nf.largest_free_block(), 80);
+    EXPECT_TRUE(nf.stats().largest_free_known());
+
+    // Emptying the bucket leaves the largest block of the next one, which is known without a search.
+    nf.allocate(80);
+    EXPECT_TRUE(nf.stats().largest_free_known());
+    EXPECT_EQ(nf.stats().largest_free(), 60);
+    EXPECT_EQ(nf.largest_free_block(), 60);
+
+    nf.allocate(60);
+    EXPECT_EQ(nf.largest_free_block(), 0);
+}
+
+TEST(Fragmentation, Histogram)
+{
+    std::array<std::uint8_t, 256> arr;
+    BasicNextFitMemoryAllocator<AllocatorStats> nf(arr);
+
+    void* block1 = nf.allocate(32);
+    nf.allocate(32);
+
+    EXPECT_EQ(nf.stats().free_blocks(), 1);
+    EXPECT_EQ(nf.largest_free_block(), 256 - 64 - (3*nf.node_size));
+
+    nf.deallocate(block1);
+
+    EXPECT_EQ(nf.stats().free_blocks(), 2);
+    EXPECT_EQ(nf.stats().free_histogram(AllocatorStats::bucket_of(32)), 1);
+    EXPECT_EQ(nf.largest_free_block(), 256 - 64 - (3*nf.node_size));
+    EXPECT_DOUBLE_EQ(nf.external_fragmentation(), 32.0 / (256 - 32 - (3*nf.node_size)));
+}
+
+TEST(Walk, Blocks)
+{
+    std::array<std::uint8_t, 256> arr;
+    NextFitMemoryAllocator nf(arr);
+
+    nf.allocate(16);
+    void* block = nf.allocate(32);
+    nf.allocate(8);
+    nf.deallocate(block);
+
+    std::vector<HeapBlock> blocks;
+    nf.walk([&](const HeapBlock& b) { blocks.push_back(b); });
+
+    ASSERT_EQ(blocks.size(), 4);
+    EXPECT_EQ(blocks[0].addr, arr.data());
+    EXPECT_EQ(blocks[0].bytes, 16+nf.node_size);
+    EXPECT_FALSE(blocks[0].free);
+    EXPECT_EQ(blocks[1].bytes, 32+nf.node_size);
+    EXPECT_TRUE(blocks[1].free);
+    EXPECT_EQ(blocks[2].bytes, 8+nf.node_size);
+    EXPECT_FALSE(blocks[2].free);
+    EXPECT_EQ(blocks[3].addr, blocks[2].addr + blocks[2].bytes);
+    EXPECT_EQ(blocks[3].bytes, 256-56-(3*nf.node_size));
+    EXPECT_TRUE(blocks[3].free);
+}
+
+TEST(Walk, ExactFit)
+{
+    std::array<std::uint8_t, 256> arr;
+    NextFitMemoryAllocator nf(arr);
+
+    void* block = nf.allocate(256-(1.5*nf.node_size));
+
+    std::size_t count = 0;
+    nf.walk([&](const HeapBlock& b) {
+        EXPECT_EQ(b.bytes, 256);
+        EXPECT_FALSE(b.free);
+        count++;
+    });
+    EXPECT_EQ(count, 1);
+
+    nf.deallocate(block);
+
+    EXPECT_EQ(nf.allocated(), nf.node_size);
+    EXPECT_EQ(nf.free_list().head()->value, 256-nf.node_size);
+}
+
+TEST(Wilderness, Allocate)
+{
+    std::array<std::uint8_t, 256> arr;
+    WildernessNextFitMemoryAllocator nf(arr);
+
+    EXPECT_EQ(nf.free_list().count(), 0);
+    EXPECT_EQ(nf.get_cursor(), nullptr);
+
+    void* block1 = nf.allocate(32);
+    void* block2 = nf.allocate(32);
+
+    EXPECT_EQ(block1, reinterpret_cast<void*>(arr.data()) + nf.node_size);
+    EXPECT_EQ(block2, block1 + 32 + nf.node_size);
+    EXPECT_EQ(nf.allocated(), 64 + 3*nf.node_size);
+    EXPECT_EQ(nf.wilderness_bytes(), 256 - 64 - 3*nf.node_size);
+}
+
+TEST(Wilderness, Deallocate)
+{
+    std::array<std::uint8_t, 256> arr;
+    WildernessNextFitMemoryAllocator nf(arr);
+
+    void* block1 = nf.allocate(32);
+    void* block2 = nf.allocate(32);
+    void* block3 = nf.allocate(32);
+    nf.deallocate(block1);
+    nf.deallocate(block2);
+
+    EXPECT_EQ(nf.free_list().count(), 1);
+    EXPECT_EQ(nf.get_cursor(), nf.free_list().head());
+
+    // Merges the free block before it into the wilderness as well.
+    nf.deallocate(block3);
+
+    EXPECT_EQ(nf.free_list().count(), 0);
+    EXPECT_EQ(nf.get_cursor(), nullptr);
+    EXPECT_EQ(nf.allocated(), nf.node_size);
+    EXPECT_EQ(nf.wilderness_bytes(), 256 - nf.node_size);
+}
+
+TEST(Wilderness, Stats)
+{
+    std::array<std::uint8_t, 256> arr;
+    BasicNextFitMemoryAllocator<AllocatorStats, true> nf(arr);
+
+    void* block1 = nf.allocate(32);
+    nf.allocate(32);
+    nf.deallocate(block1);
+
+    EXPECT_EQ(nf.stats().free_blocks(), 2);
+    EXPECT_EQ(nf.stats().free_block_bytes(), 256 - 32 - 3*nf.node_size);
+    EXPECT_EQ(nf.largest_free_block(), 256 - 64 - 3*nf.node_size);
+    EXPECT_EQ(nf.allocate(300), nullptr);
+    EXPECT_EQ(nf.stats().failed_allocations(), 1);
+}
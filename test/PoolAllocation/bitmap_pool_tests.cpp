@@ -0,0 +1,299 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "PoolAllocation/bitmap_pool_allocator.h"
+#include "PoolAllocation/pool_allocation_memory_allocator.h"
+
+TEST(Constructor, Blocks)
+{
+    std::array<std::uint8_t, 8 + (64*8)> arr;
+
+    BitmapPoolAllocator<8> bp(arr);
+
+    EXPECT_EQ(bp.length(), sizeof(arr));
+    EXPECT_EQ(bp.total_blocks(), 64);
+    EXPECT_EQ(bp.allocated(), 8);
+}
+
+TEST(Constructor, PartialWord)
+{
+    std::array<std::uint8_t, 16 + (100*8) + 7> arr;
+
+    BitmapPoolAllocator<8> bp(arr);
+
+    EXPECT_EQ(bp.total_blocks(), 100);
+    EXPECT_EQ(bp.allocated(), 16);
+    EXPECT_FALSE(bp.is_free(100));
+}
+
+TEST(Allocate, InOrder)
+{
+    std::array<std::uint8_t, 8 + (64*8)> arr;
+    BitmapPoolAllocator<8> bp(arr);
+
+    void* block1 = bp.allocate(8);
+    void* block2 = bp.allocate(1);
+
+    EXPECT_EQ(block1, arr.data() + 8);
+    EXPECT_EQ(block2, arr.data() + 16);
+    EXPECT_EQ(bp.allocated(), 8 + 16);
+    EXPECT_EQ(bp.allocated_blocks(), 2);
+    EXPECT_EQ(bp.allocate(9), nullptr);
+    EXPECT_EQ(bp.allocate(0), nullptr);
+}
+
+TEST(Allocate, NoSpace)
+{
+    std::array<std::uint8_t, 16 + (100*8)> arr;
+    BitmapPoolAllocator<8> bp(arr);
+
+    for (std::size_t i=0; i<100; i++)
+    {
+        EXPECT_EQ(bp.allocate(), arr.data() + 16 + (i*8));
+    }
+
+    EXPECT_EQ(bp.allocate(), nullptr);
+    EXPECT_EQ(bp.allocated(), bp.length());
+}
+
+TEST(Deallocate, LowestFirst)
+{
+    std::array<std::uint8_t, 16 + (100*8)> arr;
+    BitmapPoolAllocator<8> bp(arr);
+
+    std::vector<void*> blocks;
+    for (std::size_t i=0; i<100; i++)
+    {
+        blocks.push_back(bp.allocate());
+    }
+
+    bp.deallocate(blocks[90]);
+    bp.deallocate(blocks[70]);
+    bp.deallocate(blocks[3]);
+
+    EXPECT_EQ(bp.allocated_blocks(), 97);
+    EXPECT_EQ(bp.allocate(), blocks[3]);
+    EXPECT_EQ(bp.allocate(), blocks[70]);
+    EXPECT_EQ(bp.allocate(), blocks[90]);
+    EXPECT_EQ(bp.allocate(), nullptr);
+}
+
+TEST(Reset, AllFree)
+{
+    std::array<std::uint8_t, 16 + (100*8)> arr;
+    BitmapPoolAllocator<8> bp(arr);
+
+    for (std::size_t i=0; i<50; i++)
+    {
+        bp.allocate();
+    }
+    bp.reset();
+
+    EXPECT_EQ(bp.allocated_blocks(), 0);
+    EXPECT_EQ(bp.allocated(), 16);
+    EXPECT_EQ(bp.allocate(), arr.data() + 16);
+}
+
+TEST(Stats, AllocateDeallocate)
+{
+    // The bitmap, and the table of requested sizes rounded up to a word.
+    std::array<std::uint8_t, 8 + 8 + (2*8)> arr;
+    BitmapPoolAllocator<8, AllocatorStats> bp(arr);
+
+    void* block = bp.allocate(4);
+    bp.allocate(8);
+    bp.allocate(8);
+
+    EXPECT_EQ(bp.stats().allocations(AllocatorStats::bucket_of(8)), 2);
+    EXPECT_EQ(bp.stats().payload_bytes(), 16);
+    EXPECT_EQ(bp.stats().metadata_bytes(), 16);
+    EXPECT_EQ(bp.stats().free_bytes(), 0);
+    EXPECT_EQ(bp.stats().failed_allocations(), 1);
+    EXPECT_EQ(bp.stats().internal_fragmentation(), 4);
+
+    bp.deallocate(block);
+
+    EXPECT_EQ(bp.stats().free_blocks(), 1);
+    EXPECT_EQ(bp.stats().payload_bytes(), 8);
+    EXPECT_EQ(bp.stats().internal_fragmentation(), 0);
+    EXPECT_EQ(bp.largest_free_block(), 8);
+}
+
+TEST(Stats, RequestedSizes)
+{
+    // 10 blocks, with 3 words of table.
+    alignas(8) std::array<std::uint8_t, 8 + 24 + (10*8)> arr;
+    BitmapPoolAllocator<8, AllocatorStats> bp(arr);
+
+    void* a = bp.allocate(1);
+    void* b = bp.allocate(5);
+    void* run = bp.allocate_run(3);
+    void* c = bp.allocate(8);
+
+    EXPECT_EQ(a, arr.data() + 8 + 24);
+    EXPECT_EQ(bp.total_blocks(), 10);
+    EXPECT_EQ(bp.stats().internal_fragmentation(), 7 + 3);
+
+    bp.deallocate(a);
+    bp.deallocate_run(run, 3);
+
+    EXPECT_EQ(bp.stats().internal_fragmentation(), 3);
+
+    bp.deallocate(b);
+    bp.deallocate(c);
+
+    EXPECT_EQ(bp.stats().internal_fragmentation(), 0);
+    EXPECT_EQ(bp.allocated(), 8 + 24);
+}
+
+TEST(Walk, Blocks)
+{
+    std::array<std::uint8_t, 8 + (4*16)> arr;
+    BitmapPoolAllocator<16> bp(arr);
+
+    bp.allocate();
+    void* block = bp.allocate();
+    bp.allocate();
+    bp.deallocate(block);
+
+    std::vector<HeapBlock> blocks;
+    bp.walk([&](const HeapBlock& b) { blocks.push_back(b); });
+
+    ASSERT_EQ(blocks.size(), 4);
+    EXPECT_EQ(blocks[0].addr, arr.data() + 8);
+    EXPECT_FALSE(blocks[0].free);
+    EXPECT_TRUE(blocks[1].free);
+    EXPECT_FALSE(blocks[2].free);
+    EXPECT_TRUE(blocks[3].free);
+    EXPECT_EQ(blocks[3].bytes, 16);
+}
+
+// The pool's free list is sorted by address, so both allocators always allocate the lowest free block.
+TEST(Allocate, SameOrderAsPool)
+{
+    const std::size_t node_size = PoolAllocationMemoryAllocator<8>::node_size;
+
+    std::array<std::uint8_t, 8*(8 + 512*8)> arr1;
+    BitmapPoolAllocator<8> bp(arr1);
+
+    std::array<std::uint8_t, 8*(8 + 512*8)> arr2;
+    PoolAllocationMemoryAllocator<8> pa(arr2);
+
+    // The blocks start after the bitmap.
+    std::uint8_t* bp_base = reinterpret_cast<std::uint8_t*>(bp.allocate());
+    bp.deallocate(bp_base);
+
+    std::array<void*, 600> bp_blocks{};
+    std::array<void*, 600> pa_blocks{};
+
+    srand(42);
+    for (int i=0; i<20000; i++)
+    {
+        const std::size_t b = rand() % bp_blocks.size();
+        if (bp_blocks[b] == nullptr)
+        {
+            bp_blocks[b] = bp.allocate();
+            pa_blocks[b] = pa.allocate();
+
+            ASSERT_NE(bp_blocks[b], nullptr);
+            const std::size_t bp_index = (reinterpret_cast<std::uint8_t*>(bp_blocks[b]) - bp_base) / 8;
+            const std::size_t pa_index = (reinterpret_cast<std::uint8_t*>(pa_blocks[b]) - arr2.data()) / (8 + node_size);
+            ASSERT_EQ(bp_index, pa_index);
+        }
+        else
+        {
+            bp.deallocate(bp_blocks[b]);
+            pa.deallocate(pa_blocks[b]);
+            bp_blocks[b] = nullptr;
+            pa_blocks[b] = nullptr;
+        }
+    }
+}
+
+TEST(Run, AcrossWords)
+{
+    std::array<std::uint8_t, 24 + 304 + (150*8)> arr;
+    BitmapPoolAllocator<8, AllocatorStats> bp(arr);
+
+    std::vector<void*> blocks;
+    for (std::size_t i=0; i<150; i++)
+    {
+        blocks.push_back(bp.allocate());
+    }
+
+    // Free blocks 10 and 60 to 139, a run that covers the whole of the second word.
+    bp.deallocate(blocks[10]);
+    for (std::size_t i=60; i<140; i++)
+    {
+        bp.deallocate(blocks[i]);
+    }
+
+    EXPECT_EQ(bp.allocate_run(81), nullptr);
+    EXPECT_EQ(bp.allocate_run(70), blocks[60]);
+    EXPECT_EQ(bp.allocate_run(2), blocks[130]);
+    EXPECT_EQ(bp.allocate_run(1), blocks[10]);
+    EXPECT_EQ(bp.run_bytes(70), 70*8);
+    EXPECT_EQ(bp.allocated_blocks(), 150 - 8);
+    EXPECT_EQ(bp.stats().failed_allocations(), 1);
+
+    bp.deallocate_run(blocks[60], 70);
+
+    EXPECT_EQ(bp.allocated_blocks(), 150 - 78);
+    for (std::size_t i=60; i<140; i++)
+    {
+        EXPECT_EQ(bp.is_free(i), i < 130 || i >= 132);
+    }
+    EXPECT_EQ(bp.allocate(), blocks[60]);
+}
+
+// Runs are found lowest first, the same as with the pool's address sorted free list.
+TEST(Run, SameOrderAsPool)
+{
+    const std::size_t node_size = PoolAllocationMemoryAllocator<8>::node_size;
+
+    // Both have 1024 blocks, so they run out of space at the same time too.
+    std::array<std::uint8_t, 16*8 + 1024*8> arr1;
+    BitmapPoolAllocator<8> bp(arr1);
+
+    std::vector<std::uint8_t> arr2((8 + node_size)*1024);
+    PoolAllocationMemoryAllocator<8> pa(arr2.data(), arr2.size());
+
+    std::uint8_t* bp_base = reinterpret_cast<std::uint8_t*>(bp.allocate());
+    bp.deallocate(bp_base);
+
+    std::array<void*, 200> bp_runs{};
+    std::array<void*, 200> pa_runs{};
+    std::array<std::size_t, 200> lengths{};
+
+    srand(7);
+    for (int i=0; i<20000; i++)
+    {
+        const std::size_t r = rand() % bp_runs.size();
+        if (bp_runs[r] == nullptr)
+        {
+            lengths[r] = 1 + rand() % 100;
+            bp_runs[r] = bp.allocate_run(lengths[r]);
+            pa_runs[r] = pa.allocate_run(lengths[r]);
+
+            ASSERT_EQ(bp_runs[r] == nullptr, pa_runs[r] == nullptr);
+            if (bp_runs[r] != nullptr)
+            {
+                const std::size_t bp_index = (reinterpret_cast<std::uint8_t*>(bp_runs[r]) - bp_base) / 8;
+                const std::size_t pa_index = (reinterpret_cast<std::uint8_t*>(pa_runs[r]) - arr2.data()) / (8 + node_size);
+                ASSERT_EQ(bp_index, pa_index);
+            }
+        }
+        else
+        {
+            bp.deallocate_run(bp_runs[r], lengths[r]);
+            pa.deallocate_run(pa_runs[r], lengths[r]);
+            bp_runs[r] = nullptr;
+            pa_runs[r] = nullptr;
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #include <array>
 #include <cstddef>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -43,6 +44,18 @@ TEST(Constructor, LargeRem)
     EXPECT_EQ(pa.allocated(), 10*NODESIZE);
 }
 
+TEST(Constructor, Region)
+{
+    std::array<std::uint8_t, (8+NODESIZE)*10> arr;
+
+    PoolAllocationMemoryAllocator<8> pa(arr.data() + (8+NODESIZE)*2, (8+NODESIZE)*5);
+
+    EXPECT_EQ(pa.length(), (8+NODESIZE)*5);
+    EXPECT_EQ(pa.total_blocks(), 5);
+    EXPECT_EQ(pa.free_list().count(), 5);
+    EXPECT_EQ(pa.allocate(8), arr.data() + (8+NODESIZE)*2 + NODESIZE);
+}
+
 TEST(Allocate, TooManyBytes)
 {
     std::array<std::uint8_t, (8+NODESIZE)*10> arr;
@@ -295,4 +308,157 @@ TEST(Deallocate, OrderF)
     EXPECT_EQ(pa.free_list().count(), 3);
     EXPECT_EQ(pa.allocated_blocks(), 0);
     EXPECT_EQ(pa.allocated(), 3*NODESIZE);
-}
\ No newline at end of file
+}
+
+TEST(Stats, AllocateDeallocate)
+{
+    std::array<std::uint8_t, (8+NODESIZE)*2> arr;
+    PoolAllocationMemoryAllocator<8, AllocatorStats> pa(arr);
+
+    void* block = pa.allocate(4);
+    pa.allocate(8);
+    pa.allocate(8);
+
+    EXPECT_EQ(pa.stats().allocations(AllocatorStats::bucket_of(8)), 2);
+    EXPECT_EQ(pa.stats().payload_bytes(), 16);
+    EXPECT_EQ(pa.stats().metadata_bytes(), 2*NODESIZE);
+    EXPECT_EQ(pa.stats().free_bytes(), 0);
+    EXPECT_EQ(pa.stats().failed_allocations(), 1);
+
+    pa.deallocate(block);
+
+    EXPECT_EQ(pa.stats().deallocations(AllocatorStats::bucket_of(8)), 1);
+    EXPECT_EQ(pa.stats().payload_bytes(), 8);
+    EXPECT_EQ(pa.stats().peak_bytes(), 16 + 2*NODESIZE);
+}
+
+TEST(Fragmentation, Internal)
+{
+    std::array<std::uint8_t, (8+NODESIZE)*4> arr;
+    PoolAllocationMemoryAllocator<8, AllocatorStats> pa(arr);
+
+    void* block = pa.allocate(3);
+    pa.allocate(8);
+
+    EXPECT_EQ(pa.stats().internal_fragmentation(), 5);
+    EXPECT_EQ(pa.stats().free_blocks(), 2);
+    EXPECT_EQ(pa.largest_free_block(), 8);
+
+    pa.deallocate(block);
+
+    EXPECT_EQ(pa.stats().internal_fragmentation(), 0);
+    EXPECT_EQ(pa.stats().free_blocks(), 3);
+}
+
+TEST(Walk, Blocks)
+{
+    std::array<std::uint8_t, (8+NODESIZE)*10> arr;
+    PoolAllocationMemoryAllocator<8> pa(arr);
+
+    pa.allocate(8);
+    void* block = pa.allocate(8);
+    pa.allocate(8);
+    pa.deallocate(block);
+
+    std::vector<HeapBlock> blocks;
+    pa.walk([&](const HeapBlock& b) { blocks.push_back(b); });
+
+    ASSERT_EQ(blocks.size(), 10);
+    for (std::size_t i=0; i<blocks.size(); i++)
+    {
+        EXPECT_EQ(blocks[i].addr, arr.data() + i*(8+NODESIZE));
+        EXPECT_EQ(blocks[i].bytes, 8+NODESIZE);
+        EXPECT_EQ(blocks[i].free, i != 0 && i != 2);
+    }
+}
+
+TEST(Compact, AllocateDeallocate)
+{
+    const std::size_t compact_node_size = PoolAllocationMemoryAllocator<8, AllocatorStats, true>::node_size;
+    EXPECT_EQ(compact_node_size, 4);
+
+    std::array<std::uint8_t, (8+compact_node_size)*4> arr;
+    PoolAllocationMemoryAllocator<8, AllocatorStats, true> pa(arr);
+
+    EXPECT_EQ(pa.total_blocks(), 4);
+    EXPECT_EQ(pa.free_list().count(), 4);
+
+    std::vector<void*> blocks;
+    for (std::size_t i=0; i<4; i++)
+    {
+        blocks.push_back(pa.allocate(i + 1));
+        EXPECT_EQ(blocks[i], arr.data() + (i*(8+compact_node_size)) + compact_node_size);
+    }
+    EXPECT_EQ(pa.allocate(8), nullptr);
+    EXPECT_EQ(pa.stats().payload_bytes(), 32);
+    EXPECT_EQ(pa.stats().internal_fragmentation(), 32 - 10);
+
+    pa.deallocate(blocks[2]);
+    pa.deallocate(blocks[0]);
+
+    EXPECT_EQ(pa.stats().internal_fragmentation(), 16 - 6);
+    EXPECT_EQ(pa.free_list().head(), reinterpret_cast<void*>(arr.data()));
+    EXPECT_EQ(pa.free_list().head()->next, reinterpret_cast<void*>(arr.data() + 2*(8+compact_node_size)));
+    EXPECT_EQ(pa.allocate(8), blocks[0]);
+}
+
+TEST(Run, AllocateDeallocate)
+{
+    std::array<std::uint8_t, (8+NODESIZE)*10> arr;
+    PoolAllocationMemoryAllocator<8, AllocatorStats> pa(arr);
+
+    void* run = pa.allocate_run(4);
+
+    EXPECT_EQ(run, arr.data() + NODESIZE);
+    EXPECT_EQ(pa.run_bytes(4), 4*8 + 3*NODESIZE);
+    EXPECT_EQ(pa.free_list().count(), 6);
+    EXPECT_EQ(pa.allocated_blocks(), 4);
+    EXPECT_EQ(pa.allocate(8), arr.data() + 4*(8+NODESIZE) + NODESIZE);
+    EXPECT_EQ(pa.stats().payload_bytes(), 40);
+
+    pa.deallocate_run(run, 4);
+
+    EXPECT_EQ(pa.free_list().count(), 9);
+    EXPECT_EQ(pa.allocated_blocks(), 1);
+    EXPECT_EQ(pa.allocated(), 10*NODESIZE + 8);
+    EXPECT_EQ(pa.stats().payload_bytes(), 8);
+    EXPECT_EQ(pa.free_list().head(), reinterpret_cast<void*>(arr.data()));
+    EXPECT_EQ(pa.allocate_run(4), run);
+}
+
+TEST(Run, SkipsGaps)
+{
+    std::array<std::uint8_t, (8+NODESIZE)*10> arr;
+    PoolAllocationMemoryAllocator<8> pa(arr);
+
+    std::vector<void*> blocks;
+    for (std::size_t i=0; i<10; i++)
+    {
+        blocks.push_back(pa.allocate());
+    }
+
+    // Free blocks 0, 2, 3, 5, 6, 7 and 9.
+    for (std::size_t i : {9, 0, 5, 2, 7, 3, 6})
+    {
+        pa.deallocate(blocks[i]);
+    }
+
+    EXPECT_EQ(pa.allocate_run(3), blocks[5]);
+    EXPECT_EQ(pa.allocate_run(3), nullptr);
+    EXPECT_EQ(pa.allocate_run(2), blocks[2]);
+    EXPECT_EQ(pa.allocate_run(0), nullptr);
+    EXPECT_EQ(pa.free_list().count(), 2);
+    EXPECT_EQ(pa.allocate_run(1), blocks[0]);
+    EXPECT_EQ(pa.free_list().head(), blocks[9] - NODESIZE);
+}
+
+TEST(Run, NoSpace)
+{
+    std::array<std::uint8_t, (8+NODESIZE)*4> arr;
+    PoolAllocationMemoryAllocator<8, AllocatorStats> pa(arr);
+
+    EXPECT_EQ(pa.allocate_run(5), nullptr);
+    EXPECT_NE(pa.allocate_run(4), nullptr);
+    EXPECT_EQ(pa.allocate_run(1), nullptr);
+    EXPECT_EQ(pa.stats().failed_allocations(), 2);
+}
@@ -0,0 +1,209 @@
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Ring/ring_memory_allocator.h"
+
+const std::size_t HEADERSIZE = RingMemoryAllocator<>::header_size;
+
+TEST(Constructor, ByteArray)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+
+    RingMemoryAllocator<> ra(arr);
+
+    EXPECT_EQ(ra.length(), 256);
+    EXPECT_EQ(ra.allocated(), 0);
+}
+
+TEST(Constructor, Region)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+
+    RingMemoryAllocator<> ra(arr.data(), 128);
+
+    EXPECT_EQ(ra.length(), 128);
+    EXPECT_EQ(ra.allocated(), 0);
+}
+
+TEST(Allocate, First)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    RingMemoryAllocator<> ra(arr);
+
+    void* addr = ra.allocate(32);
+
+    EXPECT_EQ(addr, reinterpret_cast<void*>(arr.data()) + HEADERSIZE);
+    EXPECT_EQ(ra.allocated(), HEADERSIZE + 32);
+}
+
+TEST(Allocate, Rounding)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    RingMemoryAllocator<> ra(arr);
+
+    void* addr1 = ra.allocate(1);
+    void* addr2 = ra.allocate(1);
+
+    EXPECT_EQ(addr2, addr1 + HEADERSIZE + 8);
+    EXPECT_EQ(ra.allocated(), 2*(HEADERSIZE + 8));
+}
+
+TEST(Allocate, Nothing)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    RingMemoryAllocator<> ra(arr);
+
+    EXPECT_EQ(ra.allocate(0), nullptr);
+    EXPECT_EQ(ra.allocate(257), nullptr);
+    EXPECT_EQ(ra.allocated(), 0);
+}
+
+TEST(Allocate, Full)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    RingMemoryAllocator<> ra(arr);
+
+    for (int i=0; i<4; i++)
+    {
+        EXPECT_NE(ra.allocate(64 - HEADERSIZE), nullptr);
+    }
+
+    EXPECT_EQ(ra.allocate(1), nullptr);
+    EXPECT_EQ(ra.allocated(), 256);
+}
+
+TEST(Allocate, WrapAround)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    RingMemoryAllocator<> ra(arr);
+
+    void* addr1 = ra.allocate(100 - HEADERSIZE);
+    void* addr2 = ra.allocate(100 - HEADERSIZE);
+    ra.deallocate(addr1);
+
+    // Only 48 bytes are left before the end of the buffer, so the block moves to the start.
+    void* addr3 = ra.allocate(80 - HEADERSIZE);
+
+    EXPECT_EQ(addr3, addr1);
+    EXPECT_EQ(ra.allocated(), 104 + 48 + 80);
+
+    ra.deallocate(addr2);
+
+    EXPECT_EQ(ra.allocated(), 80);
+}
+
+TEST(Allocate, WrapAroundNoSpace)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    RingMemoryAllocator<> ra(arr);
+
+    void* addr1 = ra.allocate(64 - HEADERSIZE);
+    ra.allocate(136 - HEADERSIZE);
+    ra.deallocate(addr1);
+
+    // 120 bytes are free but split in two, and a block is never split across the end of the buffer.
+    EXPECT_EQ(ra.allocate(72 - HEADERSIZE), nullptr);
+    EXPECT_NE(ra.allocate(64 - HEADERSIZE), nullptr);
+}
+
+TEST(Deallocate, InOrder)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    RingMemoryAllocator<> ra(arr);
+
+    void* addr1 = ra.allocate(16);
+    void* addr2 = ra.allocate(16);
+
+    ra.deallocate(addr1);
+    EXPECT_EQ(ra.allocated(), HEADERSIZE + 16);
+
+    ra.deallocate(addr2);
+    EXPECT_EQ(ra.allocated(), 0);
+}
+
+TEST(Deallocate, OutOfOrder)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    RingMemoryAllocator<> ra(arr);
+
+    void* addr1 = ra.allocate(16);
+    void* addr2 = ra.allocate(16);
+    void* addr3 = ra.allocate(16);
+
+    ra.deallocate(addr3);
+    ra.deallocate(addr2);
+    EXPECT_EQ(ra.allocated(), 3*(HEADERSIZE + 16));
+
+    ra.deallocate(addr1);
+    EXPECT_EQ(ra.allocated(), 0);
+}
+
+TEST(Reset, Reuse)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    RingMemoryAllocator<> ra(arr);
+
+    void* addr = ra.allocate(16);
+    ra.allocate(16);
+    ra.reset();
+
+    EXPECT_EQ(ra.allocated(), 0);
+    EXPECT_EQ(ra.allocate(16), addr);
+}
+
+TEST(SPSC, Stream)
+{
+    const std::size_t records = 100000;
+
+    alignas(16) std::array<std::uint8_t, 4096> arr;
+    RingMemoryAllocator<8, true> ra(arr);
+
+    std::vector<std::atomic<std::uint32_t*>> queue(64);
+    for (auto& slot : queue)
+    {
+        slot.store(nullptr);
+    }
+
+    std::thread producer([&]()
+    {
+        for (std::size_t i=0; i<records; i++)
+        {
+            std::uint32_t* addr;
+            while ((addr = reinterpret_cast<std::uint32_t*>(ra.allocate(4 + ((i % 13) * 8)))) == nullptr)
+            {
+                std::this_thread::yield();
+            }
+            *addr = i;
+
+            while (queue[i % queue.size()].load(std::memory_order_acquire) != nullptr)
+            {
+                std::this_thread::yield();
+            }
+            queue[i % queue.size()].store(addr, std::memory_order_release);
+        }
+    });
+
+    std::size_t mismatches = 0;
+    for (std::size_t i=0; i<records; i++)
+    {
+        std::uint32_t* addr;
+        while ((addr = queue[i % queue.size()].load(std::memory_order_acquire)) == nullptr)
+        {
+            std::this_thread::yield();
+        }
+        queue[i % queue.size()].store(nullptr, std::memory_order_release);
+
+        mismatches += (*addr != i);
+        ra.deallocate(addr);
+    }
+
+    producer.join();
+
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_EQ(ra.allocated(), 0);
+}
@@ -0,0 +1,299 @@
+#include <array>
+#include <cstddef>
+
+#include <gtest/gtest.h>
+
+#include "Slab/slab_memory_allocator.h"
+
+const std::size_t HEADERSIZE = SlabMemoryAllocator<8192>::header_size;
+
+TEST(Constructor, NoRem)
+{
+    std::array<std::uint8_t, 8192*4> arr;
+
+    SlabMemoryAllocator<8192> sa(arr);
+
+    EXPECT_EQ(sa.length(), 8192*4);
+    EXPECT_EQ(sa.total_slabs(), 4);
+    EXPECT_EQ(sa.unused_slabs(), 4);
+    EXPECT_EQ(sa.allocated(), 0);
+}
+
+TEST(Constructor, Rem)
+{
+    std::array<std::uint8_t, (8192*4) + 100> arr;
+
+    SlabMemoryAllocator<8192> sa(arr);
+
+    EXPECT_EQ(sa.total_slabs(), 4);
+}
+
+TEST(Constructor, Region)
+{
+    std::array<std::uint8_t, 8192*4> arr;
+
+    SlabMemoryAllocator<8192> sa(arr.data(), 8192*2);
+
+    EXPECT_EQ(sa.length(), 8192*2);
+    EXPECT_EQ(sa.total_slabs(), 2);
+    EXPECT_EQ(sa.unused_slabs(), 2);
+}
+
+TEST(SizeClasses, ClassOf)
+{
+    EXPECT_EQ(SlabMemoryAllocator<8192>::class_length(SlabMemoryAllocator<8192>::class_of(1)), 8);
+    EXPECT_EQ(SlabMemoryAllocator<8192>::class_length(SlabMemoryAllocator<8192>::class_of(8)), 8);
+    EXPECT_EQ(SlabMemoryAllocator<8192>::class_length(SlabMemoryAllocator<8192>::class_of(9)), 16);
+    EXPECT_EQ(SlabMemoryAllocator<8192>::class_length(SlabMemoryAllocator<8192>::class_of(100)), 112);
+    EXPECT_EQ(SlabMemoryAllocator<8192>::class_length(SlabMemoryAllocator<8192>::class_of(129)), 160);
+    EXPECT_EQ(SlabMemoryAllocator<8192>::class_length(SlabMemoryAllocator<8192>::class_of(4095)), 4096);
+}
+
+TEST(SizeClasses, Ascending)
+{
+    for (std::size_t bytes=1; bytes<=SlabMemoryAllocator<8192>::max_bytes; bytes++)
+    {
+        std::size_t size_class = SlabMemoryAllocator<8192>::class_of(bytes);
+
+        EXPECT_GE(SlabMemoryAllocator<8192>::class_length(size_class), bytes);
+        if (size_class > 0)
+        {
+            EXPECT_LT(SlabMemoryAllocator<8192>::class_length(size_class-1), bytes);
+        }
+    }
+}
+
+TEST(Allocate, Nothing)
+{
+    std::array<std::uint8_t, 8192*4> arr;
+    SlabMemoryAllocator<8192> sa(arr);
+
+    EXPECT_EQ(sa.allocate(0), nullptr);
+    EXPECT_EQ(sa.allocated(), 0);
+}
+
+TEST(Allocate, TooManyBytes)
+{
+    std::array<std::uint8_t, 8192*4> arr;
+    SlabMemoryAllocator<8192> sa(arr);
+
+    EXPECT_EQ(sa.allocate(4097), nullptr);
+    EXPECT_EQ(sa.unused_slabs(), 4);
+}
+
+TEST(Allocate, First)
+{
+    std::array<std::uint8_t, 8192*4> arr;
+    SlabMemoryAllocator<8192> sa(arr);
+
+    void* addr = sa.allocate(10);
+
+    EXPECT_EQ(addr, reinterpret_cast<void*>(arr.data()) + HEADERSIZE);
+    EXPECT_EQ(sa.allocated(), HEADERSIZE + 16);
+    EXPECT_EQ(sa.unused_slabs(), 3);
+}
+
+TEST(Allocate, SameClass)
+{
+    std::array<std::uint8_t, 8192*4> arr;
+    SlabMemoryAllocator<8192> sa(arr);
+
+    void* addr1 = sa.allocate(10);
+    void* addr2 = sa.allocate(16);
+
+    EXPECT_EQ(addr2, addr1 + 16);
+    EXPECT_EQ(sa.unused_slabs(), 3);
+}
+
+TEST(Allocate, DifferentClasses)
+{
+    std::array<std::uint8_t, 8192*4> arr;
+    SlabMemoryAllocator<8192> sa(arr);
+
+    void* addr1 = sa.allocate(10);
+    void* addr2 = sa.allocate(100);
+
+    EXPECT_EQ(addr2, reinterpret_cast<void*>(arr.data()) + 8192 + HEADERSIZE);
+    EXPECT_EQ(sa.allocated(), (2*HEADERSIZE) + 16 + 112);
+    EXPECT_EQ(sa.unused_slabs(), 2);
+}
+
+TEST(Allocate, FullSlab)
+{
+    std::array<std::uint8_t, 8192*4> arr;
+    SlabMemoryAllocator<8192> sa(arr);
+
+    const std::size_t capacity = (8192 - HEADERSIZE) / 4096;
+
+    for (int i=0; i<capacity; i++)
+    {
+        sa.allocate(4096);
+    }
+
+    EXPECT_EQ(sa.unused_slabs(), 3);
+
+    void* addr = sa.allocate(4096);
+
+    EXPECT_EQ(addr, reinterpret_cast<void*>(arr.data()) + 8192 + HEADERSIZE);
+    EXPECT_EQ(sa.unused_slabs(), 2);
+}
+
+TEST(Allocate, NoSpace)
+{
+    std::array<std::uint8_t, 8192*2> arr;
+    SlabMemoryAllocator<8192> sa(arr);
+
+    sa.allocate(8);
+    sa.allocate(4096);
+
+    EXPECT_EQ(sa.allocate(64), nullptr);
+    EXPECT_NE(sa.allocate(8), nullptr);
+}
+
+TEST(Deallocate, Reallocate)
+{
+    std::array<std::uint8_t, 8192*4> arr;
+    SlabMemoryAllocator<8192> sa(arr);
+
+    void* addr1 = sa.allocate(32);
+    void* addr2 = sa.allocate(32);
+    sa.allocate(32);
+
+    sa.deallocate(addr2);
+
+    EXPECT_EQ(sa.allocate(32), addr2);
+
+    sa.deallocate(addr1);
+
+    EXPECT_EQ(sa.allocate(32), addr1);
+}
+
+TEST(Deallocate, EmptySlab)
+{
+    std::array<std::uint8_t, 8192*2> arr;
+    SlabMemoryAllocator<8192> sa(arr);
+
+    void* addr1 = sa.allocate(8);
+    void* addr2 = sa.allocate(8);
+    sa.allocate(4096);
+
+    sa.deallocate(addr1);
+    sa.deallocate(addr2);
+
+    EXPECT_EQ(sa.unused_slabs(), 1);
+    EXPECT_EQ(sa.allocated(), HEADERSIZE + 4096);
+
+    void* addr3 = sa.allocate(64);
+
+    EXPECT_EQ(addr3, reinterpret_cast<void*>(arr.data()) + HEADERSIZE);
+}
+
+TEST(Deallocate, FullSlab)
+{
+    std::array<std::uint8_t, 8192*4> arr;
+    SlabMemoryAllocator<8192> sa(arr);
+
+    void* addr1 = sa.allocate(4096);
+
+    for (int i=0; i<5; i++)
+    {
+        sa.allocate(4096);
+    }
+
+    sa.deallocate(addr1);
+
+    EXPECT_EQ(sa.allocate(4096), addr1);
+}
+
+TEST(Reset, AllSlabs)
+{
+    std::array<std::uint8_t, 8192*4> arr;
+    SlabMemoryAllocator<8192> sa(arr);
+
+    sa.allocate(8);
+    sa.allocate(100);
+    sa.allocate(1000);
+    sa.reset();
+
+    EXPECT_EQ(sa.allocated(), 0);
+    EXPECT_EQ(sa.unused_slabs(), 4);
+    EXPECT_EQ(sa.allocate(8), reinterpret_cast<void*>(arr.data()) + HEADERSIZE);
+}
+
+TEST(Stats, AllocateDeallocate)
+{
+    std::array<std::uint8_t, 8192*2> arr;
+    SlabMemoryAllocator<8192, AllocatorStats> sa(arr);
+
+    void* block = sa.allocate(100);
+    sa.allocate(5000);
+
+    // The slab's header is followed by the sizes requested for it's 71 blocks, rounded up to 16 bytes.
+    const std::size_t table_bytes = 144;
+
+    EXPECT_EQ(sa.stats().allocations(AllocatorStats::bucket_of(112)), 1);
+    EXPECT_EQ(sa.stats().payload_bytes(), 112);
+    EXPECT_EQ(sa.stats().internal_fragmentation(), 12);
+    EXPECT_EQ(sa.stats().metadata_bytes(), HEADERSIZE + table_bytes);
+    EXPECT_EQ(sa.stats().failed_allocations(), 1);
+
+    sa.deallocate(block);
+
+    EXPECT_EQ(sa.stats().deallocations(AllocatorStats::bucket_of(112)), 1);
+    EXPECT_EQ(sa.stats().internal_fragmentation(), 0);
+    EXPECT_EQ(sa.stats().free_bytes(), 8192*2);
+    EXPECT_EQ(sa.stats().peak_bytes(), 112 + HEADERSIZE + table_bytes);
+}
+
+TEST(Stats, RequestedSizes)
+{
+    std::array<std::uint8_t, 8192*2> arr;
+    SlabMemoryAllocator<8192, AllocatorStats> sa(arr);
+
+    // Each block keeps the size requested for it, so rounding up to the size class is counted until
+    //  the block is freed.
+    void* block1 = sa.allocate(1);
+    void* block2 = sa.allocate(8);
+    void* block3 = sa.allocate(300);
+
+    EXPECT_EQ(sa.stats().payload_bytes(), 8 + 8 + 320);
+    EXPECT_EQ(sa.stats().internal_fragmentation(), 7 + 20);
+
+    sa.deallocate(block3);
+    EXPECT_EQ(sa.stats().internal_fragmentation(), 7);
+
+    sa.deallocate(block1);
+    EXPECT_EQ(sa.stats().internal_fragmentation(), 0);
+
+    sa.deallocate(block2);
+    EXPECT_EQ(sa.stats().payload_bytes(), 0);
+}
+
+TEST(Fragmentation, Online)
+{
+    std::array<std::uint8_t, 8192*2> arr;
+    SlabMemoryAllocator<8192, AllocatorStats> sa(arr);
+
+    EXPECT_EQ(sa.stats().free_blocks(), 2);
+    EXPECT_EQ(sa.largest_free_block(), 8192);
+
+    // 3 blocks of 2048 bytes fit in each slab.
+    void* block = sa.allocate(2048);
+
+    EXPECT_EQ(sa.stats().free_blocks(), 3);
+    EXPECT_EQ(sa.largest_free_block(), 8192);
+
+    for (int i=0; i<5; i++)
+    {
+        sa.allocate(2048);
+    }
+
+    EXPECT_EQ(sa.stats().free_blocks(), 0);
+    EXPECT_EQ(sa.largest_free_block(), 0);
+
+    sa.deallocate(block);
+
+    EXPECT_EQ(sa.stats().free_blocks(), 1);
+    EXPECT_EQ(sa.largest_free_block(), 2048);
+    EXPECT_EQ(sa.external_fragmentation(), 0);
+}
@@ -0,0 +1,149 @@
+#include <array>
+#include <cstddef>
+
+#include <gtest/gtest.h>
+
+#include "Stack/frame_memory_allocator.h"
+
+const std::size_t HEADERSIZE = FrameMemoryAllocator<>::header_size;
+
+TEST(Constructor, ByteArray)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+
+    FrameMemoryAllocator<> fa(arr);
+
+    EXPECT_EQ(fa.length(), 256);
+    EXPECT_EQ(fa.allocated(), 0);
+}
+
+TEST(Constructor, Region)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+
+    FrameMemoryAllocator<> fa(arr.data(), 128);
+
+    EXPECT_EQ(fa.length(), 128);
+    EXPECT_EQ(fa.allocated(), 0);
+}
+
+TEST(Allocate, Frame)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    FrameMemoryAllocator<> fa(arr);
+
+    void* addr = fa.allocate(32);
+
+    EXPECT_EQ(addr, reinterpret_cast<void*>(arr.data()) + 256 - 32);
+    EXPECT_EQ(fa.frame_allocated(), 32 + HEADERSIZE);
+    EXPECT_EQ(fa.persistent_allocated(), 0);
+}
+
+TEST(Allocate, FrameAlignment)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    FrameMemoryAllocator<> fa(arr);
+
+    void* addr1 = fa.allocate(1);
+    void* addr2 = fa.allocate(1);
+
+    EXPECT_EQ(addr1, reinterpret_cast<void*>(arr.data()) + 256 - 16);
+    EXPECT_EQ(addr2, addr1 - 16);
+    EXPECT_EQ(fa.frame_allocated(), 16 + 16 + HEADERSIZE);
+}
+
+TEST(Allocate, Persistent)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    FrameMemoryAllocator<> fa(arr);
+
+    void* addr = fa.allocate_persistent(32);
+
+    EXPECT_EQ(addr, reinterpret_cast<void*>(arr.data()) + 16);
+    EXPECT_EQ(fa.persistent_allocated(), 16 + 32);
+    EXPECT_EQ(fa.frame_allocated(), 0);
+}
+
+TEST(Allocate, Nothing)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    FrameMemoryAllocator<> fa(arr);
+
+    EXPECT_EQ(fa.allocate(0), nullptr);
+    EXPECT_EQ(fa.allocate_persistent(0), nullptr);
+    EXPECT_EQ(fa.allocated(), 0);
+}
+
+TEST(Allocate, NoSpace)
+{
+    std::array<std::uint8_t, 64> arr;
+    FrameMemoryAllocator<1> fa(arr);
+
+    EXPECT_NE(fa.allocate_persistent(20), nullptr);
+    EXPECT_NE(fa.allocate(20), nullptr);
+    EXPECT_EQ(fa.allocate(13), nullptr);
+    EXPECT_EQ(fa.allocate_persistent(13), nullptr);
+    EXPECT_NE(fa.allocate(12), nullptr);
+    EXPECT_EQ(fa.allocated(), 64);
+}
+
+TEST(Allocate, HugeRequest)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    FrameMemoryAllocator<> fa(arr);
+
+    // The padding, header and size would wrap round to fit.
+    EXPECT_EQ(fa.allocate(SIZE_MAX), nullptr);
+    EXPECT_EQ(fa.allocate_persistent(SIZE_MAX), nullptr);
+    EXPECT_EQ(fa.allocate_persistent(SIZE_MAX - HEADERSIZE), nullptr);
+    EXPECT_EQ(fa.allocated(), 0);
+}
+
+TEST(Deallocate, BothEnds)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    FrameMemoryAllocator<> fa(arr);
+
+    void* persistent1 = fa.allocate_persistent(10);
+    void* frame1 = fa.allocate(10);
+    void* persistent2 = fa.allocate_persistent(20);
+    void* frame2 = fa.allocate(20);
+
+    fa.deallocate(persistent2);
+    fa.deallocate(frame2);
+
+    EXPECT_EQ(fa.persistent_allocated(), 16 + 10);
+    EXPECT_EQ(fa.frame_allocated(), 16 + HEADERSIZE);
+
+    fa.deallocate(frame1);
+    fa.deallocate(persistent1);
+
+    EXPECT_EQ(fa.allocated(), 0);
+}
+
+TEST(EndFrame, KeepsPersistent)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    FrameMemoryAllocator<> fa(arr);
+
+    fa.allocate_persistent(10);
+    void* addr = fa.allocate(10);
+    fa.allocate(30);
+    fa.end_frame();
+
+    EXPECT_EQ(fa.frame_allocated(), 0);
+    EXPECT_EQ(fa.persistent_allocated(), 16 + 10);
+    EXPECT_EQ(fa.allocate(10), addr);
+}
+
+TEST(Reset, Reuse)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    FrameMemoryAllocator<> fa(arr);
+
+    fa.allocate_persistent(10);
+    fa.allocate(10);
+    fa.reset();
+
+    EXPECT_EQ(fa.allocated(), 0);
+}
@@ -0,0 +1,126 @@
+#include <array>
+#include <cstddef>
+
+#include <gtest/gtest.h>
+
+#include "Stack/stack_memory_allocator.h"
+
+const std::size_t HEADERSIZE = StackMemoryAllocator<>::header_size;
+
+TEST(Constructor, ByteArray)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+
+    StackMemoryAllocator<> sa(arr);
+
+    EXPECT_EQ(sa.length(), 256);
+    EXPECT_EQ(sa.allocated(), 0);
+}
+
+TEST(Constructor, Region)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+
+    StackMemoryAllocator<> sa(arr.data(), 128);
+
+    EXPECT_EQ(sa.length(), 128);
+    EXPECT_EQ(sa.allocated(), 0);
+}
+
+TEST(Allocate, First)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    StackMemoryAllocator<> sa(arr);
+
+    void* addr = sa.allocate(32);
+
+    EXPECT_EQ(addr, reinterpret_cast<void*>(arr.data()) + 16);
+    EXPECT_EQ(sa.allocated(), 16 + 32);
+}
+
+TEST(Allocate, NoAlignment)
+{
+    std::array<std::uint8_t, 256> arr;
+    StackMemoryAllocator<1> sa(arr);
+
+    void* addr1 = sa.allocate(1);
+    void* addr2 = sa.allocate(1);
+
+    EXPECT_EQ(addr1, reinterpret_cast<void*>(arr.data()) + HEADERSIZE);
+    EXPECT_EQ(addr2, addr1 + 1 + HEADERSIZE);
+    EXPECT_EQ(sa.allocated(), 2*(1 + HEADERSIZE));
+}
+
+TEST(Allocate, Nothing)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    StackMemoryAllocator<> sa(arr);
+
+    EXPECT_EQ(sa.allocate(0), nullptr);
+    EXPECT_EQ(sa.allocated(), 0);
+}
+
+TEST(Allocate, NoSpace)
+{
+    std::array<std::uint8_t, 64> arr;
+    StackMemoryAllocator<1> sa(arr);
+
+    EXPECT_NE(sa.allocate(64 - HEADERSIZE), nullptr);
+    EXPECT_EQ(sa.allocate(1), nullptr);
+    EXPECT_EQ(sa.allocated(), 64);
+}
+
+TEST(Allocate, HugeRequest)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    StackMemoryAllocator<> sa(arr);
+
+    // The padding, header and size would wrap round to fit.
+    EXPECT_EQ(sa.allocate(SIZE_MAX), nullptr);
+    EXPECT_EQ(sa.allocate(SIZE_MAX - HEADERSIZE), nullptr);
+    EXPECT_EQ(sa.allocated(), 0);
+}
+
+TEST(Deallocate, Top)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    StackMemoryAllocator<> sa(arr);
+
+    sa.allocate(10);
+    const std::size_t before = sa.allocated();
+
+    void* addr = sa.allocate(20);
+    sa.deallocate(addr);
+
+    EXPECT_EQ(sa.allocated(), before);
+    EXPECT_EQ(sa.allocate(20), addr);
+}
+
+TEST(Deallocate, All)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    StackMemoryAllocator<> sa(arr);
+
+    void* addr1 = sa.allocate(10);
+    void* addr2 = sa.allocate(30);
+    void* addr3 = sa.allocate(5);
+
+    sa.deallocate(addr3);
+    sa.deallocate(addr2);
+    sa.deallocate(addr1);
+
+    EXPECT_EQ(sa.allocated(), 0);
+}
+
+TEST(Reset, Reuse)
+{
+    alignas(16) std::array<std::uint8_t, 256> arr;
+    StackMemoryAllocator<> sa(arr);
+
+    void* addr = sa.allocate(10);
+    sa.allocate(10);
+    sa.reset();
+
+    EXPECT_EQ(sa.allocated(), 0);
+    EXPECT_EQ(sa.allocate(10), addr);
+}
@@ -0,0 +1,388 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "allocator_stats.h"
+#include "memory_allocator.h"
+#include "FirstFit/first_fit_memory_allocator.h"
+#include "Trace/allocation_trace.h"
+#include "Trace/heap_snapshot.h"
+#include "Trace/trace_recorder.h"
+#include "Trace/trace_replay.h"
+
+const std::string TRACEFILE = "trace_tests.trace";
+
+TEST(Format, RoundTrip)
+{
+    const std::vector<TraceEvent> events = {
+        {TraceOp::allocate, 0, 16},
+        {TraceOp::allocate, 1, 300},
+        {TraceOp::reallocate, 0, 1u << 20},
+        {TraceOp::deallocate, 1, 0},
+        {TraceOp::allocate, 70000, 0},
+        {TraceOp::deallocate, 0, 0}
+    };
+
+    ASSERT_TRUE(AllocationTrace::write(TRACEFILE, events));
+
+    std::vector<TraceEvent> read;
+    ASSERT_TRUE(AllocationTrace::read(TRACEFILE, read));
+
+    EXPECT_EQ(read, events);
+
+    std::remove(TRACEFILE.c_str());
+}
+
+TEST(Format, Compact)
+{
+    const std::vector<TraceEvent> events = {
+        {TraceOp::allocate, 0, 16},
+        {TraceOp::allocate, 1, 300},
+        {TraceOp::deallocate, 0, 0}
+    };
+
+    ASSERT_TRUE(AllocationTrace::write(TRACEFILE, events));
+
+    std::ifstream file(TRACEFILE, std::ios::binary | std::ios::ate);
+
+    // Header, then op + id + size, op + id + 2 byte size, op + id.
+    EXPECT_EQ(file.tellg(), 5 + 3 + 4 + 2);
+
+    std::remove(TRACEFILE.c_str());
+}
+
+TEST(Format, Invalid)
+{
+    std::vector<TraceEvent> read;
+
+    EXPECT_FALSE(AllocationTrace::read("missing.trace", read));
+
+    std::ofstream(TRACEFILE, std::ios::binary) << "NOPE";
+    EXPECT_FALSE(AllocationTrace::read(TRACEFILE, read));
+
+    // Size cut off part way through.
+    const std::array<char, 8> truncated = {'M', 'A', 'T', 'R', AllocationTrace::version, 0, 1, char(0x80)};
+    std::ofstream(TRACEFILE, std::ios::binary).write(truncated.data(), truncated.size());
+    EXPECT_FALSE(AllocationTrace::read(TRACEFILE, read));
+
+    // Id of 2^32, too large for 32 bits.
+    const std::array<char, 11> large_id = {'M', 'A', 'T', 'R', AllocationTrace::version, 1, char(0x80), char(0x80), char(0x80), char(0x80), 0x10};
+    std::ofstream(TRACEFILE, std::ios::binary).write(large_id.data(), large_id.size());
+    EXPECT_FALSE(AllocationTrace::read(TRACEFILE, read));
+
+    // Size of 2^64, with a bit past the 64 that fit.
+    std::array<char, 17> overlong = {'M', 'A', 'T', 'R', AllocationTrace::version, 0, 0};
+    std::fill(overlong.begin() + 7, overlong.end() - 1, char(0x80));
+    overlong.back() = 0x02;
+    std::ofstream(TRACEFILE, std::ios::binary).write(overlong.data(), overlong.size());
+    EXPECT_FALSE(AllocationTrace::read(TRACEFILE, read));
+
+    // The largest size that fits is still read.
+    overlong.back() = 0x01;
+    std::ofstream(TRACEFILE, std::ios::binary).write(overlong.data(), overlong.size());
+    ASSERT_TRUE(AllocationTrace::read(TRACEFILE, read));
+    EXPECT_EQ(read, (std::vector<TraceEvent>{{TraceOp::allocate, 0, std::uint64_t(1) << 63}}));
+
+    std::remove(TRACEFILE.c_str());
+}
+
+TEST(Recorder, Events)
+{
+    std::array<std::uint8_t, 1024> arr;
+    TraceRecorder<FirstFitMemoryAllocator> rec(arr);
+
+    void* addr1 = rec.allocate(16);
+    void* addr2 = rec.allocate(32);
+    std::memset(addr1, 0xab, 16);
+    void* addr3 = rec.reallocate(addr1, 64);
+    rec.deallocate(addr2);
+    rec.deallocate(addr3);
+
+    const std::vector<TraceEvent> expected = {
+        {TraceOp::allocate, 0, 16},
+        {TraceOp::allocate, 1, 32},
+        {TraceOp::reallocate, 0, 64},
+        {TraceOp::deallocate, 1, 0},
+        {TraceOp::deallocate, 0, 0}
+    };
+
+    EXPECT_EQ(rec.events(), expected);
+    EXPECT_EQ(rec.allocated(), FirstFitMemoryAllocator::node_size);
+}
+
+TEST(Recorder, ReallocateCopies)
+{
+    std::array<std::uint8_t, 1024> arr;
+    TraceRecorder<FirstFitMemoryAllocator> rec(arr);
+
+    void* addr1 = rec.allocate(16);
+    std::memset(addr1, 0xab, 16);
+    rec.allocate(8);
+    void* addr2 = rec.reallocate(addr1, 32);
+
+    ASSERT_NE(addr2, nullptr);
+    EXPECT_NE(addr2, addr1);
+    for (std::size_t i=0; i<16; i++)
+    {
+        EXPECT_EQ(reinterpret_cast<std::uint8_t*>(addr2)[i], 0xab);
+    }
+}
+
+TEST(Recorder, Failures)
+{
+    std::array<std::uint8_t, 256> arr;
+    TraceRecorder<FirstFitMemoryAllocator> rec(arr);
+
+    void* addr = rec.allocate(64);
+
+    EXPECT_EQ(rec.allocate(1024), nullptr);
+    EXPECT_EQ(rec.reallocate(addr, 1024), nullptr);
+
+    const std::vector<TraceEvent> expected = {
+        {TraceOp::allocate, 0, 64},
+        {TraceOp::allocate, 1, 1024},
+        {TraceOp::reallocate, 0, 1024}
+    };
+
+    EXPECT_EQ(rec.events(), expected);
+    EXPECT_NE(rec.allocated(), 0);
+}
+
+TEST(Recorder, Reference)
+{
+    std::array<std::uint8_t, 1024> arr;
+    FirstFitMemoryAllocator ffma(arr);
+    TraceRecorder<MemoryAllocator&> rec(ffma);
+
+    rec.allocate(16);
+    EXPECT_EQ(ffma.allocated(), rec.allocated());
+
+    rec.reset();
+
+    EXPECT_EQ(ffma.allocated(), FirstFitMemoryAllocator::node_size);
+    EXPECT_EQ(rec.events().size(), 2);
+    EXPECT_EQ(rec.events().back(), (TraceEvent{TraceOp::deallocate, 0, 0}));
+}
+
+TEST(Replay, Deterministic)
+{
+    std::array<std::uint8_t, 16384> arr1;
+    TraceRecorder<FirstFitMemoryAllocator> rec(arr1);
+
+    std::vector<void*> live;
+    std::vector<std::size_t> allocated;
+    for (std::size_t i=0; i<200; i++)
+    {
+        if (i % 3 == 2)
+        {
+            rec.deallocate(live[i % live.size()]);
+            allocated.push_back(rec.allocated());
+            live[i % live.size()] = rec.allocate(8 + (i % 5) * 24);
+        }
+        else
+        {
+            live.push_back(rec.allocate(8 + (i % 7) * 8));
+        }
+        allocated.push_back(rec.allocated());
+    }
+
+    std::array<std::uint8_t, 16384> arr2;
+    FirstFitMemoryAllocator ffma(arr2);
+
+    ReplayResult result1 = TraceReplay::replay(ffma, rec.events(), 1, false);
+    ReplayResult result2 = TraceReplay::replay(ffma, rec.events(), 1, false);
+
+    ASSERT_EQ(result1.samples.size(), rec.events().size());
+    ASSERT_EQ(result2.samples.size(), rec.events().size());
+
+    std::size_t peak = 0;
+    for (std::size_t e=0; e<rec.events().size(); e++)
+    {
+        EXPECT_EQ(result1.samples[e].allocated, allocated[e]);
+        EXPECT_EQ(result2.samples[e].allocated, allocated[e]);
+        peak = std::max(peak, result1.samples[e].allocated);
+    }
+
+    EXPECT_EQ(result1.failures, result2.failures);
+    EXPECT_EQ(result1.peak_allocated, peak);
+}
+
+TEST(Replay, Failures)
+{
+    const std::vector<TraceEvent> events = {
+        {TraceOp::allocate, 0, 64},
+        {TraceOp::allocate, 1, 4096},
+        {TraceOp::deallocate, 1, 0},
+        {TraceOp::reallocate, 0, 4096},
+        {TraceOp::reallocate, 0, 128},
+        {TraceOp::deallocate, 0, 0}
+    };
+
+    std::array<std::uint8_t, 1024> arr;
+    FirstFitMemoryAllocator ffma(arr);
+
+    ReplayResult result = TraceReplay::replay(ffma, events, 2);
+
+    EXPECT_EQ(result.events, 6);
+    EXPECT_EQ(result.failures, (std::vector<std::size_t>{1, 3}));
+    EXPECT_EQ(result.latencies.size(), 6);
+    EXPECT_LE(result.latency_percentile(0.5), result.latency_percentile(0.99));
+    EXPECT_GE(result.peak_allocated, 128 + 2*FirstFitMemoryAllocator::node_size);
+    EXPECT_LT(result.peak_allocated, 1024);
+    ASSERT_EQ(result.samples.size(), 3);
+    EXPECT_EQ(result.samples[2].event, 5);
+}
+
+// The table of blocks has a slot for each distinct id, however large the ids are.
+TEST(Replay, SparseIds)
+{
+    const std::vector<TraceEvent> events = {
+        {TraceOp::allocate, 0xFFFFFFFF, 64},
+        {TraceOp::allocate, 5, 32},
+        {TraceOp::reallocate, 0xFFFFFFFF, 128},
+        {TraceOp::deallocate, 5, 0}
+    };
+
+    // The same trace with dense ids.
+    const std::vector<TraceEvent> dense = {
+        {TraceOp::allocate, 1, 64},
+        {TraceOp::allocate, 0, 32},
+        {TraceOp::reallocate, 1, 128},
+        {TraceOp::deallocate, 0, 0}
+    };
+
+    std::array<std::uint8_t, 1024> arr;
+    FirstFitMemoryAllocator ffma(arr);
+
+    ReplayResult result1 = TraceReplay::replay(ffma, events, 1, false);
+    ReplayResult result2 = TraceReplay::replay(ffma, dense, 1, false);
+
+    EXPECT_TRUE(result1.failures.empty());
+    ASSERT_EQ(result1.samples.size(), 4);
+    ASSERT_EQ(result2.samples.size(), 4);
+    for (std::size_t e=0; e<4; e++)
+    {
+        EXPECT_EQ(result1.samples[e].allocated, result2.samples[e].allocated);
+    }
+    EXPECT_EQ(ffma.allocated(), FirstFitMemoryAllocator::node_size);
+}
+
+TEST(Replay, Fragmentation)
+{
+    std::vector<TraceEvent> events;
+    for (std::uint32_t i=0; i<8; i++)
+    {
+        events.push_back(TraceEvent{TraceOp::allocate, i, 64});
+    }
+    for (std::uint32_t i=0; i<8; i+=2)
+    {
+        events.push_back(TraceEvent{TraceOp::deallocate, i, 0});
+    }
+
+    std::array<std::uint8_t, 9*FirstFitMemoryAllocator::node_size + 8*64> arr1;
+    BasicFirstFitMemoryAllocator<AllocatorStats> ffma_stats(arr1);
+
+    std::array<std::uint8_t, 9*FirstFitMemoryAllocator::node_size + 8*64> arr2;
+    FirstFitMemoryAllocator ffma(arr2);
+
+    ReplayResult result1 = TraceReplay::replay(ffma_stats, events, events.size());
+    ReplayResult result2 = TraceReplay::replay(ffma, events, events.size());
+
+    ASSERT_EQ(result1.samples.size(), 1);
+    ASSERT_EQ(result2.samples.size(), 1);
+    EXPECT_DOUBLE_EQ(result1.samples[0].fragmentation, 0.75);
+    EXPECT_EQ(result2.samples[0].fragmentation, 0);
+}
+
+TEST(Snapshot, Take)
+{
+    std::array<std::uint8_t, 256> arr;
+    FirstFitMemoryAllocator ff(arr);
+
+    ff.allocate(16);
+    void* block = ff.allocate(32);
+    ff.allocate(8);
+    ff.deallocate(block);
+
+    const HeapSnapshot snapshot = HeapSnapshot::take(ff, "ff");
+
+    EXPECT_EQ(snapshot.label, "ff");
+    EXPECT_EQ(snapshot.length, 256);
+    ASSERT_EQ(snapshot.blocks.size(), 4);
+    EXPECT_EQ(snapshot.blocks[1], (SnapshotBlock{16+ff.node_size, 32+ff.node_size, true, 0}));
+}
+
+TEST(Snapshot, RoundTrip)
+{
+    std::array<std::uint8_t, 1024> arr;
+    FirstFitMemoryAllocator ff(arr);
+    std::vector<void*> blocks;
+    for (std::size_t i=0; i<8; i++)
+    {
+        blocks.push_back(ff.allocate(8 + 8*i));
+    }
+
+    for (SnapshotFormat format : {SnapshotFormat::csv, SnapshotFormat::binary})
+    {
+        std::vector<HeapSnapshot> expected;
+        {
+            HeapSnapshotWriter writer(TRACEFILE, format);
+            for (std::size_t i=0; i<8; i+=2)
+            {
+                ff.deallocate(blocks[i]);
+                writer.write(ff, "ff " + std::to_string(i));
+                expected.push_back(HeapSnapshot::take(ff, "ff " + std::to_string(i)));
+            }
+            EXPECT_TRUE(writer.good());
+        }
+
+        std::vector<HeapSnapshot> read;
+        ASSERT_TRUE(HeapSnapshotWriter::read(TRACEFILE, read));
+        ASSERT_EQ(read.size(), expected.size());
+        for (std::size_t i=0; i<read.size(); i++)
+        {
+            EXPECT_EQ(read[i].label, expected[i].label);
+            EXPECT_EQ(read[i].length, expected[i].length);
+            EXPECT_EQ(read[i].blocks, expected[i].blocks);
+        }
+
+        for (std::size_t i=0; i<8; i+=2)
+        {
+            blocks[i] = ff.allocate(8 + 8*i);
+        }
+    }
+
+    std::remove(TRACEFILE.c_str());
+}
+
+TEST(Snapshot, Render)
+{
+    HeapSnapshot snapshot{"half", 64, {{0, 32, false, 0}, {32, 16, true, 0}, {48, 8, false, 0}, {56, 8, true, 0}}};
+    const HeapMapRenderer renderer(4, 2);
+
+    std::ostringstream ppm;
+    renderer.render_ppm(snapshot, ppm);
+    const std::string header = "P6\n4 2\n255\n";
+    ASSERT_EQ(ppm.str().size(), header.size() + 4*2*3);
+    EXPECT_EQ(ppm.str().substr(0, header.size()), header);
+
+    // 8 bytes per pixel: 4 allocated, 2 free, then 1 allocated and 1 free.
+    const std::string pixels = ppm.str().substr(header.size());
+    EXPECT_EQ(pixels.substr(0, 3), pixels.substr(9, 3));
+    EXPECT_NE(pixels.substr(0, 3), pixels.substr(12, 3));
+    EXPECT_EQ(pixels.substr(12, 3), pixels.substr(15, 3));
+    EXPECT_EQ(pixels.substr(18, 3), pixels.substr(0, 3));
+    EXPECT_EQ(pixels.substr(21, 3), pixels.substr(12, 3));
+
+    std::ostringstream svg;
+    renderer.render_svg(snapshot, svg);
+    EXPECT_NE(svg.str().find("<title>half</title>"), std::string::npos);
+}
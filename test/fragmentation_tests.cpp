@@ -7,17 +7,20 @@
 
 #include <gtest/gtest.h>
 
+#include "allocator_stats.h"
 #include "memory_allocator.h"
 #include "FirstFit/first_fit_memory_allocator.h"
 #include "NextFit/next_fit_memory_allocator.h"
 #include "PoolAllocation/pool_allocation_memory_allocator.h"
 #include "BuddySystem/buddy_system_memory_allocator.h"
+#include "BuddySystem/out_of_band_buddy_allocator.h"
+#include "Slab/slab_memory_allocator.h"
 
 const std::size_t NODESIZE_FF = FirstFitMemoryAllocator::node_size;
 const std::size_t NODESIZE_PA = PoolAllocationMemoryAllocator<0>::node_size;
 const std::size_t NODESIZE_BS = BuddySystemMemoryAllocator<0>::node_size;
 
-const std::array<std::string, 6> ROWS = {"FirstFit:\t\t\t", "NextFit:\t\t\t", "PoolAllocation:\t\t\t", "PoolAllocation (scaled buffer):\t", "BuddySystem:\t\t\t", "BuddySystem (scaled buffer):\t"};
+const std::array<std::string, 7> ROWS = {"FirstFit:\t\t\t", "NextFit:\t\t\t", "PoolAllocation:\t\t\t", "PoolAllocation (scaled buffer):\t", "BuddySystem:\t\t\t", "BuddySystem (scaled buffer):\t", "Slab:\t\t\t\t"};
 
 TEST(Efficiency, Allocate_NBytes)
 {
@@ -41,7 +44,10 @@ TEST(Efficiency, Allocate_NBytes)
     std::array<std::uint8_t, 10000*(8+NODESIZE_BS)> arr4_scaled;
     BuddySystemMemoryAllocator<8> bsma_scaled(arr4_scaled);
 
-    std::array<MemoryAllocator*, 6> mem_allocs = {&ffma, &nfma, &pama, &pama_scaled, &bsma, &bsma_scaled};
+    std::array<std::uint8_t, 10000*(8+NODESIZE_FF)> arr5;
+    SlabMemoryAllocator<8192> sma(arr5);
+
+    std::array<MemoryAllocator*, 7> mem_allocs = {&ffma, &nfma, &pama, &pama_scaled, &bsma, &bsma_scaled, &sma};
 
     std::cout << "\t\t\t\t\tAllocations\tBytes allocated\tCapacity\n\t\t\t\t\t\t\t(without nodes)\t(without nodes)\n";
     for (int b=0; b<bytes_alloc.size(); b++)
@@ -51,7 +57,7 @@ TEST(Efficiency, Allocate_NBytes)
         {
             if (b == 2 && (m == 2 || m == 3))
             {
-                std::cout << "\t" << ROWS[m%6] << "Blocksize too small\n";
+                std::cout << "\t" << ROWS[m%7] << "Blocksize too small\n";
                 continue;
             }
 
@@ -65,12 +71,110 @@ TEST(Efficiency, Allocate_NBytes)
             }
             while (addr != nullptr);
 
-            std::cout << "\t" << ROWS[m%6] << count << "\t\t";
+            std::cout << "\t" << ROWS[m%7] << count << "\t\t";
+            std::cout << (count*bytes_alloc[b]) << "B\t\t";
+            std::cout << 100*(static_cast<double>((count*bytes_alloc[b]))/static_cast<double>(mem_allocs[m]->length())) << "%\n";
+
+            mem_allocs[m]->reset();
+        }
+    }
+}
+
+TEST(Efficiency, Allocate_NBytes_Compact)
+{
+    const std::array<std::size_t, 2> bytes_alloc = {1, 8};
+    const std::array<std::string, 6> rows = {"FirstFit:\t\t\t", "FirstFit (compact):\t\t", "PoolAllocation:\t\t\t", "PoolAllocation (compact):\t", "BuddySystem:\t\t\t", "BuddySystem (compact):\t\t"};
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_FF)> arr1;
+    FirstFitMemoryAllocator ffma(arr1);
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_FF)> arr2;
+    CompactFirstFitMemoryAllocator ffma_compact(arr2);
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_FF)> arr3;
+    PoolAllocationMemoryAllocator<8> pama(arr3);
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_FF)> arr4;
+    PoolAllocationMemoryAllocator<8, NoStats, true> pama_compact(arr4);
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_FF)> arr5;
+    BuddySystemMemoryAllocator<8> bsma(arr5);
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_FF)> arr6;
+    BuddySystemMemoryAllocator<8, NoStats, true> bsma_compact(arr6);
+
+    std::array<MemoryAllocator*, 6> mem_allocs = {&ffma, &ffma_compact, &pama, &pama_compact, &bsma, &bsma_compact};
+
+    std::cout << "\t\t\t\t\tAllocations\tBytes allocated\tCapacity\n\t\t\t\t\t\t\t(without nodes)\t(without nodes)\n";
+    for (int b=0; b<bytes_alloc.size(); b++)
+    {
+        std::cout << "N=" << bytes_alloc[b] << "\n";
+
+        std::array<std::size_t, 6> counts;
+        for (int m=0; m<mem_allocs.size(); m++)
+        {
+            std::size_t count = 0;
+            while (mem_allocs[m]->allocate(bytes_alloc[b]) != nullptr)
+            {
+                count++;
+            }
+            counts[m] = count;
+
+            std::cout << "\t" << rows[m] << count << "\t\t";
+            std::cout << (count*bytes_alloc[b]) << "B\t\t";
+            std::cout << 100*(static_cast<double>((count*bytes_alloc[b]))/static_cast<double>(mem_allocs[m]->length())) << "%\n";
+
+            mem_allocs[m]->reset();
+        }
+
+        // Compact nodes fit more blocks into the same memory buffer.
+        EXPECT_GT(counts[1], counts[0]);
+        EXPECT_GT(counts[3], counts[2]);
+        EXPECT_GT(counts[5], counts[4]);
+    }
+}
+
+TEST(Efficiency, Allocate_NBytes_OutOfBand)
+{
+    const std::array<std::size_t, 3> bytes_alloc = {1, 8, 64};
+    const std::array<std::string, 3> rows = {"BuddySystem:\t\t\t", "BuddySystem (compact):\t\t", "BuddySystem (out of band):\t"};
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_BS)> arr1;
+    BuddySystemMemoryAllocator<8> bsma(arr1);
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_BS)> arr2;
+    BuddySystemMemoryAllocator<8, NoStats, true> bsma_compact(arr2);
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_BS)> arr3;
+    OutOfBandBuddyAllocator<8> bsma_out_of_band(arr3);
+
+    std::array<MemoryAllocator*, 3> mem_allocs = {&bsma, &bsma_compact, &bsma_out_of_band};
+
+    std::cout << "\t\t\t\t\tAllocations\tBytes allocated\tCapacity\n\t\t\t\t\t\t\t(without nodes)\t(without nodes)\n";
+    for (int b=0; b<bytes_alloc.size(); b++)
+    {
+        std::cout << "N=" << bytes_alloc[b] << "\n";
+
+        std::array<std::size_t, 3> counts;
+        for (int m=0; m<mem_allocs.size(); m++)
+        {
+            std::size_t count = 0;
+            while (mem_allocs[m]->allocate(bytes_alloc[b]) != nullptr)
+            {
+                count++;
+            }
+            counts[m] = count;
+
+            std::cout << "\t" << rows[m] << count << "\t\t";
             std::cout << (count*bytes_alloc[b]) << "B\t\t";
             std::cout << 100*(static_cast<double>((count*bytes_alloc[b]))/static_cast<double>(mem_allocs[m]->length())) << "%\n";
 
             mem_allocs[m]->reset();
         }
+
+        // A side table takes less of the memory buffer than a node in front of every block.
+        EXPECT_GT(counts[2], counts[0]);
+        EXPECT_GT(counts[2], counts[1]);
     }
 }
 
@@ -105,7 +209,10 @@ TEST(Efficiency, AllocateDeallocateP_NBytes)
     std::array<std::uint8_t, 10000*(8+NODESIZE_BS)> arr4_scaled;
     BuddySystemMemoryAllocator<8> bsma_scaled(arr4_scaled);
 
-    std::array<MemoryAllocator*, 6> mem_allocs = {&ffma, &nfma, &pama, &pama_scaled, &bsma, &bsma_scaled};
+    std::array<std::uint8_t, 10000*(8+NODESIZE_FF)> arr5;
+    SlabMemoryAllocator<8192> sma(arr5);
+
+    std::array<MemoryAllocator*, 7> mem_allocs = {&ffma, &nfma, &pama, &pama_scaled, &bsma, &bsma_scaled, &sma};
 
     std::cout << "\t\t\t\t\tAllocations\tBytes allocated\tCapacity\n";
     std::cout << "\t\t\t\t\t\t\t(without nodes)\t(inc nodes)\n";
@@ -122,7 +229,7 @@ TEST(Efficiency, AllocateDeallocateP_NBytes)
             {
                 if (b > 0 && (m == 2 || m == 3))
                 {
-                    std::cout << "\t" << ROWS[m%6] << "Blocksize too small\n";
+                    std::cout << "\t" << ROWS[m%7] << "Blocksize too small\n";
                     continue;
                 }
 
@@ -153,7 +260,7 @@ TEST(Efficiency, AllocateDeallocateP_NBytes)
                 }
                 while (addr != nullptr);
 
-                std::cout << "\t" << ROWS[m%6] << count << "\t\t";
+                std::cout << "\t" << ROWS[m%7] << count << "\t\t";
                 std::cout << bytes_allocated << "B\t\t";
                 std::cout << 100*(static_cast<double>(mem_allocs[m]->allocated())/static_cast<double>(mem_allocs[m]->length())) << "%\n";
                 
@@ -174,6 +281,10 @@ TEST(Segmentation, CapacityC_NBytes)
         std::array<std::size_t, 2>{1, 64+(7*NODESIZE_BS)}
     };
 
+    // Churn stops at the first failed allocation, or after 'max_ops' operations when the allocator
+    //  keeps it's capacity for that long.
+    const std::size_t max_ops = 200000;
+
     const time_t seed = time(NULL);
     std::cout << "Seed: " << seed << "\n";
 
@@ -201,7 +312,7 @@ TEST(Segmentation, CapacityC_NBytes)
             {
                 if (m >= 2)
                 {
-                    std::cout << "\t" << ROWS[m%6] << "N/A\n";
+                    std::cout << "\t" << ROWS[m%7] << "N/A\n";
                     continue;
                 }
 
@@ -218,7 +329,7 @@ TEST(Segmentation, CapacityC_NBytes)
                 }
 
                 std::size_t pos = rand() % (allocs.size()-1);
-                while (allocs.at(pos) != nullptr)
+                while (allocs.at(pos) != nullptr && count < max_ops)
                 {
                     mem_allocs[m]->deallocate(allocs.at(pos));
                     allocs.erase(allocs.begin() + pos);
@@ -231,7 +342,7 @@ TEST(Segmentation, CapacityC_NBytes)
                     count++;
                 }
 
-                std::cout << "\t" << ROWS[m%6] << count << "\t\t";
+                std::cout << "\t" << ROWS[m%7] << count << "\t\t";
                 std::cout << 100*(static_cast<double>(mem_allocs[m]->allocated()) / static_cast<double>(mem_allocs[m]->length())) << "%\n";
 
                 mem_allocs[m]->reset();
@@ -239,3 +350,178 @@ TEST(Segmentation, CapacityC_NBytes)
         }
     }
 }
+
+TEST(Efficiency, InternalFragmentation_NBytes)
+{
+    const std::array<std::array<std::size_t, 2>, 5> byte_ranges = {
+        std::array<std::size_t, 2>{1, 8},
+        std::array<std::size_t, 2>{9, 16+NODESIZE_BS},
+        std::array<std::size_t, 2>{32+(3*NODESIZE_BS), 64+(7*NODESIZE_BS)},
+        std::array<std::size_t, 2>{1, 64+(7*NODESIZE_BS)},
+        std::array<std::size_t, 2>{1, 4096}
+    };
+
+    const time_t seed = time(NULL);
+    std::cout << "Seed: " << seed << "\n";
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_FF)> arr1;
+    FirstFitMemoryAllocator ffma(arr1);
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_FF)> arr2;
+    BuddySystemMemoryAllocator<8> bsma(arr2);
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_FF)> arr3;
+    SlabMemoryAllocator<8192> sma(arr3);
+
+    std::array<MemoryAllocator*, 3> mem_allocs = {&ffma, &bsma, &sma};
+    const std::array<std::string, 3> rows = {ROWS[0], ROWS[4], ROWS[6]};
+
+    std::cout << "\t\t\t\t\tAllocations\tBytes allocated\tOverhead\n";
+    std::cout << "\t\t\t\t\t\t\t(without nodes)\t(inc nodes)\n";
+    for (std::size_t b=0; b<byte_ranges.size(); b++)
+    {
+        const std::size_t lower_bound = byte_ranges[b][0];
+        const std::size_t upper_bound = byte_ranges[b][1];
+
+        std::cout << "N=[" << byte_ranges[b][0] << ", " << byte_ranges[b][1] << "]\n";
+        for (std::size_t m=0; m<mem_allocs.size(); m++)
+        {
+            srand(seed);
+
+            std::vector<std::pair<void*, std::size_t>> allocs;
+
+            std::size_t count = 0;
+            std::size_t bytes_allocated = 0;
+
+            void* addr;
+            do
+            {
+                std::size_t bytes = (rand()%(upper_bound-lower_bound+1)) + lower_bound;
+
+                addr = mem_allocs[m]->allocate(bytes);
+                if (addr != nullptr)
+                {
+                    allocs.push_back(std::make_pair(addr, bytes));
+                    bytes_allocated += bytes;
+                    count++;
+                }
+
+                if (count > 1 && count%3 == 0)
+                {
+                    std::size_t pos = rand() % allocs.size();
+                    mem_allocs[m]->deallocate(allocs[pos].first);
+                    bytes_allocated -= allocs[pos].second;
+                    allocs.erase(allocs.begin() + pos);
+                }
+            }
+            while (addr != nullptr);
+
+            std::cout << "\t" << rows[m] << count << "\t\t";
+            std::cout << bytes_allocated << "B\t\t";
+            std::cout << 100*(1 - (static_cast<double>(bytes_allocated)/static_cast<double>(mem_allocs[m]->allocated()))) << "%\n";
+
+            mem_allocs[m]->reset();
+        }
+        std::cout << "\n";
+    }
+}
+
+// Replaces a random one of 'live' blocks of 1 to 'max_bytes' bytes in 'alloc' 'n' times, printing it's online
+//  fragmentation metrics every 'n'/5 operations.
+template <class Allocator>
+void print_fragmentation(Allocator& alloc, unsigned int seed, std::size_t live, std::size_t max_bytes, std::size_t n)
+{
+    srand(seed);
+
+    std::vector<void*> allocs(live, nullptr);
+    for (std::size_t i=1; i<=n; i++)
+    {
+        void*& block = allocs[rand() % live];
+        if (block != nullptr)
+        {
+            alloc.deallocate(block);
+        }
+        block = alloc.allocate((rand() % max_bytes) + 1);
+
+        if (i % (n/5) == 0)
+        {
+            std::cout << "\t\t" << i << "\t" << alloc.stats().free_blocks() << "\t\t" << alloc.largest_free_block() << "B\t\t"
+                << alloc.external_fragmentation() << "\t\t" << alloc.stats().internal_fragmentation() << "B\n";
+        }
+    }
+
+    alloc.reset();
+}
+
+TEST(Fragmentation, Online_NOps)
+{
+    const std::size_t live = 200;
+    const std::size_t max_bytes = 64+(7*NODESIZE_BS);
+    const std::size_t n = 50000;
+
+    const time_t seed = time(NULL);
+    std::cout << "Seed: " << seed << "\n";
+
+    std::array<std::uint8_t, 65536> arr1;
+    BasicFirstFitMemoryAllocator<AllocatorStats> ffma(arr1);
+
+    std::array<std::uint8_t, 65536> arr2;
+    BasicNextFitMemoryAllocator<AllocatorStats> nfma(arr2);
+
+    std::array<std::uint8_t, 65536> arr3;
+    PoolAllocationMemoryAllocator<max_bytes, AllocatorStats> pama(arr3);
+
+    std::array<std::uint8_t, 65536> arr4;
+    BuddySystemMemoryAllocator<8, AllocatorStats> bsma(arr4);
+
+    std::array<std::uint8_t, 65536> arr5;
+    SlabMemoryAllocator<8192, AllocatorStats> sma(arr5);
+
+    std::cout << "\t\tOps\tFree blocks\tLargest free\tExternal\tInternal\n";
+
+    std::cout << "\t" << ROWS[0] << "\n";
+    print_fragmentation(ffma, seed, live, max_bytes, n);
+    std::cout << "\t" << ROWS[1] << "\n";
+    print_fragmentation(nfma, seed, live, max_bytes, n);
+    std::cout << "\t" << ROWS[2] << "\n";
+    print_fragmentation(pama, seed, live, max_bytes, n);
+    std::cout << "\t" << ROWS[4] << "\n";
+    print_fragmentation(bsma, seed, live, max_bytes, n);
+    std::cout << "\t" << ROWS[6] << "\n";
+    print_fragmentation(sma, seed, live, max_bytes, n);
+}
+
+TEST(Fragmentation, Online_NOps_Watermarks)
+{
+    const std::size_t live = 200;
+    const std::size_t max_bytes = 64+(7*NODESIZE_BS);
+    const std::size_t n = 50000;
+
+    const time_t seed = time(NULL);
+    std::cout << "Seed: " << seed << "\n";
+
+    std::array<std::uint8_t, 65536> arr1;
+    BuddySystemMemoryAllocator<8, AllocatorStats> bsma(arr1);
+
+    std::array<std::uint8_t, 65536> arr2;
+    BuddySystemMemoryAllocator<8, AllocatorStats> bsma_watermarks(arr2);
+    bsma_watermarks.set_watermarks(0, 4, 16);
+    bsma_watermarks.set_watermarks(1, 2, 8);
+    bsma_watermarks.set_watermarks(2, 1, 4);
+
+    std::cout << "\t\tOps\tFree blocks\tLargest free\tExternal\tInternal\n";
+
+    std::cout << "\t" << ROWS[4] << "\n";
+    print_fragmentation(bsma, seed, live, max_bytes, n);
+    std::cout << "\tBuddySystem (watermarks):\n";
+    print_fragmentation(bsma_watermarks, seed, live, max_bytes, n);
+
+    std::cout << "\t\t\tSplits\tMerges\tFailed\n";
+    std::cout << "\t" << ROWS[4] << bsma.stats().splits() << "\t" << bsma.stats().merges() << "\t" << bsma.stats().failed_allocations() << "\n";
+    std::cout << "\tBuddySystem (watermarks):\t" << bsma_watermarks.stats().splits() << "\t" << bsma_watermarks.stats().merges() << "\t"
+        << bsma_watermarks.stats().failed_allocations() << "\n";
+
+    // Keeping free blocks of each size around saves splitting and merging them again.
+    EXPECT_LT(bsma_watermarks.stats().splits(), bsma.stats().splits());
+    EXPECT_LT(bsma_watermarks.stats().merges(), bsma.stats().merges());
+}
@@ -1,16 +1,31 @@
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
+#include "allocator_stats.h"
 #include "memory_allocator.h"
 #include "FirstFit/first_fit_memory_allocator.h"
 #include "NextFit/next_fit_memory_allocator.h"
 #include "PoolAllocation/pool_allocation_memory_allocator.h"
 #include "BuddySystem/buddy_system_memory_allocator.h"
+#include "Arena/concurrent_arena_allocator.h"
+#include "Arena/monotonic_arena_allocator.h"
+#include "Composition/locked_allocator.h"
+#include "Composition/segregator.h"
+#include "Ring/ring_memory_allocator.h"
+#include "Slab/slab_memory_allocator.h"
+#include "Stack/frame_memory_allocator.h"
+#include "Stack/stack_memory_allocator.h"
+#include "memory_region.h"
 
 const std::size_t NODESIZE_FF = FirstFitMemoryAllocator::node_size;
 const std::size_t NODESIZE_PA = PoolAllocationMemoryAllocator<0>::node_size;
@@ -1197,4 +1212,722 @@ TEST(Deallocation, MergePrevNext_NTimes)
     std::cout << "\t" << ROWS[2] << "N/A\n";
     std::cout << "\t" << ROWS[3] << "Buffer too large\n";
     std::cout << "\t" << ROWS[4] << "Buffer too large\n";
-}
\ No newline at end of file
+}
+
+// Allocates and deallocates a block of 'bytes' 'n' times through 'alloc' and returns the time taken in nanoseconds.
+//  Instantiated with a concrete allocator type the calls are statically dispatched, and with MemoryAllocator they
+//  go through the vtable.
+template <class Allocator>
+double alloc_dealloc_time(Allocator& alloc, std::size_t bytes, std::size_t n)
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (std::size_t i=0; i<n; i++)
+    {
+        alloc.deallocate(alloc.allocate(bytes));
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+}
+
+TEST(Dispatch, StaticVirtual_NTimes)
+{
+    const std::size_t bytes_alloc = 1;
+    const std::size_t bytes_alloc_large = 64+(7*NODESIZE_BS);
+
+    const std::array<std::size_t, 3> sizeN = {1000, 10000, 50000};
+
+    std::array<std::uint8_t, 10*(bytes_alloc+NODESIZE_FF)> arr1;
+    FirstFitMemoryAllocator ffma(arr1);
+
+    std::array<std::uint8_t, 10*(bytes_alloc+NODESIZE_FF)> arr2;
+    NextFitMemoryAllocator nfma(arr2);
+
+    std::array<std::uint8_t, 10*(bytes_alloc+NODESIZE_PA)> arr3;
+    PoolAllocationMemoryAllocator<8> pama(arr3);
+
+    std::array<std::uint8_t, 10*(bytes_alloc+NODESIZE_BS)> arr4;
+    BuddySystemMemoryAllocator<8> bsma(arr4);
+
+    std::array<std::uint8_t, 10*(bytes_alloc_large+NODESIZE_BS)> arr5;
+    BuddySystemMemoryAllocator<8> bsma_large(arr5);
+
+    std::array<MemoryAllocator*, 5> mem_allocs = {&ffma, &nfma, &pama, &bsma, &bsma_large};
+
+    std::cout << "\t\t\t\t\tStatic\t\tVirtual\n";
+    for (std::size_t n=0; n<sizeN.size(); n++)
+    {
+        std::cout << "N=" << sizeN[n] << "\n";
+        for (std::size_t m=0; m<mem_allocs.size(); m++)
+        {
+            const std::size_t bytes_number = (m == 4) ? bytes_alloc_large : bytes_alloc;
+
+            double time_static = 0;
+            switch (m)
+            {
+                case 0:
+                    time_static = alloc_dealloc_time(ffma, bytes_number, sizeN[n]);
+                    break;
+                case 1:
+                    time_static = alloc_dealloc_time(nfma, bytes_number, sizeN[n]);
+                    break;
+                case 2:
+                    time_static = alloc_dealloc_time(pama, bytes_number, sizeN[n]);
+                    break;
+                case 3:
+                    time_static = alloc_dealloc_time(bsma, bytes_number, sizeN[n]);
+                    break;
+                case 4:
+                    time_static = alloc_dealloc_time(bsma_large, bytes_number, sizeN[n]);
+                    break;
+            }
+
+            double time_virtual = alloc_dealloc_time(*mem_allocs[m], bytes_number, sizeN[n]);
+
+            std::cout << "\t" << ROWS[m] << time_static/1000000 << "ms\t\t" << time_virtual/1000000 << "ms\n";
+        }
+    }
+}
+
+// Keeps 'live' blocks of mixed sizes allocated in 'alloc', replacing a random one 'n' times, and returns the time taken
+//  in nanoseconds. Most requests are tiny, some are medium and a few are large. Failed allocations are added to 'failed'.
+template <class Allocator>
+double mixed_sizes_time(Allocator& alloc, unsigned int seed, std::size_t live, std::size_t n, std::size_t& failed)
+{
+    srand(seed);
+
+    std::vector<void*> allocs(live, nullptr);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (std::size_t i=0; i<n; i++)
+    {
+        std::size_t pos = rand() % live;
+        if (allocs[pos] != nullptr)
+        {
+            alloc.deallocate(allocs[pos]);
+        }
+
+        std::size_t p = rand() % 100;
+        std::size_t bytes;
+        if (p < 70)
+        {
+            bytes = (rand() % 8) + 1;
+        }
+        else if (p < 95)
+        {
+            bytes = (rand() % 120) + 9;
+        }
+        else
+        {
+            bytes = (rand() % 384) + 129;
+        }
+
+        allocs[pos] = alloc.allocate(bytes);
+        if (allocs[pos] == nullptr)
+        {
+            failed++;
+        }
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    alloc.reset();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+}
+
+TEST(Composition, MixedSizes_NTimes)
+{
+    const std::size_t live = 500;
+    const std::array<std::size_t, 3> sizeN = {1000, 10000, 50000};
+
+    const time_t seed = time(NULL);
+    std::cout << "Seed: " << seed << "\n";
+
+    std::array<std::uint8_t, 65536> arr1;
+    FirstFitMemoryAllocator ffma(arr1);
+
+    std::array<std::uint8_t, 65536> arr2;
+    NextFitMemoryAllocator nfma(arr2);
+
+    std::array<std::uint8_t, 65536> arr3;
+    PoolAllocationMemoryAllocator<8> pama(arr3);
+
+    std::array<std::uint8_t, 65536> arr4;
+    BuddySystemMemoryAllocator<8> bsma(arr4);
+
+    std::array<std::uint8_t, 16384> arr5_small;
+    std::array<std::uint8_t, 16384> arr5_medium;
+    std::array<std::uint8_t, 32768> arr5_large;
+    Segregator<8, PoolAllocationMemoryAllocator<8>, Segregator<176, BuddySystemMemoryAllocator<8>, FirstFitMemoryAllocator>> composed(
+        std::piecewise_construct, std::forward_as_tuple(arr5_small), std::forward_as_tuple(arr5_medium, arr5_large)
+        );
+
+    const std::array<std::string, 5> rows = {ROWS[0], ROWS[1], ROWS[2], ROWS[3], "Pool/Buddy/FirstFit:\t\t"};
+
+    std::cout << "\t\t\t\t\tTime\t\tFailed allocations\n";
+    for (std::size_t n=0; n<sizeN.size(); n++)
+    {
+        std::cout << "N=" << sizeN[n] << "\n";
+        for (std::size_t m=0; m<rows.size(); m++)
+        {
+            std::size_t failed = 0;
+            double time = 0;
+            switch (m)
+            {
+                case 0:
+                    time = mixed_sizes_time(ffma, seed, live, sizeN[n], failed);
+                    break;
+                case 1:
+                    time = mixed_sizes_time(nfma, seed, live, sizeN[n], failed);
+                    break;
+                case 2:
+                    time = mixed_sizes_time(pama, seed, live, sizeN[n], failed);
+                    break;
+                case 3:
+                    time = mixed_sizes_time(bsma, seed, live, sizeN[n], failed);
+                    break;
+                case 4:
+                    time = mixed_sizes_time(composed, seed, live, sizeN[n], failed);
+                    break;
+            }
+
+            std::cout << "\t" << rows[m] << time/1000000 << "ms\t\t" << failed << "\n";
+        }
+    }
+}
+
+TEST(Allocation, SizeClasses_NTimes)
+{
+    const std::size_t live = 500;
+    const std::array<std::size_t, 3> sizeN = {1000, 10000, 50000};
+
+    const time_t seed = time(NULL);
+    std::cout << "Seed: " << seed << "\n";
+
+    std::array<std::uint8_t, 65536> arr1;
+    FirstFitMemoryAllocator ffma(arr1);
+
+    std::array<std::uint8_t, 65536> arr2;
+    BuddySystemMemoryAllocator<8> bsma(arr2);
+
+    std::array<std::uint8_t, 65536> arr3;
+    SlabMemoryAllocator<8192> sma(arr3);
+
+    const std::array<std::string, 3> rows = {ROWS[0], ROWS[3], "Slab:\t\t\t\t"};
+
+    std::cout << "\t\t\t\t\tTime\t\tFailed allocations\n";
+    for (std::size_t n=0; n<sizeN.size(); n++)
+    {
+        std::cout << "N=" << sizeN[n] << "\n";
+        for (std::size_t m=0; m<rows.size(); m++)
+        {
+            std::size_t failed = 0;
+            double time = 0;
+            switch (m)
+            {
+                case 0:
+                    time = mixed_sizes_time(ffma, seed, live, sizeN[n], failed);
+                    break;
+                case 1:
+                    time = mixed_sizes_time(bsma, seed, live, sizeN[n], failed);
+                    break;
+                case 2:
+                    time = mixed_sizes_time(sma, seed, live, sizeN[n], failed);
+                    break;
+            }
+
+            std::cout << "\t" << rows[m] << time/1000000 << "ms\t\t" << failed << "\n";
+        }
+    }
+}
+
+// Allocates 'n' blocks of 'bytes' through 'alloc' and then deallocates all of them, like scratch data that dies at the
+//  end of a request, and returns the time taken in nanoseconds.
+template <class Allocator>
+double scratch_time(Allocator& alloc, std::size_t bytes, std::size_t n, std::vector<void*>& allocs)
+{
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (std::size_t i=0; i<n; i++)
+    {
+        allocs[i] = alloc.allocate(bytes);
+    }
+    for (std::size_t i=0; i<n; i++)
+    {
+        alloc.deallocate(allocs[i]);
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+}
+
+TEST(Allocation, Scratch_NTimes)
+{
+    const std::size_t bytes_alloc = 1;
+    const std::size_t bytes_alloc_large = 64+(7*NODESIZE_BS);
+
+    const std::array<std::size_t, 2> sizeN = {1000, 10000};
+
+    std::array<std::uint8_t, 10000*(bytes_alloc+NODESIZE_FF)> arr1;
+    FirstFitMemoryAllocator ffma(arr1);
+
+    std::array<std::uint8_t, 10000*(bytes_alloc+NODESIZE_FF)> arr2;
+    NextFitMemoryAllocator nfma(arr2);
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_PA)> arr3;
+    PoolAllocationMemoryAllocator<8> pama(arr3);
+
+    std::array<std::uint8_t, 10000*(8+NODESIZE_BS)> arr4;
+    BuddySystemMemoryAllocator<8> bsma(arr4);
+
+    std::array<std::uint8_t, 10000*16> arr5;
+    MonotonicArenaAllocator<> maa(arr5);
+
+    std::array<std::uint8_t, 10000*(bytes_alloc_large+NODESIZE_BS)> arr6;
+    MonotonicArenaAllocator<> maa_large(arr6);
+
+    const std::array<std::string, 6> rows = {ROWS[0], ROWS[1], ROWS[2], ROWS[3], "MonotonicArena:\t\t\t", "MonotonicArena (large alloc):\t"};
+
+    std::vector<void*> allocs(sizeN.back());
+
+    for (std::size_t n=0; n<sizeN.size(); n++)
+    {
+        std::cout << "N=" << sizeN[n] << "\n";
+        for (std::size_t m=0; m<rows.size(); m++)
+        {
+            double time = 0;
+            switch (m)
+            {
+                case 0:
+                    time = scratch_time(ffma, bytes_alloc, sizeN[n], allocs);
+                    break;
+                case 1:
+                    time = scratch_time(nfma, bytes_alloc, sizeN[n], allocs);
+                    break;
+                case 2:
+                    time = scratch_time(pama, bytes_alloc, sizeN[n], allocs);
+                    break;
+                case 3:
+                    time = scratch_time(bsma, bytes_alloc, sizeN[n], allocs);
+                    break;
+                case 4:
+                {
+                    MonotonicArenaAllocator<>::Scope scope(maa);
+                    time = scratch_time(maa, bytes_alloc, sizeN[n], allocs);
+                    std::cout << "\t" << rows[m] << time/1000000 << "ms\t(" << maa.padding() << "B padding)\n";
+                    continue;
+                }
+                case 5:
+                {
+                    MonotonicArenaAllocator<>::Scope scope(maa_large);
+                    time = scratch_time(maa_large, bytes_alloc_large, sizeN[n], allocs);
+                    std::cout << "\t" << rows[m] << time/1000000 << "ms\t(" << maa_large.padding() << "B padding)\n";
+                    continue;
+                }
+            }
+
+            std::cout << "\t" << rows[m] << time/1000000 << "ms\n";
+        }
+    }
+}
+
+// Starts 'threads' threads that each allocate 'n' blocks of 'bytes' through 'alloc' and then deallocate them, and
+//  returns the time taken for all of them to finish in nanoseconds.
+template <class Allocator>
+double threads_time(Allocator& alloc, std::size_t threads, std::size_t bytes, std::size_t n)
+{
+    std::vector<std::vector<void*>> allocs(threads, std::vector<void*>(n));
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> workers;
+    for (std::size_t t=0; t<threads; t++)
+    {
+        workers.emplace_back([&alloc, &allocs, t, bytes, n]()
+        {
+            for (std::size_t i=0; i<n; i++)
+            {
+                allocs[t][i] = alloc.allocate(bytes);
+            }
+            for (std::size_t i=0; i<n; i++)
+            {
+                alloc.deallocate(allocs[t][i]);
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+}
+
+TEST(Concurrency, Arena_NThreads)
+{
+    const std::size_t bytes_alloc = 16;
+    const std::size_t allocs_per_thread = 2000;
+
+    const std::array<std::size_t, 7> sizeThreads = {1, 2, 4, 8, 16, 32, 64};
+
+    std::vector<std::uint8_t> buffer1(sizeThreads.back()*allocs_per_thread*(bytes_alloc+NODESIZE_FF));
+    MemoryRegion region1(buffer1.data(), buffer1.size());
+    LockedAllocator<FirstFitMemoryAllocator> lffma(region1);
+
+    std::vector<std::uint8_t> buffer2(sizeThreads.back()*allocs_per_thread*bytes_alloc*4);
+    MemoryRegion region2(buffer2.data(), buffer2.size());
+    ConcurrentArenaAllocator<> caa(region2);
+
+    const std::array<std::string, 2> rows = {"FirstFit (locked):\t\t", "ConcurrentArena:\t\t"};
+
+    for (std::size_t n=0; n<sizeThreads.size(); n++)
+    {
+        std::cout << "Threads=" << sizeThreads[n] << "\n";
+        for (std::size_t m=0; m<rows.size(); m++)
+        {
+            double time = 0;
+            switch (m)
+            {
+                case 0:
+                    time = threads_time(lffma, sizeThreads[n], bytes_alloc, allocs_per_thread);
+                    lffma.reset();
+                    break;
+                case 1:
+                    time = threads_time(caa, sizeThreads[n], bytes_alloc, allocs_per_thread);
+                    caa.reset();
+                    break;
+            }
+
+            const double ops = 2.0*sizeThreads[n]*allocs_per_thread;
+            std::cout << "\t" << rows[m] << time/1000000 << "ms\t(" << ops/(time/1000000000)/1000000 << "M ops/s)\n";
+        }
+    }
+}
+
+// Runs 'n' frames through 'alloc', each pushing up to 'depth' blocks of 1 to 256 bytes and popping them again in
+//  reverse order, and returns the time taken in nanoseconds. The trace is generated before timing starts.
+template <class Allocator>
+double lifo_time(Allocator& alloc, unsigned int seed, std::size_t depth, std::size_t n)
+{
+    srand(seed);
+
+    std::vector<std::size_t> frame_depths(n);
+    std::vector<std::size_t> sizes(n*depth);
+    for (std::size_t i=0; i<n; i++)
+    {
+        frame_depths[i] = (rand() % depth) + 1;
+        for (std::size_t j=0; j<depth; j++)
+        {
+            sizes[(i*depth)+j] = (rand() % 256) + 1;
+        }
+    }
+
+    std::vector<void*> allocs(depth);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (std::size_t i=0; i<n; i++)
+    {
+        for (std::size_t j=0; j<frame_depths[i]; j++)
+        {
+            allocs[j] = alloc.allocate(sizes[(i*depth)+j]);
+        }
+        for (std::size_t j=frame_depths[i]; j>0; j--)
+        {
+            alloc.deallocate(allocs[j-1]);
+        }
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+}
+
+TEST(Allocation, LIFO_NTimes)
+{
+    const std::size_t depth = 64;
+    const unsigned int seed = 42;
+
+    const std::array<std::size_t, 3> sizeN = {1000, 10000, 50000};
+
+    std::array<std::uint8_t, depth*(256+NODESIZE_FF)+NODESIZE_FF> arr1;
+    FirstFitMemoryAllocator ffma(arr1);
+
+    alignas(16) std::array<std::uint8_t, depth*(256+32)> arr2;
+    StackMemoryAllocator<> sma(arr2);
+
+    alignas(16) std::array<std::uint8_t, depth*(256+32)> arr3;
+    FrameMemoryAllocator<> fma(arr3);
+
+    const std::array<std::string, 3> rows = {ROWS[0], "Stack:\t\t\t\t", "Frame:\t\t\t\t"};
+
+    for (std::size_t n=0; n<sizeN.size(); n++)
+    {
+        std::cout << "N=" << sizeN[n] << "\n";
+        for (std::size_t m=0; m<rows.size(); m++)
+        {
+            double time = 0;
+            switch (m)
+            {
+                case 0:
+                    time = lifo_time(ffma, seed, depth, sizeN[n]);
+                    break;
+                case 1:
+                    time = lifo_time(sma, seed, depth, sizeN[n]);
+                    break;
+                case 2:
+                    time = lifo_time(fma, seed, depth, sizeN[n]);
+                    break;
+            }
+
+            std::cout << "\t" << rows[m] << time/1000000 << "ms\n";
+        }
+    }
+}
+
+// Returns the value below which 'p' percent of 'sorted' falls.
+double percentile(const std::vector<double>& sorted, double p)
+{
+    return sorted[static_cast<std::size_t>((p / 100) * (sorted.size() - 1))];
+}
+
+// Streams 'n' records of 16 to 512 bytes through 'alloc', keeping the last 'window' allocated and freeing them in
+//  the order they were allocated. Returns the time taken in nanoseconds and fills 'latencies' with the time each
+//  allocation took, sorted. Bytes of records that were allocated are added to 'streamed'.
+template <class Allocator>
+double stream_time(Allocator& alloc, unsigned int seed, std::size_t window, std::size_t n, std::vector<double>& latencies, std::size_t& streamed)
+{
+    srand(seed);
+
+    std::vector<std::size_t> sizes(n);
+    for (std::size_t i=0; i<n; i++)
+    {
+        sizes[i] = 16 + (rand() % 497);
+    }
+
+    std::vector<void*> allocs(window, nullptr);
+    latencies.resize(n);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (std::size_t i=0; i<n; i++)
+    {
+        void*& slot = allocs[i % window];
+        if (slot != nullptr)
+        {
+            alloc.deallocate(slot);
+        }
+
+        auto alloc_start = std::chrono::high_resolution_clock::now();
+        slot = alloc.allocate(sizes[i]);
+        auto alloc_end = std::chrono::high_resolution_clock::now();
+
+        latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(alloc_end - alloc_start).count();
+        if (slot != nullptr)
+        {
+            streamed += sizes[i];
+        }
+    }
+    for (std::size_t i=0; i<window; i++)
+    {
+        if (allocs[(n + i) % window] != nullptr)
+        {
+            alloc.deallocate(allocs[(n + i) % window]);
+        }
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    std::sort(latencies.begin(), latencies.end());
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+}
+
+TEST(Streaming, FIFO_NRecords)
+{
+    const std::size_t window = 64;
+    const unsigned int seed = 42;
+
+    const std::array<std::size_t, 2> sizeN = {10000, 100000};
+
+    std::array<std::uint8_t, window*(512+NODESIZE_FF)+NODESIZE_FF> arr1;
+    FirstFitMemoryAllocator ffma(arr1);
+
+    std::array<std::uint8_t, window*(512+NODESIZE_FF)+NODESIZE_FF> arr2;
+    NextFitMemoryAllocator nfma(arr2);
+
+    alignas(16) std::array<std::uint8_t, window*(512+16)+512> arr3;
+    RingMemoryAllocator<> rma(arr3);
+
+    const std::array<std::string, 3> rows = {ROWS[0], ROWS[1], "Ring:\t\t\t\t"};
+
+    std::vector<double> latencies;
+
+    std::cout << "\t\t\t\tTime\t\tGB/s\tp50\tp99\tp99.9\tmax\n";
+    for (std::size_t n=0; n<sizeN.size(); n++)
+    {
+        std::cout << "N=" << sizeN[n] << "\n";
+        for (std::size_t m=0; m<rows.size(); m++)
+        {
+            std::size_t streamed = 0;
+            double time = 0;
+            switch (m)
+            {
+                case 0:
+                    time = stream_time(ffma, seed, window, sizeN[n], latencies, streamed);
+                    break;
+                case 1:
+                    time = stream_time(nfma, seed, window, sizeN[n], latencies, streamed);
+                    break;
+                case 2:
+                    time = stream_time(rma, seed, window, sizeN[n], latencies, streamed);
+                    break;
+            }
+
+            std::cout << "\t" << rows[m] << time/1000000 << "ms\t" << streamed/time << "\t"
+                << percentile(latencies, 50) << "ns\t" << percentile(latencies, 99) << "ns\t"
+                << percentile(latencies, 99.9) << "ns\t" << latencies.back() << "ns\n";
+        }
+    }
+}
+
+TEST(Streaming, SPSC_NRecords)
+{
+    const std::array<std::size_t, 2> sizeN = {10000, 100000};
+
+    alignas(16) std::array<std::uint8_t, 65536> arr;
+    RingMemoryAllocator<8, true> rma(arr);
+
+    std::vector<std::atomic<void*>> queue(256);
+
+    for (std::size_t n=0; n<sizeN.size(); n++)
+    {
+        for (auto& slot : queue)
+        {
+            slot.store(nullptr);
+        }
+
+        const std::size_t records = sizeN[n];
+        std::size_t bytes = 0;
+
+        auto start_time = std::chrono::high_resolution_clock::now();
+        std::thread producer([&]()
+        {
+            for (std::size_t i=0; i<records; i++)
+            {
+                void* addr;
+                while ((addr = rma.allocate(16 + ((i * 97) % 497))) == nullptr)
+                {
+                    std::this_thread::yield();
+                }
+
+                while (queue[i % queue.size()].load(std::memory_order_acquire) != nullptr)
+                {
+                    std::this_thread::yield();
+                }
+                queue[i % queue.size()].store(addr, std::memory_order_release);
+            }
+        });
+
+        for (std::size_t i=0; i<records; i++)
+        {
+            void* addr;
+            while ((addr = queue[i % queue.size()].load(std::memory_order_acquire)) == nullptr)
+            {
+                std::this_thread::yield();
+            }
+            queue[i % queue.size()].store(nullptr, std::memory_order_release);
+
+            bytes += 16 + ((i * 97) % 497);
+            rma.deallocate(addr);
+        }
+
+        producer.join();
+        auto end_time = std::chrono::high_resolution_clock::now();
+
+        const double time = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+        std::cout << "N=" << sizeN[n] << "\n";
+        std::cout << "\tRing (SPSC):\t\t\t" << time/1000000 << "ms\t(" << bytes/time << " GB/s)\n";
+    }
+}
+
+TEST(Stats, Overhead_NTimes)
+{
+    const std::size_t live = 500;
+    const unsigned int seed = 42;
+
+    const std::array<std::size_t, 2> sizeN = {10000, 50000};
+
+    std::array<std::uint8_t, 65536> arr1;
+    FirstFitMemoryAllocator ffma(arr1);
+    BasicFirstFitMemoryAllocator<AllocatorStats> ffma_stats(arr1);
+
+    std::array<std::uint8_t, 65536> arr2;
+    NextFitMemoryAllocator nfma(arr2);
+    BasicNextFitMemoryAllocator<AllocatorStats> nfma_stats(arr2);
+
+    std::array<std::uint8_t, 65536> arr3;
+    PoolAllocationMemoryAllocator<8> pama(arr3);
+    PoolAllocationMemoryAllocator<8, AllocatorStats> pama_stats(arr3);
+
+    std::array<std::uint8_t, 65536> arr4;
+    BuddySystemMemoryAllocator<8> bsma(arr4);
+    BuddySystemMemoryAllocator<8, AllocatorStats> bsma_stats(arr4);
+
+    std::array<std::uint8_t, 65536> arr5;
+    SlabMemoryAllocator<8192> sma(arr5);
+    SlabMemoryAllocator<8192, AllocatorStats> sma_stats(arr5);
+
+    const std::array<std::string, 5> rows = {ROWS[0], ROWS[1], ROWS[2], ROWS[3], "Slab:\t\t\t\t"};
+
+    std::cout << "\t\t\t\tNo stats\tStats\t\tNodes visited\tSplits/merges\tPeak\n";
+    for (std::size_t n=0; n<sizeN.size(); n++)
+    {
+        std::cout << "N=" << sizeN[n] << "\n";
+        for (std::size_t m=0; m<rows.size(); m++)
+        {
+            std::size_t failed = 0;
+            double time = 0;
+            double time_stats = 0;
+            AllocatorStats stats;
+
+            // Both allocators share a memory buffer, so each is reset before the other runs.
+            switch (m)
+            {
+                case 0:
+                    ffma.reset();
+                    time = mixed_sizes_time(ffma, seed, live, sizeN[n], failed);
+                    ffma_stats.reset();
+                    time_stats = mixed_sizes_time(ffma_stats, seed, live, sizeN[n], failed);
+                    stats = ffma_stats.stats();
+                    break;
+                case 1:
+                    nfma.reset();
+                    time = mixed_sizes_time(nfma, seed, live, sizeN[n], failed);
+                    nfma_stats.reset();
+                    time_stats = mixed_sizes_time(nfma_stats, seed, live, sizeN[n], failed);
+                    stats = nfma_stats.stats();
+                    break;
+                case 2:
+                    pama.reset();
+                    time = mixed_sizes_time(pama, seed, live, sizeN[n], failed);
+                    pama_stats.reset();
+                    time_stats = mixed_sizes_time(pama_stats, seed, live, sizeN[n], failed);
+                    stats = pama_stats.stats();
+                    break;
+                case 3:
+                    bsma.reset();
+                    time = mixed_sizes_time(bsma, seed, live, sizeN[n], failed);
+                    bsma_stats.reset();
+                    time_stats = mixed_sizes_time(bsma_stats, seed, live, sizeN[n], failed);
+                    stats = bsma_stats.stats();
+                    break;
+                case 4:
+                    sma.reset();
+                    time = mixed_sizes_time(sma, seed, live, sizeN[n], failed);
+                    sma_stats.reset();
+                    time_stats = mixed_sizes_time(sma_stats, seed, live, sizeN[n], failed);
+                    stats = sma_stats.stats();
+                    break;
+            }
+
+            std::cout << "\t" << rows[m] << time/1000000 << "ms\t" << time_stats/1000000 << "ms\t"
+                << stats.nodes_visited() << "\t\t" << stats.splits() << "/" << stats.merges() << "\t\t" << stats.peak_bytes() << "B\n";
+        }
+    }
+}
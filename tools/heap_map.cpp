@@ -0,0 +1,99 @@
+// Renders each snapshot in a heap snapshot file, written by HeapSnapshotWriter in either format, as a
+//  heat strip image of where the memory buffer is free, allocated and fragmented.
+//
+// Usage:
+//  heap_map <snapshots> <output prefix> [--svg] [--width n] [--height n]
+//
+// Snapshot i is written to <output prefix>_<i>.ppm, or .svg with --svg.
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Trace/heap_snapshot.h"
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <snapshots> <output prefix> [--svg] [--width n] [--height n]\n";
+        return 1;
+    }
+
+    const std::string input = argv[1];
+    const std::string prefix = argv[2];
+    bool svg = false;
+    std::size_t width = 512;
+    std::size_t height = 32;
+
+    for (int a=3; a<argc; a++)
+    {
+        const std::string arg = argv[a];
+        const bool has_value = a + 1 < argc;
+
+        if (arg == "--svg")
+        {
+            svg = true;
+        }
+        else if (arg == "--width" && has_value)
+        {
+            width = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else if (arg == "--height" && has_value)
+        {
+            height = std::strtoull(argv[++a], nullptr, 10);
+        }
+        else
+        {
+            std::cerr << "Unknown argument " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<HeapSnapshot> snapshots;
+    if (!HeapSnapshotWriter::read(input, snapshots))
+    {
+        std::cerr << "Could not read snapshots from " << input << "\n";
+        return 1;
+    }
+
+    const HeapMapRenderer renderer(width, height);
+
+    for (std::size_t i=0; i<snapshots.size(); i++)
+    {
+        std::ostringstream path;
+        path << prefix << "_" << std::setw(4) << std::setfill('0') << i << (svg ? ".svg" : ".ppm");
+
+        std::ofstream file(path.str(), std::ios::binary | std::ios::trunc);
+        if (svg)
+        {
+            renderer.render_svg(snapshots[i], file);
+        }
+        else
+        {
+            renderer.render_ppm(snapshots[i], file);
+        }
+
+        if (!file)
+        {
+            std::cerr << "Could not write " << path.str() << "\n";
+            return 1;
+        }
+
+        std::size_t free_blocks = 0;
+        for (const SnapshotBlock& block : snapshots[i].blocks)
+        {
+            free_blocks += block.free ? 1 : 0;
+        }
+
+        std::cout << path.str() << "\t" << snapshots[i].label << "\t" << snapshots[i].blocks.size() << " blocks, ";
+        std::cout << free_blocks << " free\n";
+    }
+
+    return 0;
+}
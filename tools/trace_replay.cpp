@@ -0,0 +1,158 @@
+// Replays an allocation trace against each memory allocator and reports it's throughput, latency,
+//  peak bytes allocated, failures and fragmentation over time.
+//
+// Usage:
+//  trace_replay <trace> [buffer bytes] [sample interval]
+//  trace_replay --generate <trace> <events> [seed]
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "allocator_stats.h"
+#include "memory_region.h"
+#include "FirstFit/first_fit_memory_allocator.h"
+#include "NextFit/next_fit_memory_allocator.h"
+#include "BuddySystem/buddy_system_memory_allocator.h"
+#include "Slab/slab_memory_allocator.h"
+#include "Trace/allocation_trace.h"
+#include "Trace/trace_recorder.h"
+#include "Trace/trace_replay.h"
+
+// Record a synthetic trace of 'count' events, mixing allocations of 8 to 1024 bytes with
+//  deallocations and reallocations of random live blocks, against a large FirstFit allocator.
+std::vector<TraceEvent> generate(std::size_t count, unsigned int seed)
+{
+    std::vector<std::uint8_t> buffer(64 * 1024 * 1024);
+    MemoryRegion region(buffer.data(), buffer.size());
+    TraceRecorder<FirstFitMemoryAllocator> recorder(region);
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> size(8, 1024);
+    std::vector<void*> live;
+
+    while (recorder.events().size() < count)
+    {
+        const unsigned int op = rng() % 8;
+        if (live.empty() || op < 4)
+        {
+            void* addr = recorder.allocate(size(rng));
+            if (addr != nullptr)
+            {
+                live.push_back(addr);
+            }
+        }
+        else
+        {
+            const std::size_t i = rng() % live.size();
+            if (op == 7)
+            {
+                void* addr = recorder.reallocate(live[i], size(rng));
+                if (addr != nullptr)
+                {
+                    live[i] = addr;
+                }
+            }
+            else
+            {
+                recorder.deallocate(live[i]);
+                live[i] = live.back();
+                live.pop_back();
+            }
+        }
+    }
+
+    return recorder.events();
+}
+
+// Replay 'events' against 'alloc' and print the results on one row.
+template <class Alloc>
+ReplayResult run(const std::string& name, Alloc& alloc, const std::vector<TraceEvent>& events, std::size_t sample_interval)
+{
+    ReplayResult result = TraceReplay::replay(alloc, events, sample_interval);
+
+    std::cout << name << static_cast<std::size_t>(result.throughput()) << "\t\t";
+    std::cout << result.latency_percentile(0.5) << "\t" << result.latency_percentile(0.99) << "\t";
+    std::cout << result.latency_percentile(0.999) << "\t" << result.latencies.back() << "\t";
+    std::cout << result.peak_allocated << "\t\t" << result.failures.size() << "\t\t";
+    if (result.failures.empty())
+    {
+        std::cout << "-\n";
+    }
+    else
+    {
+        std::cout << result.failures.front() << "\n";
+    }
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc >= 4 && std::string(argv[1]) == "--generate")
+    {
+        const std::size_t count = std::strtoull(argv[3], nullptr, 10);
+        const unsigned int seed = (argc >= 5) ? std::strtoul(argv[4], nullptr, 10) : 1;
+
+        if (!AllocationTrace::write(argv[2], generate(count, seed)))
+        {
+            std::cerr << "Could not write " << argv[2] << "\n";
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <trace> [buffer bytes] [sample interval]\n";
+        std::cerr << "       " << argv[0] << " --generate <trace> <events> [seed]\n";
+        return 1;
+    }
+
+    std::vector<TraceEvent> events;
+    if (!AllocationTrace::read(argv[1], events) || events.empty())
+    {
+        std::cerr << "Could not read " << argv[1] << "\n";
+        return 1;
+    }
+
+    const std::size_t buffer_bytes = (argc >= 3) ? std::strtoull(argv[2], nullptr, 10) : 16 * 1024 * 1024;
+    const std::size_t sample_interval = (argc >= 4) ? std::strtoull(argv[3], nullptr, 10) : events.size() / 10 + 1;
+
+    // Every allocator shares the buffer, as each is reset before it's replay.
+    std::vector<std::uint8_t> buffer(buffer_bytes);
+    MemoryRegion region(buffer.data(), buffer.size());
+
+    BasicFirstFitMemoryAllocator<AllocatorStats> ffma(region);
+    BasicNextFitMemoryAllocator<AllocatorStats> nfma(region);
+    BuddySystemMemoryAllocator<128, AllocatorStats> bsma(region);
+    SlabMemoryAllocator<16384, AllocatorStats> sma(region);
+
+    std::cout << events.size() << " events, " << buffer_bytes << "B buffer\n";
+    std::cout << "\t\tEvents/s\tp50\tp99\tp99.9\tmax(ns)\tPeak bytes\tFailures\tFirst failure\n";
+
+    std::vector<ReplayResult> results;
+    results.push_back(run("FirstFit:\t", ffma, events, sample_interval));
+    results.push_back(run("NextFit:\t", nfma, events, sample_interval));
+    results.push_back(run("BuddySystem:\t", bsma, events, sample_interval));
+    results.push_back(run("Slab:\t\t", sma, events, sample_interval));
+
+    std::cout << "\nAllocated bytes (external fragmentation) over time\n";
+    std::cout << "Event\t\tFirstFit\t\tNextFit\t\t\tBuddySystem\t\tSlab\n";
+    for (std::size_t s=0; s<results[0].samples.size(); s++)
+    {
+        std::cout << results[0].samples[s].event + 1 << "\t\t";
+        for (const ReplayResult& result : results)
+        {
+            std::cout << result.samples[s].allocated << " (" << result.samples[s].fragmentation << ")\t";
+        }
+        std::cout << "\n";
+    }
+
+    return 0;
+}